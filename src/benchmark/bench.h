@@ -0,0 +1,52 @@
+#ifndef BENCH_H
+#define BENCH_H
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace bench {
+
+template <typename F>
+double seconds(F &&f) {
+  auto start = std::chrono::steady_clock::now();
+  f();
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  return elapsed.count();
+}
+
+inline void report(const char *name, size_t ops, double sec) {
+  std::printf("%-48s %10zu ops %9.4f s %9.2f Mops/s\n", name, ops, sec,
+              ops / sec / 1e6);
+}
+
+inline std::vector<int> random_ints(size_t n, unsigned seed = 42) {
+  std::mt19937 gen(seed);
+  std::vector<int> res(n);
+  for (auto &x : res) x = static_cast<int>(gen());
+  return res;
+}
+
+inline std::vector<std::string> random_strings(size_t n, size_t len,
+                                               unsigned seed = 42) {
+  std::mt19937 gen(seed);
+  std::uniform_int_distribution<int> letter('a', 'z');
+  std::vector<std::string> res(n);
+  for (auto &s : res) {
+    s.resize(len);
+    for (auto &c : s) c = static_cast<char>(letter(gen));
+  }
+  return res;
+}
+
+// Keeps the optimizer from dropping a computed value.
+template <typename T>
+void keep(const T &value) {
+  asm volatile("" : : "g"(&value) : "memory");
+}
+
+}  // namespace bench
+
+#endif  // BENCH_H
@@ -0,0 +1,44 @@
+#include <cstdlib>
+#include <string>
+
+#include "../btree_map/btree_map.h"
+#include "../map/map.h"
+#include "bench.h"
+
+// Lookup, insert and in-order scan of btree_map against s21::map for
+// growing sizes. The largest size defaults to 1M keys, pass it as the
+// first argument to go further (100M needs about 10 GB).
+template <typename Map>
+void run(const char *name, const std::vector<int> &keys) {
+  const size_t n = keys.size();
+  std::string label = std::string(name) + " n=" + std::to_string(n);
+  Map m;
+  double sec = bench::seconds([&] {
+    for (size_t i = 0; i < n; ++i) m.insert(keys[i], keys[i]);
+  });
+  bench::report((label + " insert").c_str(), n, sec);
+
+  sec = bench::seconds([&] {
+    long sum = 0;
+    for (size_t i = 0; i < n; ++i) sum += m.at(keys[(i * 7919) % n]);
+    bench::keep(sum);
+  });
+  bench::report((label + " lookup").c_str(), n, sec);
+
+  sec = bench::seconds([&] {
+    long sum = 0;
+    for (auto it = m.begin(); it != m.end(); ++it) sum += (*it).second;
+    bench::keep(sum);
+  });
+  bench::report((label + " scan").c_str(), n, sec);
+}
+
+int main(int argc, char **argv) {
+  size_t max = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+  for (size_t n = 1000; n <= max; n *= 10) {
+    std::vector<int> keys = bench::random_ints(n);
+    run<s21::btree_map<int, int>>("s21::btree_map<int, int>", keys);
+    run<s21::map<int, int>>("s21::map<int, int>", keys);
+  }
+  return 0;
+}
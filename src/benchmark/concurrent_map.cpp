@@ -0,0 +1,90 @@
+#include <algorithm>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../concurrent_map/concurrent_map.h"
+#include "../map/map.h"
+#include "bench.h"
+
+// s21::map behind one lock, the way it is shared today.
+template <typename Mutex, typename ReadLock>
+struct locked_map {
+  bool find(int key, int &value) {
+    ReadLock guard(lock);
+    auto it = m.find(key);
+    if (it == m.end()) return false;
+    value = (*it).second;
+    return true;
+  }
+  bool insert(int key, int value) {
+    std::lock_guard<Mutex> guard(lock);
+    return m.insert(key, value).second;
+  }
+  bool erase(int key) {
+    std::lock_guard<Mutex> guard(lock);
+    auto it = m.find(key);
+    if (it == m.end()) return false;
+    m.erase(it);
+    return true;
+  }
+  s21::map<int, int> m;
+  Mutex lock;
+};
+using mutex_map = locked_map<std::mutex, std::lock_guard<std::mutex>>;
+using shared_map =
+    locked_map<std::shared_mutex, std::shared_lock<std::shared_mutex>>;
+
+// 95% lookups, the rest split between inserts and erases.
+template <typename Map>
+void run(const std::string &name, Map &m, const std::vector<int> &keys,
+         size_t threads, size_t ops) {
+  std::vector<std::thread> workers;
+  double sec = bench::seconds([&] {
+    for (size_t t = 0; t < threads; ++t) {
+      workers.emplace_back([&, t] {
+        std::mt19937 gen(static_cast<unsigned>(t));
+        long sum = 0;
+        for (size_t i = 0; i < ops; ++i) {
+          int key = keys[gen() % keys.size()];
+          unsigned dice = gen() % 100;
+          int value = 0;
+          if (dice < 95) {
+            if (m.find(key, value)) sum += value;
+          } else if (dice < 98) {
+            m.insert(key, key);
+          } else {
+            m.erase(key);
+          }
+        }
+        bench::keep(sum);
+      });
+    }
+    for (auto &worker : workers) worker.join();
+  });
+  std::string suffix = ", " + std::to_string(threads) + " threads";
+  bench::report((name + suffix).c_str(), threads * ops, sec);
+}
+
+int main() {
+  const size_t n = 1000000;
+  const size_t ops = 1000000;
+  std::vector<int> keys = bench::random_ints(n);
+  size_t cores = std::max(4u, std::thread::hardware_concurrency());
+  for (size_t threads = 1; threads <= cores; threads *= 2) {
+    s21::concurrent_map<int, int> cm;
+    mutex_map mm;
+    shared_map sm;
+    for (int key : keys) {
+      cm.insert(key, key);
+      mm.m.insert(key, key);
+      sm.m.insert(key, key);
+    }
+    run("s21::concurrent_map 95/5", cm, keys, threads, ops);
+    run("s21::map + std::mutex 95/5", mm, keys, threads, ops);
+    run("s21::map + std::shared_mutex 95/5", sm, keys, threads, ops);
+  }
+  return 0;
+}
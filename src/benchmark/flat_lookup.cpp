@@ -0,0 +1,60 @@
+#include <algorithm>
+
+#include "../flat_map/flat_map.h"
+#include "../flat_set/flat_set.h"
+#include "../map/map.h"
+#include "bench.h"
+
+// Read-mostly table: one bulk load, then many lookups.
+int main() {
+  const size_t n = 1000000;
+  std::vector<int> keys = bench::random_ints(n);
+  std::vector<std::pair<int, int>> items;
+  for (int key : keys) items.emplace_back(key, key);
+
+  s21::flat_map<int, int> flat;
+  double sec = bench::seconds(
+      [&] { flat.insert_range(items.begin(), items.end()); });
+  bench::report("s21::flat_map<int, int> insert_range", n, sec);
+
+  s21::map<int, int> tree;
+  sec = bench::seconds([&] {
+    for (const auto &item : items) tree.insert(item);
+  });
+  bench::report("s21::map<int, int> insert", n, sec);
+
+  sec = bench::seconds([&] {
+    long sum = 0;
+    for (size_t i = 0; i < n; ++i) sum += flat.at(keys[(i * 7919) % n]);
+    bench::keep(sum);
+  });
+  bench::report("s21::flat_map<int, int> lookup", n, sec);
+
+  sec = bench::seconds([&] {
+    long sum = 0;
+    for (size_t i = 0; i < n; ++i) sum += tree.at(keys[(i * 7919) % n]);
+    bench::keep(sum);
+  });
+  bench::report("s21::map<int, int> lookup", n, sec);
+
+  s21::flat_set<int> set(keys.begin(), keys.end());
+  std::vector<int> sorted(set.begin(), set.end());
+  sec = bench::seconds([&] {
+    long sum = 0;
+    for (size_t i = 0; i < n; ++i)
+      sum += set.lower_bound(keys[(i * 7919) % n]) - set.begin();
+    bench::keep(sum);
+  });
+  bench::report("s21::flat_set<int> lower_bound", n, sec);
+
+  sec = bench::seconds([&] {
+    long sum = 0;
+    for (size_t i = 0; i < n; ++i)
+      sum += std::lower_bound(sorted.begin(), sorted.end(),
+                              keys[(i * 7919) % n]) -
+             sorted.begin();
+    bench::keep(sum);
+  });
+  bench::report("std::lower_bound on std::vector<int>", n, sec);
+  return 0;
+}
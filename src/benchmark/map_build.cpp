@@ -0,0 +1,32 @@
+#include <algorithm>
+#include <map>
+#include <utility>
+
+#include "../map/map.h"
+#include "bench.h"
+
+int main() {
+  const size_t n = 2000000;
+  std::vector<std::pair<int, int>> items(n);
+  for (size_t i = 0; i < n; ++i) items[i] = {static_cast<int>(i), 1};
+
+  double sec = bench::seconds([&] {
+    s21::map<int, int> m(items.begin(), items.end());
+    bench::keep(m.size());
+  });
+  bench::report("s21::map<int, int> range ctor, sorted", n, sec);
+
+  sec = bench::seconds([&] {
+    s21::map<int, int> m;
+    for (auto &item : items) m.insert(item);
+    bench::keep(m.size());
+  });
+  bench::report("s21::map<int, int> insert loop, sorted", n, sec);
+
+  sec = bench::seconds([&] {
+    std::map<int, int> m(items.begin(), items.end());
+    bench::keep(m.size());
+  });
+  bench::report("std::map<int, int> range ctor, sorted", n, sec);
+  return 0;
+}
@@ -0,0 +1,31 @@
+#include <map>
+#include <memory>
+
+#include "../map/map.h"
+#include "bench.h"
+
+int main() {
+  const size_t n = 4000000;
+  std::vector<int> keys = bench::random_ints(n);
+  s21::map<int, int> m;
+  std::map<int, int> sm;
+  for (int key : keys) {
+    m.insert(key, key);
+    sm.emplace(key, key);
+  }
+
+  std::unique_ptr<s21::map<int, int>> copy;
+  double sec = bench::seconds(
+      [&] { copy = std::make_unique<s21::map<int, int>>(m); });
+  bench::report("s21::map<int, int> copy ctor", m.size(), sec);
+  sec = bench::seconds([&] { copy.reset(); });
+  bench::report("s21::map<int, int> destroy", m.size(), sec);
+
+  std::unique_ptr<std::map<int, int>> std_copy;
+  sec = bench::seconds(
+      [&] { std_copy = std::make_unique<std::map<int, int>>(sm); });
+  bench::report("std::map<int, int> copy ctor", sm.size(), sec);
+  sec = bench::seconds([&] { std_copy.reset(); });
+  bench::report("std::map<int, int> destroy", sm.size(), sec);
+  return 0;
+}
@@ -0,0 +1,50 @@
+#include <map>
+#include <string>
+#include <vector>
+
+#include "../map/map.h"
+#include "bench.h"
+
+// Event counts per key: most updates hit a key that is already there.
+int main() {
+  const size_t n = 2000000;
+  std::vector<std::string> names = bench::random_strings(100000, 16);
+  std::vector<int> picks = bench::random_ints(n);
+  std::vector<const std::string *> events(n);
+  for (size_t i = 0; i < n; ++i)
+    events[i] = &names[static_cast<unsigned>(picks[i]) % names.size()];
+
+  double sec = bench::seconds([&] {
+    s21::map<std::string, long> m;
+    for (const std::string *key : events) {
+      auto it = m.find(*key);
+      if (it == m.end()) it = m.insert(*key, 0).first;
+      ++(*it).second;
+    }
+    bench::keep(m.size());
+  });
+  bench::report("s21::map find + insert", n, sec);
+
+  sec = bench::seconds([&] {
+    s21::map<std::string, long> m;
+    for (const std::string *key : events) ++m[*key];
+    bench::keep(m.size());
+  });
+  bench::report("s21::map operator[]", n, sec);
+
+  sec = bench::seconds([&] {
+    s21::map<std::string, long> m;
+    for (const std::string *key : events)
+      ++(*m.try_emplace(*key, 0).first).second;
+    bench::keep(m.size());
+  });
+  bench::report("s21::map try_emplace", n, sec);
+
+  sec = bench::seconds([&] {
+    std::map<std::string, long> m;
+    for (const std::string *key : events) ++m[*key];
+    bench::keep(m.size());
+  });
+  bench::report("std::map operator[]", n, sec);
+  return 0;
+}
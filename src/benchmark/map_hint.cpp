@@ -0,0 +1,69 @@
+#include <algorithm>
+#include <cstdio>
+#include <map>
+#include <random>
+#include <string>
+
+#include "../map/map.h"
+#include "bench.h"
+
+// Log streams arrive sorted or with small local disorder. The hint is the
+// element inserted last.
+template <typename Map, typename Key, typename Insert>
+void run(const char *name, const std::vector<Key> &keys, Insert insert) {
+  double sec = bench::seconds([&] {
+    Map m;
+    auto hint = m.end();
+    for (const Key &key : keys) hint = insert(m, hint, key);
+    bench::keep(m.size());
+  });
+  bench::report(name, keys.size(), sec);
+}
+
+int main() {
+  const size_t n = 2000000;
+  std::vector<int> sorted(n);
+  for (size_t i = 0; i < n; ++i) sorted[i] = static_cast<int>(i);
+  std::vector<int> nearly = sorted;
+  std::mt19937 gen(42);
+  for (size_t i = 0; i + 8 <= n; i += 8)
+    std::shuffle(nearly.begin() + i, nearly.begin() + i + 8, gen);
+
+  using map = s21::map<int, int>;
+  auto plain = [](map &m, map::iterator, int key) {
+    return m.insert(key, key).first;
+  };
+  auto hinted = [](map &m, map::iterator hint, int key) {
+    return m.insert(hint, {key, key});
+  };
+  auto std_hinted = [](std::map<int, int> &m, std::map<int, int>::iterator hint,
+                       int key) { return m.emplace_hint(hint, key, key); };
+
+  run<map>("s21::map insert, sorted", sorted, plain);
+  run<map>("s21::map insert(hint), sorted", sorted, hinted);
+  run<std::map<int, int>>("std::map emplace_hint, sorted", sorted, std_hinted);
+  run<map>("s21::map insert, nearly sorted", nearly, plain);
+  run<map>("s21::map insert(hint), nearly sorted", nearly, hinted);
+  run<std::map<int, int>>("std::map emplace_hint, nearly sorted", nearly,
+                          std_hinted);
+
+  // Timestamps share long prefixes, so every comparison is expensive.
+  std::vector<std::string> stamps(n / 4);
+  for (size_t i = 0; i < stamps.size(); ++i) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "2026-10-17T%02zu:%02zu:%02zu.%06zu",
+                  i / 3600000 % 24, i / 60000 % 60, i / 1000 % 60, i % 1000);
+    stamps[i] = buf;
+  }
+  using log_map = s21::map<std::string, int>;
+  run<log_map>("s21::map<string> insert, sorted", stamps,
+               [](log_map &m, log_map::iterator, const std::string &key) {
+                 return m.insert(key, 0).first;
+               });
+  run<log_map>(
+      "s21::map<string> insert(hint), sorted", stamps,
+      [](log_map &m, log_map::iterator hint, const std::string &key) {
+        return m.insert(hint, {key, 0});
+      });
+  return 0;
+}
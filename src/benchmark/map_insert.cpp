@@ -0,0 +1,26 @@
+#include <map>
+#include <string>
+
+#include "../map/map.h"
+#include "bench.h"
+
+int main() {
+  const size_t n = 200000;
+  std::vector<std::string> keys = bench::random_strings(n, 24);
+  std::vector<std::string> values = bench::random_strings(n, 48, 7);
+
+  double sec = bench::seconds([&] {
+    s21::map<std::string, std::string> m;
+    for (size_t i = 0; i < n; ++i) m.insert(keys[i], values[i]);
+    bench::keep(m.size());
+  });
+  bench::report("s21::map<string, string> insert", n, sec);
+
+  sec = bench::seconds([&] {
+    std::map<std::string, std::string> m;
+    for (size_t i = 0; i < n; ++i) m.emplace(keys[i], values[i]);
+    bench::keep(m.size());
+  });
+  bench::report("std::map<string, string> insert", n, sec);
+  return 0;
+}
@@ -0,0 +1,54 @@
+#include <map>
+#include <string>
+#include <vector>
+
+#include "../map/map.h"
+#include "bench.h"
+
+// Orders move between price levels: an entry is rekeyed, its payload
+// stays the same.
+int main() {
+  const size_t n = 500000;
+  const size_t moves = 500000;
+  std::vector<int> keys = bench::random_ints(n);
+  std::vector<int> to = bench::random_ints(moves, 7);
+  const std::string payload(64, 'x');
+
+  s21::map<int, std::string> m;
+  for (int key : keys) m.insert(key, payload);
+  double sec = bench::seconds([&] {
+    for (size_t i = 0; i < moves; ++i) {
+      auto it = m.begin();
+      std::string value = (*it).second;
+      m.erase(it);
+      m.insert(to[i], value);
+    }
+    bench::keep(m.size());
+  });
+  bench::report("s21::map erase + insert", moves, sec);
+
+  s21::map<int, std::string> h;
+  for (int key : keys) h.insert(key, payload);
+  sec = bench::seconds([&] {
+    for (size_t i = 0; i < moves; ++i) {
+      auto node = h.extract(h.begin());
+      node.key() = to[i];
+      h.insert(std::move(node));
+    }
+    bench::keep(h.size());
+  });
+  bench::report("s21::map extract + insert", moves, sec);
+
+  std::map<int, std::string> s;
+  for (int key : keys) s.emplace(key, payload);
+  sec = bench::seconds([&] {
+    for (size_t i = 0; i < moves; ++i) {
+      auto node = s.extract(s.begin());
+      node.key() = to[i];
+      s.insert(std::move(node));
+    }
+    bench::keep(s.size());
+  });
+  bench::report("std::map extract + insert", moves, sec);
+  return 0;
+}
@@ -0,0 +1,42 @@
+#include <array>
+#include <map>
+#include <string>
+
+#include "../map/map.h"
+#include "bench.h"
+
+struct Blob {
+  std::array<char, 256> bytes{};
+};
+
+template <typename Map>
+size_t scan(Map &m) {
+  size_t sum = 0;
+  for (auto it = m.begin(); it != m.end(); ++it)
+    sum += (*it).first.size() + (*it).second.bytes[0];
+  return sum;
+}
+
+int main() {
+  const size_t n = 200000;
+  const int rounds = 20;
+  std::vector<std::string> keys = bench::random_strings(n, 32);
+
+  s21::map<std::string, Blob> m;
+  std::map<std::string, Blob> sm;
+  for (auto &key : keys) {
+    m.insert(key, Blob());
+    sm.emplace(key, Blob());
+  }
+
+  double sec = bench::seconds([&] {
+    for (int r = 0; r < rounds; ++r) bench::keep(scan(m));
+  });
+  bench::report("s21::map<string, Blob> full scan", n * rounds, sec);
+
+  sec = bench::seconds([&] {
+    for (int r = 0; r < rounds; ++r) bench::keep(scan(sm));
+  });
+  bench::report("std::map<string, Blob> full scan", n * rounds, sec);
+  return 0;
+}
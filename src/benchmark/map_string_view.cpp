@@ -0,0 +1,37 @@
+#include <string>
+#include <string_view>
+
+#include "../map/map.h"
+#include "bench.h"
+
+// Router style lookups: the key arrives as a view into a request buffer.
+int main() {
+  const size_t n = 100000;
+  const size_t lookups = 1000000;
+  std::vector<std::string> keys = bench::random_strings(n, 40);
+  s21::map<std::string, int> m;
+  for (size_t i = 0; i < n; ++i) m.insert(keys[i], static_cast<int>(i));
+  std::string buffer;
+  for (const auto &key : keys) buffer += key;
+
+  double sec = bench::seconds([&] {
+    long sum = 0;
+    for (size_t i = 0; i < lookups; ++i) {
+      std::string_view view(buffer.data() + (i * 7919 % n) * 40, 40);
+      sum += m.at(std::string(view));
+    }
+    bench::keep(sum);
+  });
+  bench::report("s21::map<string, int> at(string(view))", lookups, sec);
+
+  sec = bench::seconds([&] {
+    long sum = 0;
+    for (size_t i = 0; i < lookups; ++i) {
+      std::string_view view(buffer.data() + (i * 7919 % n) * 40, 40);
+      sum += m.at(view);
+    }
+    bench::keep(sum);
+  });
+  bench::report("s21::map<string, int> at(view)", lookups, sec);
+  return 0;
+}
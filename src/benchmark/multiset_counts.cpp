@@ -0,0 +1,31 @@
+#include <vector>
+
+#include "../multiset/multiset.h"
+#include "bench.h"
+
+// Histogram ingestion: each key arrives with a batch of copies.
+int main() {
+  const size_t keys = 100000;
+  const size_t batch = 64;
+  std::vector<int> picks = bench::random_ints(keys);
+
+  double sec = bench::seconds([&] {
+    s21::multiset<int> s;
+    for (int key : picks)
+      for (size_t i = 0; i < batch; ++i) s.insert(key);
+    for (int key : picks)
+      for (size_t i = 0; i < batch / 2; ++i) s.erase(s.find(key));
+    bench::keep(s.size());
+  });
+  bench::report("s21::multiset copy by copy", keys * batch * 3 / 2, sec);
+
+  sec = bench::seconds([&] {
+    s21::multiset<int> s;
+    for (int key : picks) s.insert(key, batch);
+    for (int key : picks) s.erase(key, batch / 2);
+    bench::keep(s.size());
+  });
+  bench::report("s21::multiset insert/erase(key, n)", keys * batch * 3 / 2,
+                sec);
+  return 0;
+}
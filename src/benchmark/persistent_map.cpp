@@ -0,0 +1,47 @@
+#include <memory>
+#include <vector>
+
+#include "../map/map.h"
+#include "../persistent_map/persistent_map.h"
+#include "bench.h"
+
+// A background export takes a snapshot every `every` updates and keeps
+// it until the next one.
+int main() {
+  const size_t n = 1000000;
+  const size_t updates = 200000;
+  const size_t every = 10000;
+  std::vector<int> keys = bench::random_ints(n);
+  std::vector<int> more = bench::random_ints(updates, 7);
+
+  s21::map<int, int> m;
+  for (int key : keys) m.insert(key, key);
+  double sec = bench::seconds([&] {
+    std::unique_ptr<s21::map<int, int>> snapshot;
+    for (size_t i = 0; i < updates; ++i) {
+      if (i % every == 0)
+        snapshot = std::make_unique<s21::map<int, int>>(m);
+      m.insert(more[i], more[i]);
+    }
+    bench::keep(snapshot);
+  });
+  bench::report("s21::map copy per snapshot", updates, sec);
+
+  s21::persistent_map<int, int> p;
+  for (int key : keys) p.insert(key, key);
+  sec = bench::seconds([&] {
+    s21::persistent_map<int, int> snapshot;
+    for (size_t i = 0; i < updates; ++i) {
+      if (i % every == 0) snapshot = p.snapshot();
+      p.insert(more[i], more[i]);
+    }
+    bench::keep(snapshot);
+  });
+  bench::report("s21::persistent_map snapshot", updates, sec);
+
+  sec = bench::seconds([&] {
+    for (size_t i = 0; i < updates; ++i) p.insert_or_assign(more[i], 0);
+  });
+  bench::report("s21::persistent_map unshared updates", updates, sec);
+  return 0;
+}
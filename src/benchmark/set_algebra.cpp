@@ -0,0 +1,54 @@
+#include <algorithm>
+#include <iterator>
+#include <set>
+#include <vector>
+
+#include "../set/set.h"
+#include "bench.h"
+
+int main() {
+  const int n = 2000000;
+  const int m = 1000;
+  const int rounds = 1000;
+  std::vector<int> big(n);
+  for (int i = 0; i < n; ++i) big[i] = 2 * i;
+  std::vector<int> keys = bench::random_ints(m);
+  for (auto &k : keys) k = static_cast<unsigned>(k) % (2 * n);
+  std::sort(keys.begin(), keys.end());
+  keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+  s21::set<int> index(big.begin(), big.end());
+  double sec = bench::seconds([&] {
+    for (int r = 0; r < rounds; ++r) {
+      s21::set<int> filter(keys.begin(), keys.end());
+      filter.set_intersection(index);
+      bench::keep(filter.size());
+    }
+  });
+  bench::report("s21::set small.set_intersection(index)", rounds * m, sec);
+
+  sec = bench::seconds([&] {
+    for (int r = 0; r < rounds; ++r) {
+      s21::set<int> res;
+      for (auto k : keys)
+        if (index.contains(k)) res.insert(k);
+      bench::keep(res.size());
+    }
+  });
+  bench::report("s21::set small filter, contains loop", rounds * m, sec);
+
+  // Linear in the index, so far fewer rounds.
+  std::set<int> std_index(big.begin(), big.end());
+  sec = bench::seconds([&] {
+    for (int r = 0; r < rounds / 100; ++r) {
+      std::set<int> filter(keys.begin(), keys.end());
+      std::vector<int> res;
+      std::set_intersection(filter.begin(), filter.end(), std_index.begin(),
+                            std_index.end(), std::back_inserter(res));
+      bench::keep(res.size());
+    }
+  });
+  bench::report("std::set_intersection(small, index)", rounds / 100 * m,
+                sec);
+  return 0;
+}
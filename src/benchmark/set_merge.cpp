@@ -0,0 +1,25 @@
+#include <set>
+
+#include "../set/set.h"
+#include "bench.h"
+
+template <typename Set>
+void run(const char *name, int n, int stride) {
+  Set a, b;
+  for (int i = 0; i < n; ++i) a.insert(i * stride);
+  for (int i = 0; i < n; ++i) b.insert(i * stride + 1 + (stride == 1) * n);
+  double sec = bench::seconds([&] {
+    a.merge(b);
+    bench::keep(a.size());
+  });
+  bench::report(name, 2 * n, sec);
+}
+
+int main() {
+  const int n = 1000000;
+  run<s21::set<int>>("s21::set<int> merge, interleaved", n, 2);
+  run<std::set<int>>("std::set<int> merge, interleaved", n, 2);
+  run<s21::set<int>>("s21::set<int> merge, disjoint", n, 1);
+  run<std::set<int>>("std::set<int> merge, disjoint", n, 1);
+  return 0;
+}
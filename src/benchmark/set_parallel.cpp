@@ -0,0 +1,32 @@
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../set/set.h"
+#include "bench.h"
+
+int main() {
+  const size_t n = 2000000;
+  std::vector<int> a = bench::random_ints(n, 1);
+  std::vector<int> b = bench::random_ints(n, 2);
+  for (size_t i = 0; i < n / 2; ++i) b[i] = a[i];
+  std::sort(a.begin(), a.end());
+  std::sort(b.begin(), b.end());
+  s21::set<int> sa(a.begin(), a.end());
+  s21::set<int> sb(b.begin(), b.end());
+
+  size_t cores = std::max(4u, std::thread::hardware_concurrency());
+  for (size_t threads = 1; threads <= cores; threads *= 2) {
+    std::string suffix = ", " + std::to_string(threads) + " threads";
+    s21::set<int> u(sa), i(sa), d(sa);
+    double sec = bench::seconds([&] { u.set_union(sb, threads); });
+    bench::report(("s21::set set_union" + suffix).c_str(), 2 * n, sec);
+    sec = bench::seconds([&] { i.set_intersection(sb, threads); });
+    bench::report(("s21::set set_intersection" + suffix).c_str(), 2 * n, sec);
+    sec = bench::seconds([&] { d.set_difference(sb, threads); });
+    bench::report(("s21::set set_difference" + suffix).c_str(), 2 * n, sec);
+    bench::keep(u.size() + i.size() + d.size());
+  }
+  return 0;
+}
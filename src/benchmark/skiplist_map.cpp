@@ -0,0 +1,81 @@
+#include <algorithm>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../map/map.h"
+#include "../skiplist_map/skiplist_map.h"
+#include "bench.h"
+
+// s21::map behind one mutex, the way it is shared today.
+struct mutex_map {
+  bool insert(int key, int value) {
+    std::lock_guard<std::mutex> guard(lock);
+    return m.insert(key, value).second;
+  }
+  bool erase(int key) {
+    std::lock_guard<std::mutex> guard(lock);
+    auto it = m.find(key);
+    if (it == m.end()) return false;
+    m.erase(it);
+    return true;
+  }
+  bool contains(int key) {
+    std::lock_guard<std::mutex> guard(lock);
+    return m.contains(key);
+  }
+  s21::map<int, int> m;
+  std::mutex lock;
+};
+
+struct skip_map {
+  bool insert(int key, int value) { return m.insert(key, value).second; }
+  bool erase(int key) { return m.erase(key) == 1; }
+  bool contains(int key) { return m.contains(key); }
+  s21::skiplist_map<int, int> m;
+};
+
+// Every thread inserts its own share of the keys, then half of the
+// threads erase while the other half look keys up.
+template <typename Map>
+void run(const std::string &name, const std::vector<int> &keys,
+         size_t threads) {
+  Map m;
+  std::string suffix = ", " + std::to_string(threads) + " threads";
+  size_t share = keys.size() / threads;
+  auto parallel = [&](auto op) {
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < threads; ++t)
+      workers.emplace_back([&, t] { op(t); });
+    for (auto &worker : workers) worker.join();
+  };
+  double sec = bench::seconds([&] {
+    parallel([&](size_t t) {
+      for (size_t i = t * share; i < (t + 1) * share; ++i)
+        m.insert(keys[i], keys[i]);
+    });
+  });
+  bench::report((name + " insert" + suffix).c_str(), share * threads, sec);
+  sec = bench::seconds([&] {
+    parallel([&](size_t t) {
+      size_t found = 0;
+      for (size_t i = t * share; i < (t + 1) * share; ++i)
+        found += t % 2 ? m.contains(keys[i]) : m.erase(keys[i]);
+      bench::keep(found);
+    });
+  });
+  bench::report((name + " erase/lookup" + suffix).c_str(), share * threads,
+                sec);
+}
+
+int main() {
+  const size_t n = 1000000;
+  std::vector<int> keys = bench::random_ints(n);
+  size_t cores = std::max(4u, std::thread::hardware_concurrency());
+  for (size_t threads = 1; threads <= cores; threads *= 2) {
+    run<skip_map>("s21::skiplist_map", keys, threads);
+    run<mutex_map>("s21::map + std::mutex", keys, threads);
+  }
+  return 0;
+}
@@ -0,0 +1,59 @@
+#include <string>
+#include <unordered_map>
+
+#include "../map/map.h"
+#include "../unordered_map/unordered_map.h"
+#include "bench.h"
+
+template <typename Map, typename Key>
+void run(const char *name, const std::vector<Key> &keys,
+         const std::vector<Key> &misses) {
+  const size_t n = keys.size();
+  std::string label(name);
+  Map m;
+  double sec = bench::seconds([&] {
+    for (size_t i = 0; i < n; ++i) m[keys[i]] = static_cast<int>(i);
+  });
+  bench::report((label + " insert").c_str(), n, sec);
+
+  sec = bench::seconds([&] {
+    long sum = 0;
+    for (size_t i = 0; i < n; ++i) sum += m.at(keys[(i * 7919) % n]);
+    bench::keep(sum);
+  });
+  bench::report((label + " hit").c_str(), n, sec);
+
+  sec = bench::seconds([&] {
+    size_t found = 0;
+    for (const auto &key : misses) found += m.contains(key);
+    bench::keep(found);
+  });
+  bench::report((label + " miss").c_str(), n, sec);
+}
+
+// std::unordered_map has no contains() in C++17.
+template <typename Key>
+struct std_map : std::unordered_map<Key, int> {
+  bool contains(const Key &key) { return this->find(key) != this->end(); }
+};
+
+int main() {
+  const size_t n = 1000000;
+  std::vector<int> ints = bench::random_ints(2 * n);
+  std::vector<int> keys(ints.begin(), ints.begin() + n);
+  std::vector<int> misses(ints.begin() + n, ints.end());
+  run<s21::unordered_map<int, int>>("s21::unordered_map<int, int>", keys,
+                                    misses);
+  run<std_map<int>>("std::unordered_map<int, int>", keys, misses);
+  run<s21::map<int, int>>("s21::map<int, int>", keys, misses);
+
+  std::vector<std::string> strings = bench::random_strings(2 * n, 16);
+  std::vector<std::string> skeys(strings.begin(), strings.begin() + n);
+  std::vector<std::string> smisses(strings.begin() + n, strings.end());
+  run<s21::unordered_map<std::string, int>>(
+      "s21::unordered_map<string, int>", skeys, smisses);
+  run<std_map<std::string>>("std::unordered_map<string, int>", skeys,
+                            smisses);
+  run<s21::map<std::string, int>>("s21::map<string, int>", skeys, smisses);
+  return 0;
+}
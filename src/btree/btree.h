@@ -0,0 +1,171 @@
+#ifndef BTREE_H
+#define BTREE_H
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "../tree/compare_holder.h"
+
+// B+-tree core of btree_map, btree_set and btree_multiset. Elements (slots
+// of type T) live only in the leaves, which are linked for scans; inner
+// nodes hold separator keys. Every node takes a few cache lines. Inserting
+// or erasing moves elements between nodes and invalidates iterators.
+template <typename K, typename T, typename Compare, typename Allocator,
+          bool Multi>
+class btree : protected compare_holder<Compare> {
+ protected:
+  struct inner_node;
+  struct node_base {
+    inner_node *parent = nullptr;
+    unsigned short count = 0;
+    bool leaf = true;
+  };
+  static constexpr size_t kNodeBytes = 512;
+  static constexpr size_t kLeafSlots = std::max<size_t>(
+      4, (kNodeBytes - sizeof(node_base) - 2 * sizeof(void *)) / sizeof(T));
+  static constexpr size_t kInnerSlots = std::max<size_t>(
+      4, (kNodeBytes - sizeof(node_base) - sizeof(void *)) /
+             (sizeof(K) + sizeof(void *)));
+  static constexpr size_t kLeafMin = kLeafSlots / 2;
+  static constexpr size_t kInnerMin = (kInnerSlots - 1) / 2;
+
+  // Slots and keys are raw storage, only the first count are constructed.
+  struct leaf_node : node_base {
+    leaf_node *prev = nullptr;
+    leaf_node *next = nullptr;
+    T *slots() { return reinterpret_cast<T *>(storage); };
+    const T *slots() const { return reinterpret_cast<const T *>(storage); };
+    alignas(T) unsigned char storage[kLeafSlots * sizeof(T)];
+  };
+  // count is the number of keys, children[i] holds the elements between
+  // keys[i - 1] and keys[i].
+  struct inner_node : node_base {
+    inner_node() { this->leaf = false; };
+    K *keys() { return reinterpret_cast<K *>(storage); };
+    const K *keys() const { return reinterpret_cast<const K *>(storage); };
+    alignas(K) unsigned char storage[kInnerSlots * sizeof(K)];
+    node_base *children[kInnerSlots + 1];
+  };
+
+ public:
+  class iterator;
+  class const_iterator;
+  using key_type = K;
+  using value_type = T;
+  using reference = value_type &;
+  using const_reference = const value_type &;
+  using size_type = size_t;
+  using allocator_type = Allocator;
+  using key_compare = Compare;
+
+  btree() = default;
+  explicit btree(const Allocator &alloc) : alloc_(alloc){};
+  btree(const Compare &comp, const Allocator &alloc)
+      : compare_holder<Compare>(comp), alloc_(alloc){};
+  btree(const btree &other);
+  btree(btree &&other);
+  ~btree();
+  btree &operator=(const btree &other);
+  btree &operator=(btree &&other);
+
+  allocator_type get_allocator() const { return alloc_; };
+  key_compare key_comp() const { return this->compare_(); };
+
+  iterator begin();
+  iterator end();
+
+  bool empty();
+  size_type size();
+  size_type max_size();
+
+  void clear();
+  void erase(iterator pos);
+  void swap(btree &other);
+  void merge(btree &other);
+
+  iterator find(const K &key);
+  bool contains(const K &key);
+  size_type count(const K &key);
+  iterator lower_bound(const K &key);
+  iterator upper_bound(const K &key);
+  std::pair<iterator, iterator> equal_range(const K &key);
+
+  class iterator {
+    friend class btree;
+
+   public:
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = T *;
+    using reference = T &;
+
+    iterator() = default;
+    T &operator*() const { return leaf->slots()[pos]; };
+    T *operator->() const { return leaf->slots() + pos; };
+    iterator &operator++();
+    iterator &operator--();
+    bool operator==(const iterator &it) const;
+    bool operator!=(const iterator &it) const;
+
+   protected:
+    iterator(leaf_node *l, size_t p) : leaf(l), pos(p){};
+    leaf_node *leaf = nullptr;
+    size_t pos = 0;
+  };
+  class const_iterator : public iterator {
+   public:
+    const_iterator() = default;
+    const_iterator(const iterator &it) : iterator(it){};
+    const T &operator*() const { return iterator::operator*(); };
+    const T *operator->() const { return iterator::operator->(); };
+  };
+
+ protected:
+  static const K &key_of(const T &slot);
+  bool less_(const K &a, const K &b) const { return this->compare_()(a, b); };
+  template <bool Upper, typename Get>
+  size_t search_(size_t count, const K &key, Get get) const;
+  leaf_node *descend_(const K &key, bool upper);
+  iterator normalize_(leaf_node *leaf, size_t pos);
+
+  template <typename... Args>
+  std::pair<iterator, bool> emplace_key_(const K &key, Args &&...args);
+  static decltype(auto) take_(T &slot);
+  template <typename U, typename... Args>
+  void construct_(U *p, Args &&...args);
+  template <typename U>
+  void destroy_(U *first, U *last);
+  template <typename U>
+  void relocate_(U *first, U *last, U *dest);
+
+  template <typename Node>
+  Node *make_node_();
+  void free_node_(node_base *node);
+  void free_(node_base *node);
+  node_base *copy_(const node_base *node, inner_node *parent,
+                   leaf_node *&last);
+
+  static size_t child_index_(inner_node *parent, node_base *child);
+  leaf_node *split_leaf_(leaf_node *leaf);
+  inner_node *split_inner_(inner_node *node);
+  void insert_child_(inner_node *parent, node_base *left, K sep,
+                     node_base *right);
+  void remove_child_(inner_node *parent, size_t i);
+  void rebalance_leaf_(leaf_node *leaf);
+  void rebalance_inner_(inner_node *node);
+
+  Allocator alloc_;
+  node_base *root_ = nullptr;
+  leaf_node *leftmost_ = nullptr;
+  leaf_node *rightmost_ = nullptr;
+  size_t size_ = 0;
+};
+
+#include "btree.tpp"
+#endif  // BTREE_H
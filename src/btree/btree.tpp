@@ -0,0 +1,693 @@
+#include "btree.h"
+
+template <typename K, typename T, typename Compare, typename Allocator,
+          bool Multi>
+btree<K, T, Compare, Allocator, Multi>::btree(const btree &other)
+    : compare_holder<Compare>(other.compare_()),
+      alloc_(std::allocator_traits<Allocator>::
+                 select_on_container_copy_construction(other.alloc_)) {
+  if (!other.root_) return;
+  leaf_node *last = nullptr;
+  root_ = copy_(other.root_, nullptr, last);
+  rightmost_ = last;
+  size_ = other.size_;
+}
+
+template <typename K, typename T, typename Compare, typename Allocator,
+          bool Multi>
+btree<K, T, Compare, Allocator, Multi>::btree(btree &&other)
+    : compare_holder<Compare>(other.compare_()),
+      alloc_(other.alloc_),
+      root_(other.root_),
+      leftmost_(other.leftmost_),
+      rightmost_(other.rightmost_),
+      size_(other.size_) {
+  other.root_ = nullptr;
+  other.leftmost_ = nullptr;
+  other.rightmost_ = nullptr;
+  other.size_ = 0;
+}
+
+template <typename K, typename T, typename Compare, typename Allocator,
+          bool Multi>
+btree<K, T, Compare, Allocator, Multi>::~btree() {
+  clear();
+}
+
+template <typename K, typename T, typename Compare, typename Allocator,
+          bool Multi>
+btree<K, T, Compare, Allocator, Multi> &
+btree<K, T, Compare, Allocator, Multi>::operator=(const btree &other) {
+  if (&other == this) return *this;
+  clear();
+  this->compare_() = other.compare_();
+  if (other.root_) {
+    leaf_node *last = nullptr;
+    root_ = copy_(other.root_, nullptr, last);
+    rightmost_ = last;
+    size_ = other.size_;
+  }
+  return *this;
+}
+
+// Nodes are taken over when the allocators allow it, otherwise the
+// elements are copied.
+template <typename K, typename T, typename Compare, typename Allocator,
+          bool Multi>
+btree<K, T, Compare, Allocator, Multi> &
+btree<K, T, Compare, Allocator, Multi>::operator=(btree &&other) {
+  if (&other == this) return *this;
+  using traits = std::allocator_traits<Allocator>;
+  if (!traits::propagate_on_container_move_assignment::value &&
+      alloc_ != other.alloc_) {
+    *this = other;
+    other.clear();
+    return *this;
+  }
+  clear();
+  if constexpr (traits::propagate_on_container_move_assignment::value)
+    alloc_ = other.alloc_;
+  this->compare_() = other.compare_();
+  std::swap(root_, other.root_);
+  std::swap(leftmost_, other.leftmost_);
+  std::swap(rightmost_, other.rightmost_);
+  std::swap(size_, other.size_);
+  return *this;
+}
+
+template <typename K, typename T, typename Compare, typename Allocator,
+          bool Multi>
+const K &btree<K, T, Compare, Allocator, Multi>::key_of(const T &slot) {
+  if constexpr (std::is_same<K, T>::value)
+    return slot;
+  else
+    return slot.first;
+}
+
+// The slot as an rvalue to build another slot from. A map slot has a const
+// key, which is moved all the same, the old slot is destroyed right after.
+template <typename K, typename T, typename Compare, typename Allocator,
+          bool Multi>
+decltype(auto) btree<K, T, Compare, Allocator, Multi>::take_(T &slot) {
+  if constexpr (std::is_same<K, T>::value)
+    return std::move(slot);
+  else
+    return std::pair<K &&, typename T::second_type &&>(
+        std::move(const_cast<K &>(slot.first)), std::move(slot.second));
+}
+
+template <typename K, typename T, typename Compare, typename Allocator,
+          bool Multi>
+template <typename U, typename... Args>
+void btree<K, T, Compare, Allocator, Multi>::construct_(U *p, Args &&...args) {
+  std::allocator_traits<Allocator>::construct(alloc_, p,
+                                              std::forward<Args>(args)...);
+}
+
+template <typename K, typename T, typename Compare, typename Allocator,
+          bool Multi>
+template <typename U>
+void btree<K, T, Compare, Allocator, Multi>::destroy_(U *first, U *last) {
+  for (; first != last; ++first)
+    std::allocator_traits<Allocator>::destroy(alloc_, first);
+}
+
+// Moves [first, last) to raw storage at dest, the ranges may overlap. The
+// sources are destroyed.
+template <typename K, typename T, typename Compare, typename Allocator,
+          bool Multi>
+template <typename U>
+void btree<K, T, Compare, Allocator, Multi>::relocate_(U *first, U *last,
+                                                       U *dest) {
+  auto move_one = [this](U *from, U *to) {
+    if constexpr (std::is_same<U, T>::value)
+      construct_(to, take_(*from));
+    else
+      construct_(to, std::move(*from));
+    destroy_(from, from + 1);
+  };
+  if (std::less<U *>()(dest, first)) {
+    for (; first != last; ++first, ++dest) move_one(first, dest);
+  } else if (dest != first) {
+    dest += last - first;
+    while (last != first) move_one(--last, --dest);
+  }
+}
+
+// First index in [0, count) whose key is greater than key (Upper) or not
+// less than key, count if there is none.
+template <typename K, typename T, typename Compare, typename Allocator,
+          bool Multi>
+template <bool Upper, typename Get>
+size_t btree<K, T, Compare, Allocator, Multi>::search_(size_t count,
+                                                       const K &key,
+                                                       Get get) const {
+  size_t lo = 0;
+  size_t hi = count;
+  while (lo < hi) {
+    size_t mid = (lo + hi) / 2;
+    bool right = Upper ? !less_(key, get(mid)) : less_(get(mid), key);
+    if (right)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  return lo;
+}
+
+// Leaf that holds the lower (upper) bound of key, or whose end it is.
+template <typename K, typename T, typename Compare, typename Allocator,
+          bool Multi>
+typename btree<K, T, Compare, Allocator, Multi>::leaf_node *
+btree<K, T, Compare, Allocator, Multi>::descend_(const K &key, bool upper) {
+  node_base *node = root_;
+  while (!node->leaf) {
+    inner_node *inner = static_cast<inner_node *>(node);
+    auto get = [inner](size_t i) -> const K & { return inner->keys()[i]; };
+    size_t i = upper ? search_<true>(inner->count, key, get)
+                     : search_<false>(inner->count, key, get);
+    node = inner->children[i];
+  }
+  return static_cast<leaf_node *>(node);
+}
+
+// Moves a position past the end of a leaf to the start of the next one.
+template <typename K, typename T, typename Compare, typename Allocator,
+          bool Multi>
+typename btree<K, T, Compare, Allocator, Multi>::iterator
+btree<K, T, Compare, Allocator, Multi>::normalize_(leaf_node *leaf,
+                                                  size_t pos) {
+  if (pos == leaf->count && leaf->next) return iterator(leaf->next, 0);
+  return iterator(leaf, pos);
+}
+
+template <typename K, typename T, typename Compare, typename Allocator,
+          bool Multi>
+typename btree<K, T, Compare, Allocator, Multi>::iterator
+btree<K, T, Compare, Allocator, Multi>::begin() {
+  return iterator(leftmost_, 0);
+}
+
+template <typename K, typename T, typename Compare, typename Allocator,
+          bool Multi>
+typename btree<K, T, Compare, Allocator, Multi>::iterator
+btree<K, T, Compare, Allocator, Multi>::end() {
+  return iterator(rightmost_, rightmost_ ? rightmost_->count : 0);
+}
+
+template <typename K, typename T, typename Compare, typename Allocator,
+          bool Multi>
+bool btree<K, T, Compare, Allocator, Multi>::empty() {
+  return !size_;
+}
+
+template <typename K, typename T, typename Compare, typename Allocator,
+          bool Multi>
+size_t btree<K, T, Compare, Allocator, Multi>::size() {
+  return size_;
+}
+
+template <typename K, typename T, typename Compare, typename Allocator,
+          bool Multi>
+size_t btree<K, T, Compare, Allocator, Multi>::max_size() {
+  return std::numeric_limits<size_t>::max() / sizeof(T);
+}
+
+template <typename K, typename T, typename Compare, typename Allocator,
+          bool Multi>
+typename btree<K, T, Compare, Allocator, Multi>::iterator
+btree<K, T, Compare, Allocator, Multi>::lower_bound(const K &key) {
+  if (!root_) return end();
+  leaf_node *leaf = descend_(key, false);
+  size_t pos = search_<false>(
+      leaf->count, key,
+      [leaf](size_t i) -> const K & { return key_of(leaf->slots()[i]); });
+  return normalize_(leaf, pos);
+}
+
+template <typename K, typename T, typename Compare, typename Allocator,
+          bool Multi>
+typename btree<K, T, Compare, Allocator, Multi>::iterator
+btree<K, T, Compare, Allocator, Multi>::upper_bound(const K &key) {
+  if (!root_) return end();
+  leaf_node *leaf = descend_(key, true);
+  size_t pos = search_<true>(
+      leaf->count, key,
+      [leaf](size_t i) -> const K & { return key_of(leaf->slots()[i]); });
+  return normalize_(leaf, pos);
+}
+
+template <typename K, typename T, typename Compare, typename Allocator,
+          bool Multi>
+std::pair<typename btree<K, T, Compare, Allocator, Multi>::iterator,
+          typename btree<K, T, Compare, Allocator, Multi>::iterator>
+btree<K, T, Compare, Allocator, Multi>::equal_range(const K &key) {
+  return std::make_pair(lower_bound(key), upper_bound(key));
+}
+
+template <typename K, typename T, typename Compare, typename Allocator,
+          bool Multi>
+typename btree<K, T, Compare, Allocator, Multi>::iterator
+btree<K, T, Compare, Allocator, Multi>::find(const K &key) {
+  iterator it = lower_bound(key);
+  if (it != end() && !less_(key, key_of(*it))) return it;
+  return end();
+}
+
+template <typename K, typename T, typename Compare, typename Allocator,
+          bool Multi>
+bool btree<K, T, Compare, Allocator, Multi>::contains(const K &key) {
+  return find(key) != end();
+}
+
+template <typename K, typename T, typename Compare, typename Allocator,
+          bool Multi>
+size_t btree<K, T, Compare, Allocator, Multi>::count(const K &key) {
+  size_t res = 0;
+  for (auto it = lower_bound(key), last = upper_bound(key); it != last; ++it)
+    ++res;
+  return res;
+}
+
+// Single descent: unique trees stop at an equal key, multi trees insert
+// after the equal ones. A full leaf is split first. If the element throws
+// while being built, the shifted slots go back.
+template <typename K, typename T, typename Compare, typename Allocator,
+          bool Multi>
+template <typename... Args>
+std::pair<typename btree<K, T, Compare, Allocator, Multi>::iterator, bool>
+btree<K, T, Compare, Allocator, Multi>::emplace_key_(const K &key,
+                                                     Args &&...args) {
+  if (!root_) root_ = leftmost_ = rightmost_ = make_node_<leaf_node>();
+  leaf_node *leaf = descend_(key, Multi);
+  auto get = [&leaf](size_t i) -> const K & {
+    return key_of(leaf->slots()[i]);
+  };
+  size_t pos = Multi ? search_<true>(leaf->count, key, get)
+                     : search_<false>(leaf->count, key, get);
+  if (!Multi) {
+    iterator it = normalize_(leaf, pos);
+    if (it != end() && !less_(key, key_of(*it)))
+      return std::make_pair(it, false);
+  }
+  if (leaf->count == kLeafSlots) {
+    leaf_node *right = split_leaf_(leaf);
+    if (pos > leaf->count) {
+      pos -= leaf->count;
+      leaf = right;
+    }
+  }
+  T *slots = leaf->slots();
+  relocate_(slots + pos, slots + leaf->count, slots + pos + 1);
+  try {
+    construct_(slots + pos, std::forward<Args>(args)...);
+  } catch (...) {
+    relocate_(slots + pos + 1, slots + leaf->count + 1, slots + pos);
+    throw;
+  }
+  leaf->count++;
+  size_++;
+  return std::make_pair(iterator(leaf, pos), true);
+}
+
+// Moves the elements of other over; keys this tree already has stay in
+// other unless Multi.
+template <typename K, typename T, typename Compare, typename Allocator,
+          bool Multi>
+void btree<K, T, Compare, Allocator, Multi>::merge(btree &other) {
+  if (&other == this) return;
+  btree rest(other.compare_(), other.alloc_);
+  for (auto it = other.begin(); it != other.end(); ++it) {
+    const K &key = key_of(*it);
+    if (!emplace_key_(key, take_(*it)).second)
+      rest.emplace_key_(key, take_(*it));
+  }
+  other.clear();
+  other.swap(rest);
+}
+
+template <typename K, typename T, typename Compare, typename Allocator,
+          bool Multi>
+void btree<K, T, Compare, Allocator, Multi>::erase(iterator pos) {
+  leaf_node *leaf = pos.leaf;
+  T *slots = leaf->slots();
+  destroy_(slots + pos.pos, slots + pos.pos + 1);
+  relocate_(slots + pos.pos + 1, slots + leaf->count, slots + pos.pos);
+  leaf->count--;
+  size_--;
+  if (leaf == root_) {
+    if (!leaf->count) {
+      free_node_(leaf);
+      root_ = leftmost_ = rightmost_ = nullptr;
+    }
+  } else if (leaf->count < kLeafMin) {
+    rebalance_leaf_(leaf);
+  }
+}
+
+template <typename K, typename T, typename Compare, typename Allocator,
+          bool Multi>
+void btree<K, T, Compare, Allocator, Multi>::clear() {
+  if (root_) free_(root_);
+  root_ = nullptr;
+  leftmost_ = nullptr;
+  rightmost_ = nullptr;
+  size_ = 0;
+}
+
+template <typename K, typename T, typename Compare, typename Allocator,
+          bool Multi>
+void btree<K, T, Compare, Allocator, Multi>::swap(btree &other) {
+  std::swap(root_, other.root_);
+  std::swap(leftmost_, other.leftmost_);
+  std::swap(rightmost_, other.rightmost_);
+  std::swap(size_, other.size_);
+  std::swap(this->compare_(), other.compare_());
+  if constexpr (std::allocator_traits<
+                    Allocator>::propagate_on_container_swap::value) {
+    using std::swap;
+    swap(alloc_, other.alloc_);
+  }
+}
+
+template <typename K, typename T, typename Compare, typename Allocator,
+          bool Multi>
+template <typename Node>
+Node *btree<K, T, Compare, Allocator, Multi>::make_node_() {
+  using alloc = typename std::allocator_traits<
+      Allocator>::template rebind_alloc<Node>;
+  using traits = std::allocator_traits<alloc>;
+  alloc a(alloc_);
+  Node *node = traits::allocate(a, 1);
+  traits::construct(a, node);
+  return node;
+}
+
+// Destroys the elements or keys the node still holds.
+template <typename K, typename T, typename Compare, typename Allocator,
+          bool Multi>
+void btree<K, T, Compare, Allocator, Multi>::free_node_(node_base *node) {
+  if (node->leaf) {
+    using alloc = typename std::allocator_traits<
+        Allocator>::template rebind_alloc<leaf_node>;
+    alloc a(alloc_);
+    leaf_node *leaf = static_cast<leaf_node *>(node);
+    destroy_(leaf->slots(), leaf->slots() + leaf->count);
+    std::allocator_traits<alloc>::destroy(a, leaf);
+    std::allocator_traits<alloc>::deallocate(a, leaf, 1);
+  } else {
+    using alloc = typename std::allocator_traits<
+        Allocator>::template rebind_alloc<inner_node>;
+    alloc a(alloc_);
+    inner_node *inner = static_cast<inner_node *>(node);
+    destroy_(inner->keys(), inner->keys() + inner->count);
+    std::allocator_traits<alloc>::destroy(a, inner);
+    std::allocator_traits<alloc>::deallocate(a, inner, 1);
+  }
+}
+
+template <typename K, typename T, typename Compare, typename Allocator,
+          bool Multi>
+void btree<K, T, Compare, Allocator, Multi>::free_(node_base *node) {
+  if (!node->leaf) {
+    inner_node *inner = static_cast<inner_node *>(node);
+    for (size_t i = 0; i <= inner->count; ++i) free_(inner->children[i]);
+  }
+  free_node_(node);
+}
+
+// Copies a subtree; leaves are visited in order and chained after last.
+template <typename K, typename T, typename Compare, typename Allocator,
+          bool Multi>
+typename btree<K, T, Compare, Allocator, Multi>::node_base *
+btree<K, T, Compare, Allocator, Multi>::copy_(const node_base *node,
+                                              inner_node *parent,
+                                              leaf_node *&last) {
+  if (node->leaf) {
+    const leaf_node *src = static_cast<const leaf_node *>(node);
+    leaf_node *res = make_node_<leaf_node>();
+    for (; res->count < src->count; res->count++)
+      construct_(res->slots() + res->count, src->slots()[res->count]);
+    res->parent = parent;
+    res->prev = last;
+    if (last)
+      last->next = res;
+    else
+      leftmost_ = res;
+    last = res;
+    return res;
+  }
+  const inner_node *src = static_cast<const inner_node *>(node);
+  inner_node *res = make_node_<inner_node>();
+  for (; res->count < src->count; res->count++)
+    construct_(res->keys() + res->count, src->keys()[res->count]);
+  res->parent = parent;
+  for (size_t i = 0; i <= src->count; ++i)
+    res->children[i] = copy_(src->children[i], res, last);
+  return res;
+}
+
+template <typename K, typename T, typename Compare, typename Allocator,
+          bool Multi>
+size_t btree<K, T, Compare, Allocator, Multi>::child_index_(inner_node *parent,
+                                                            node_base *child) {
+  size_t i = 0;
+  while (parent->children[i] != child) ++i;
+  return i;
+}
+
+// Moves the upper half of a full leaf into a new right sibling.
+template <typename K, typename T, typename Compare, typename Allocator,
+          bool Multi>
+typename btree<K, T, Compare, Allocator, Multi>::leaf_node *
+btree<K, T, Compare, Allocator, Multi>::split_leaf_(leaf_node *leaf) {
+  leaf_node *right = make_node_<leaf_node>();
+  size_t mid = leaf->count / 2;
+  relocate_(leaf->slots() + mid, leaf->slots() + leaf->count, right->slots());
+  right->count = leaf->count - mid;
+  leaf->count = mid;
+  right->prev = leaf;
+  right->next = leaf->next;
+  if (leaf->next)
+    leaf->next->prev = right;
+  else
+    rightmost_ = right;
+  leaf->next = right;
+  insert_child_(leaf->parent, leaf, key_of(right->slots()[0]), right);
+  return right;
+}
+
+// Moves the keys above the middle one into a new right sibling, the
+// middle key goes up.
+template <typename K, typename T, typename Compare, typename Allocator,
+          bool Multi>
+typename btree<K, T, Compare, Allocator, Multi>::inner_node *
+btree<K, T, Compare, Allocator, Multi>::split_inner_(inner_node *node) {
+  inner_node *right = make_node_<inner_node>();
+  size_t mid = node->count / 2;
+  K *keys = node->keys();
+  K up = std::move(keys[mid]);
+  destroy_(keys + mid, keys + mid + 1);
+  relocate_(keys + mid + 1, keys + node->count, right->keys());
+  std::copy(node->children + mid + 1, node->children + node->count + 1,
+            right->children);
+  right->count = node->count - mid - 1;
+  node->count = mid;
+  for (size_t i = 0; i <= right->count; ++i) right->children[i]->parent = right;
+  insert_child_(node->parent, node, std::move(up), right);
+  return right;
+}
+
+// Links right into parent just after left, splitting parent when full.
+template <typename K, typename T, typename Compare, typename Allocator,
+          bool Multi>
+void btree<K, T, Compare, Allocator, Multi>::insert_child_(inner_node *parent,
+                                                          node_base *left,
+                                                          K sep,
+                                                          node_base *right) {
+  if (!parent) {
+    inner_node *root = make_node_<inner_node>();
+    construct_(root->keys(), std::move(sep));
+    root->children[0] = left;
+    root->children[1] = right;
+    root->count = 1;
+    left->parent = root;
+    right->parent = root;
+    root_ = root;
+    return;
+  }
+  if (parent->count == kInnerSlots) {
+    inner_node *other = split_inner_(parent);
+    if (left->parent == other) parent = other;
+  }
+  size_t i = child_index_(parent, left);
+  K *keys = parent->keys();
+  relocate_(keys + i, keys + parent->count, keys + i + 1);
+  std::copy_backward(parent->children + i + 1,
+                     parent->children + parent->count + 1,
+                     parent->children + parent->count + 2);
+  construct_(keys + i, std::move(sep));
+  parent->children[i + 1] = right;
+  right->parent = parent;
+  parent->count++;
+}
+
+// Drops keys[i] and children[i + 1] of parent.
+template <typename K, typename T, typename Compare, typename Allocator,
+          bool Multi>
+void btree<K, T, Compare, Allocator, Multi>::remove_child_(inner_node *parent,
+                                                          size_t i) {
+  K *keys = parent->keys();
+  destroy_(keys + i, keys + i + 1);
+  relocate_(keys + i + 1, keys + parent->count, keys + i);
+  std::copy(parent->children + i + 2, parent->children + parent->count + 1,
+            parent->children + i + 1);
+  parent->count--;
+  if (parent == root_) {
+    if (!parent->count) {
+      root_ = parent->children[0];
+      root_->parent = nullptr;
+      free_node_(parent);
+    }
+  } else if (parent->count < kInnerMin) {
+    rebalance_inner_(parent);
+  }
+}
+
+// Refills an underfull leaf from a sibling, or merges it with one.
+template <typename K, typename T, typename Compare, typename Allocator,
+          bool Multi>
+void btree<K, T, Compare, Allocator, Multi>::rebalance_leaf_(leaf_node *leaf) {
+  inner_node *parent = leaf->parent;
+  size_t i = child_index_(parent, leaf);
+  leaf_node *left =
+      i > 0 ? static_cast<leaf_node *>(parent->children[i - 1]) : nullptr;
+  leaf_node *right = i < parent->count
+                         ? static_cast<leaf_node *>(parent->children[i + 1])
+                         : nullptr;
+  if (left && left->count > kLeafMin) {
+    T *slots = leaf->slots();
+    relocate_(slots, slots + leaf->count, slots + 1);
+    relocate_(left->slots() + left->count - 1, left->slots() + left->count,
+              slots);
+    left->count--;
+    leaf->count++;
+    parent->keys()[i - 1] = key_of(slots[0]);
+  } else if (right && right->count > kLeafMin) {
+    T *slots = right->slots();
+    relocate_(slots, slots + 1, leaf->slots() + leaf->count);
+    leaf->count++;
+    relocate_(slots + 1, slots + right->count, slots);
+    right->count--;
+    parent->keys()[i] = key_of(slots[0]);
+  } else {
+    if (left) {
+      i--;
+      right = leaf;
+      leaf = left;
+    }
+    relocate_(right->slots(), right->slots() + right->count,
+              leaf->slots() + leaf->count);
+    leaf->count += right->count;
+    right->count = 0;
+    leaf->next = right->next;
+    if (right->next)
+      right->next->prev = leaf;
+    else
+      rightmost_ = leaf;
+    free_node_(right);
+    remove_child_(parent, i);
+  }
+}
+
+// Same for inner nodes, keys rotate through the parent.
+template <typename K, typename T, typename Compare, typename Allocator,
+          bool Multi>
+void btree<K, T, Compare, Allocator, Multi>::rebalance_inner_(
+    inner_node *node) {
+  inner_node *parent = node->parent;
+  size_t i = child_index_(parent, node);
+  inner_node *left =
+      i > 0 ? static_cast<inner_node *>(parent->children[i - 1]) : nullptr;
+  inner_node *right = i < parent->count
+                          ? static_cast<inner_node *>(parent->children[i + 1])
+                          : nullptr;
+  K *keys = parent->keys();
+  if (left && left->count > kInnerMin) {
+    relocate_(node->keys(), node->keys() + node->count, node->keys() + 1);
+    std::copy_backward(node->children, node->children + node->count + 1,
+                       node->children + node->count + 2);
+    construct_(node->keys(), std::move(keys[i - 1]));
+    node->children[0] = left->children[left->count];
+    node->children[0]->parent = node;
+    node->count++;
+    keys[i - 1] = std::move(left->keys()[left->count - 1]);
+    destroy_(left->keys() + left->count - 1, left->keys() + left->count);
+    left->count--;
+  } else if (right && right->count > kInnerMin) {
+    construct_(node->keys() + node->count, std::move(keys[i]));
+    node->children[node->count + 1] = right->children[0];
+    node->children[node->count + 1]->parent = node;
+    node->count++;
+    keys[i] = std::move(right->keys()[0]);
+    destroy_(right->keys(), right->keys() + 1);
+    relocate_(right->keys() + 1, right->keys() + right->count, right->keys());
+    std::copy(right->children + 1, right->children + right->count + 1,
+              right->children);
+    right->count--;
+  } else {
+    if (left) {
+      i--;
+      right = node;
+      node = left;
+    }
+    construct_(node->keys() + node->count, std::move(keys[i]));
+    relocate_(right->keys(), right->keys() + right->count,
+              node->keys() + node->count + 1);
+    std::copy(right->children, right->children + right->count + 1,
+              node->children + node->count + 1);
+    for (size_t j = 0; j <= right->count; ++j)
+      right->children[j]->parent = node;
+    node->count += right->count + 1;
+    right->count = 0;
+    free_node_(right);
+    remove_child_(parent, i);
+  }
+}
+
+template <typename K, typename T, typename Compare, typename Allocator,
+          bool Multi>
+typename btree<K, T, Compare, Allocator, Multi>::iterator &
+btree<K, T, Compare, Allocator, Multi>::iterator::operator++() {
+  if (++pos == leaf->count && leaf->next) {
+    leaf = leaf->next;
+    pos = 0;
+  }
+  return *this;
+}
+
+template <typename K, typename T, typename Compare, typename Allocator,
+          bool Multi>
+typename btree<K, T, Compare, Allocator, Multi>::iterator &
+btree<K, T, Compare, Allocator, Multi>::iterator::operator--() {
+  if (!pos) {
+    leaf = leaf->prev;
+    pos = leaf->count;
+  }
+  --pos;
+  return *this;
+}
+
+template <typename K, typename T, typename Compare, typename Allocator,
+          bool Multi>
+bool btree<K, T, Compare, Allocator, Multi>::iterator::operator==(
+    const iterator &it) const {
+  return leaf == it.leaf && pos == it.pos;
+}
+
+template <typename K, typename T, typename Compare, typename Allocator,
+          bool Multi>
+bool btree<K, T, Compare, Allocator, Multi>::iterator::operator!=(
+    const iterator &it) const {
+  return !(*this == it);
+}
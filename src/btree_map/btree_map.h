@@ -0,0 +1,53 @@
+#ifndef BTREE_MAP_H
+#define BTREE_MAP_H
+#include <functional>
+#include <initializer_list>
+#include <stdexcept>
+#include <tuple>
+
+#include "../btree/btree.h"
+namespace s21 {
+// Drop-in for s21::map on top of a B+-tree, see btree.h.
+template <typename K, typename V, typename Compare = std::less<K>,
+          typename Allocator = std::allocator<std::pair<const K, V>>>
+class btree_map
+    : public btree<K, std::pair<const K, V>, Compare, Allocator, false> {
+  using base = btree<K, std::pair<const K, V>, Compare, Allocator, false>;
+
+ public:
+  using typename base::const_iterator;
+  using typename base::iterator;
+  using key_type = K;
+  using mapped_type = V;
+  using value_type = std::pair<const K, V>;
+  using reference = value_type &;
+  using const_reference = const value_type &;
+  using size_type = size_t;
+  using allocator_type = Allocator;
+  using key_compare = Compare;
+
+  btree_map() = default;
+  explicit btree_map(const Allocator &alloc) : base(alloc){};
+  explicit btree_map(const Compare &comp, const Allocator &alloc = Allocator())
+      : base(comp, alloc){};
+  btree_map(std::initializer_list<value_type> const &items,
+            const Allocator &alloc = Allocator());
+  template <typename InputIt>
+  btree_map(InputIt first, InputIt last, const Allocator &alloc = Allocator());
+  btree_map(const btree_map &m) = default;
+  btree_map(btree_map &&m) = default;
+  btree_map &operator=(const btree_map &m) = default;
+  btree_map &operator=(btree_map &&m) = default;
+
+  V &at(const K &key);
+  V &operator[](const K &key);
+
+  std::pair<iterator, bool> insert(const value_type &value);
+  std::pair<iterator, bool> insert(const K &key, const V &obj);
+  std::pair<iterator, bool> insert_or_assign(const K &key, const V &obj);
+  template <typename... Args>
+  std::vector<std::pair<iterator, bool>> insert_many(Args &&...args);
+};
+}  // namespace s21
+#include "btree_map.tpp"
+#endif  // BTREE_MAP_H
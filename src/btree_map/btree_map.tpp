@@ -0,0 +1,63 @@
+#include "btree_map.h"
+namespace s21 {
+
+template <typename K, typename V, typename Compare, typename Allocator>
+btree_map<K, V, Compare, Allocator>::btree_map(
+    const std::initializer_list<value_type> &items, const Allocator &alloc)
+    : btree_map(items.begin(), items.end(), alloc) {}
+
+template <typename K, typename V, typename Compare, typename Allocator>
+template <typename InputIt>
+btree_map<K, V, Compare, Allocator>::btree_map(InputIt first, InputIt last,
+                                               const Allocator &alloc)
+    : base(alloc) {
+  for (; first != last; ++first) insert(*first);
+}
+
+template <typename K, typename V, typename Compare, typename Allocator>
+V &btree_map<K, V, Compare, Allocator>::at(const K &key) {
+  iterator it = this->find(key);
+  if (it == this->end()) throw std::out_of_range("Out of range");
+  return it->second;
+}
+
+template <typename K, typename V, typename Compare, typename Allocator>
+V &btree_map<K, V, Compare, Allocator>::operator[](const K &key) {
+  return this
+      ->emplace_key_(key, std::piecewise_construct, std::forward_as_tuple(key),
+                     std::forward_as_tuple())
+      .first->second;
+}
+
+template <typename K, typename V, typename Compare, typename Allocator>
+std::pair<typename btree_map<K, V, Compare, Allocator>::iterator, bool>
+btree_map<K, V, Compare, Allocator>::insert(const value_type &value) {
+  return this->emplace_key_(value.first, value);
+}
+
+template <typename K, typename V, typename Compare, typename Allocator>
+std::pair<typename btree_map<K, V, Compare, Allocator>::iterator, bool>
+btree_map<K, V, Compare, Allocator>::insert(const K &key, const V &obj) {
+  return this->emplace_key_(key, key, obj);
+}
+
+template <typename K, typename V, typename Compare, typename Allocator>
+std::pair<typename btree_map<K, V, Compare, Allocator>::iterator, bool>
+btree_map<K, V, Compare, Allocator>::insert_or_assign(const K &key,
+                                                      const V &obj) {
+  std::pair<iterator, bool> res = this->emplace_key_(key, key, obj);
+  if (!res.second) res.first->second = obj;
+  return res;
+}
+
+template <typename K, typename V, typename Compare, typename Allocator>
+template <typename... Args>
+std::vector<
+    std::pair<typename btree_map<K, V, Compare, Allocator>::iterator, bool>>
+btree_map<K, V, Compare, Allocator>::insert_many(Args &&...args) {
+  std::vector<std::pair<iterator, bool>> res;
+  for (const auto &arg : {args...}) res.push_back(insert(arg));
+  return res;
+}
+
+}  // namespace s21
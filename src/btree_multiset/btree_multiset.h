@@ -0,0 +1,47 @@
+#ifndef BTREE_MULTISET_H
+#define BTREE_MULTISET_H
+#include <functional>
+#include <initializer_list>
+
+#include "../btree/btree.h"
+namespace s21 {
+// Drop-in for s21::multiset on top of a B+-tree, see btree.h. Equal keys
+// are stored as separate slots in insertion order.
+template <typename K, typename Compare = std::less<K>,
+          typename Allocator = std::allocator<K>>
+class btree_multiset : public btree<K, K, Compare, Allocator, true> {
+  using base = btree<K, K, Compare, Allocator, true>;
+
+ public:
+  using typename base::const_iterator;
+  using typename base::iterator;
+  using key_type = K;
+  using value_type = K;
+  using reference = value_type &;
+  using const_reference = const value_type &;
+  using size_type = size_t;
+  using allocator_type = Allocator;
+  using key_compare = Compare;
+
+  btree_multiset() = default;
+  explicit btree_multiset(const Allocator &alloc) : base(alloc){};
+  explicit btree_multiset(const Compare &comp,
+                          const Allocator &alloc = Allocator())
+      : base(comp, alloc){};
+  btree_multiset(std::initializer_list<value_type> const &items,
+                 const Allocator &alloc = Allocator());
+  template <typename InputIt>
+  btree_multiset(InputIt first, InputIt last,
+                 const Allocator &alloc = Allocator());
+  btree_multiset(const btree_multiset &s) = default;
+  btree_multiset(btree_multiset &&s) = default;
+  btree_multiset &operator=(const btree_multiset &s) = default;
+  btree_multiset &operator=(btree_multiset &&s) = default;
+
+  iterator insert(const value_type &value);
+  template <typename... Args>
+  std::vector<iterator> insert_many(Args &&...args);
+};
+}  // namespace s21
+#include "btree_multiset.tpp"
+#endif  // BTREE_MULTISET_H
@@ -0,0 +1,33 @@
+#include "btree_multiset.h"
+namespace s21 {
+
+template <typename K, typename Compare, typename Allocator>
+btree_multiset<K, Compare, Allocator>::btree_multiset(
+    const std::initializer_list<value_type> &items, const Allocator &alloc)
+    : btree_multiset(items.begin(), items.end(), alloc) {}
+
+template <typename K, typename Compare, typename Allocator>
+template <typename InputIt>
+btree_multiset<K, Compare, Allocator>::btree_multiset(InputIt first,
+                                                      InputIt last,
+                                                      const Allocator &alloc)
+    : base(alloc) {
+  for (; first != last; ++first) insert(*first);
+}
+
+template <typename K, typename Compare, typename Allocator>
+typename btree_multiset<K, Compare, Allocator>::iterator
+btree_multiset<K, Compare, Allocator>::insert(const value_type &value) {
+  return this->emplace_key_(value, value).first;
+}
+
+template <typename K, typename Compare, typename Allocator>
+template <typename... Args>
+std::vector<typename btree_multiset<K, Compare, Allocator>::iterator>
+btree_multiset<K, Compare, Allocator>::insert_many(Args &&...args) {
+  std::vector<iterator> res;
+  for (const auto &arg : {args...}) res.push_back(insert(arg));
+  return res;
+}
+
+}  // namespace s21
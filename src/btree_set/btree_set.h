@@ -0,0 +1,44 @@
+#ifndef BTREE_SET_H
+#define BTREE_SET_H
+#include <functional>
+#include <initializer_list>
+
+#include "../btree/btree.h"
+namespace s21 {
+// Drop-in for s21::set on top of a B+-tree, see btree.h.
+template <typename K, typename Compare = std::less<K>,
+          typename Allocator = std::allocator<K>>
+class btree_set : public btree<K, K, Compare, Allocator, false> {
+  using base = btree<K, K, Compare, Allocator, false>;
+
+ public:
+  using typename base::const_iterator;
+  using typename base::iterator;
+  using key_type = K;
+  using value_type = K;
+  using reference = value_type &;
+  using const_reference = const value_type &;
+  using size_type = size_t;
+  using allocator_type = Allocator;
+  using key_compare = Compare;
+
+  btree_set() = default;
+  explicit btree_set(const Allocator &alloc) : base(alloc){};
+  explicit btree_set(const Compare &comp, const Allocator &alloc = Allocator())
+      : base(comp, alloc){};
+  btree_set(std::initializer_list<value_type> const &items,
+            const Allocator &alloc = Allocator());
+  template <typename InputIt>
+  btree_set(InputIt first, InputIt last, const Allocator &alloc = Allocator());
+  btree_set(const btree_set &s) = default;
+  btree_set(btree_set &&s) = default;
+  btree_set &operator=(const btree_set &s) = default;
+  btree_set &operator=(btree_set &&s) = default;
+
+  std::pair<iterator, bool> insert(const value_type &value);
+  template <typename... Args>
+  std::vector<std::pair<iterator, bool>> insert_many(Args &&...args);
+};
+}  // namespace s21
+#include "btree_set.tpp"
+#endif  // BTREE_SET_H
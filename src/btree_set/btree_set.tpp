@@ -0,0 +1,33 @@
+#include "btree_set.h"
+namespace s21 {
+
+template <typename K, typename Compare, typename Allocator>
+btree_set<K, Compare, Allocator>::btree_set(
+    const std::initializer_list<value_type> &items, const Allocator &alloc)
+    : btree_set(items.begin(), items.end(), alloc) {}
+
+template <typename K, typename Compare, typename Allocator>
+template <typename InputIt>
+btree_set<K, Compare, Allocator>::btree_set(InputIt first, InputIt last,
+                                            const Allocator &alloc)
+    : base(alloc) {
+  for (; first != last; ++first) insert(*first);
+}
+
+template <typename K, typename Compare, typename Allocator>
+std::pair<typename btree_set<K, Compare, Allocator>::iterator, bool>
+btree_set<K, Compare, Allocator>::insert(const value_type &value) {
+  return this->emplace_key_(value, value);
+}
+
+template <typename K, typename Compare, typename Allocator>
+template <typename... Args>
+std::vector<
+    std::pair<typename btree_set<K, Compare, Allocator>::iterator, bool>>
+btree_set<K, Compare, Allocator>::insert_many(Args &&...args) {
+  std::vector<std::pair<iterator, bool>> res;
+  for (const auto &arg : {args...}) res.push_back(insert(arg));
+  return res;
+}
+
+}  // namespace s21
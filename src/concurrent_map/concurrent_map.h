@@ -0,0 +1,92 @@
+#ifndef CONCURRENT_MAP_H
+#define CONCURRENT_MAP_H
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "../persistent_map/persistent_map.h"
+#include "../skiplist/epoch.h"
+namespace s21 {
+// Ordered map shared between threads. Keys are spread by hash over shards.
+// Each shard publishes an s21::persistent_map version through an atomic
+// pointer, and readers take no lock: they pin the epoch, load the version
+// and search it, nobody writes it any more. Writers of a shard take its
+// mutex, update a copy, which path-copies O(log n) nodes, and publish it.
+// The old version is freed once no pinned reader can still hold it.
+template <typename K, typename V, typename Compare = std::less<K>,
+          typename Hash = std::hash<K>,
+          typename Allocator = std::allocator<std::pair<const K, V>>>
+class concurrent_map {
+ public:
+  using key_type = K;
+  using mapped_type = V;
+  using value_type = std::pair<const K, V>;
+  using size_type = size_t;
+  using key_compare = Compare;
+  using hasher = Hash;
+  using allocator_type = Allocator;
+
+  concurrent_map() : concurrent_map(0){};
+  // 0 shards picks four per core.
+  explicit concurrent_map(size_type shards, const Compare &comp = Compare(),
+                          const Hash &hash = Hash(),
+                          const Allocator &alloc = Allocator());
+  concurrent_map(const concurrent_map &) = delete;
+  concurrent_map &operator=(const concurrent_map &) = delete;
+
+  bool find(const K &key, V &value) const;
+  bool contains(const K &key) const;
+
+  bool insert(const K &key, const V &obj);
+  bool insert_or_assign(const K &key, const V &obj);
+  bool erase(const K &key);
+  void clear();
+
+  size_type size() const;
+  bool empty() const;
+  size_type shard_count() const { return shards_.size(); };
+
+  // Calls f with every element in key order, as each shard was on entry.
+  // Writers do not wait for it.
+  template <typename F>
+  void for_each(F f);
+
+ private:
+  struct alignas(64) shard {
+    using version = persistent_map<K, V, Compare, Allocator>;
+    shard(const Compare &comp, const Allocator &alloc)
+        : current(new version(comp, alloc)){};
+    ~shard();
+
+    void publish_(std::unique_ptr<version> next);
+
+    // The version readers see, only writers replace it.
+    std::atomic<version *> current;
+    // Replaced versions with the epoch they were retired in.
+    std::vector<std::pair<std::unique_ptr<version>, uint64_t>> retired;
+    std::atomic<size_t> elements{0};
+    // Taken by writers only.
+    std::mutex lock;
+  };
+  using version = typename shard::version;
+  using write_lock = std::lock_guard<std::mutex>;
+
+  shard &shard_of(const K &key) const;
+  bool read_(const K &key, V *value) const;
+
+  Hash hash_;
+  size_type mask_ = 0;
+  // Shards never move, a deque builds them in place.
+  mutable std::deque<shard> shards_;
+};
+}  // namespace s21
+
+#include "concurrent_map.tpp"
+#endif  // CONCURRENT_MAP_H
@@ -0,0 +1,188 @@
+#include "concurrent_map.h"
+namespace s21 {
+
+template <typename K, typename V, typename Compare, typename Hash,
+          typename Allocator>
+concurrent_map<K, V, Compare, Hash, Allocator>::concurrent_map(
+    size_type shards, const Compare &comp, const Hash &hash,
+    const Allocator &alloc)
+    : hash_(hash) {
+  if (shards == 0)
+    shards = 4 * std::max(1u, std::thread::hardware_concurrency());
+  size_type count = 1;
+  while (count < shards) count *= 2;
+  mask_ = count - 1;
+  for (size_type i = 0; i < count; ++i) shards_.emplace_back(comp, alloc);
+}
+
+template <typename K, typename V, typename Compare, typename Hash,
+          typename Allocator>
+typename concurrent_map<K, V, Compare, Hash, Allocator>::shard &
+concurrent_map<K, V, Compare, Hash, Allocator>::shard_of(const K &key) const {
+  uint64_t h = static_cast<uint64_t>(hash_(key)) * 0x9e3779b97f4a7c15ULL;
+  return shards_[(h >> 32) & mask_];
+}
+
+template <typename K, typename V, typename Compare, typename Hash,
+          typename Allocator>
+concurrent_map<K, V, Compare, Hash, Allocator>::shard::~shard() {
+  delete current.load(std::memory_order_relaxed);
+}
+
+// Runs under lock. The old version is retired after it is unlinked, and
+// those no pinned reader can reach any more are freed.
+template <typename K, typename V, typename Compare, typename Hash,
+          typename Allocator>
+void concurrent_map<K, V, Compare, Hash, Allocator>::shard::publish_(
+    std::unique_ptr<version> next) {
+  // The only step that may throw comes first.
+  retired.emplace_back(nullptr, 0);
+  retired.back().first.reset(
+      current.exchange(next.release(), std::memory_order_acq_rel));
+  retired.back().second = epoch::current();
+  epoch::try_advance();
+  retired.erase(std::remove_if(retired.begin(), retired.end(),
+                               [](const auto &item) {
+                                 return epoch::safe(item.second);
+                               }),
+                retired.end());
+}
+
+// Lock-free: the pinned version is never written and stays allocated.
+template <typename K, typename V, typename Compare, typename Hash,
+          typename Allocator>
+bool concurrent_map<K, V, Compare, Hash, Allocator>::read_(const K &key,
+                                                           V *value) const {
+  shard &s = shard_of(key);
+  epoch::guard pin;
+  const version *v = s.current.load(std::memory_order_acquire);
+  if (!value) return v->contains(key);
+  auto it = v->find(key);
+  if (it == v->end()) return false;
+  *value = it->second;
+  return true;
+}
+
+template <typename K, typename V, typename Compare, typename Hash,
+          typename Allocator>
+bool concurrent_map<K, V, Compare, Hash, Allocator>::find(const K &key,
+                                                          V &value) const {
+  return read_(key, &value);
+}
+
+template <typename K, typename V, typename Compare, typename Hash,
+          typename Allocator>
+bool concurrent_map<K, V, Compare, Hash, Allocator>::contains(
+    const K &key) const {
+  return read_(key, nullptr);
+}
+
+// A present key is found in the current version, nothing is copied then.
+template <typename K, typename V, typename Compare, typename Hash,
+          typename Allocator>
+bool concurrent_map<K, V, Compare, Hash, Allocator>::insert(const K &key,
+                                                            const V &obj) {
+  shard &s = shard_of(key);
+  write_lock guard(s.lock);
+  const version *old = s.current.load(std::memory_order_relaxed);
+  if (old->contains(key)) return false;
+  auto next = std::make_unique<version>(*old);
+  next->insert(key, obj);
+  s.publish_(std::move(next));
+  s.elements.fetch_add(1, std::memory_order_relaxed);
+  return true;
+}
+
+template <typename K, typename V, typename Compare, typename Hash,
+          typename Allocator>
+bool concurrent_map<K, V, Compare, Hash, Allocator>::insert_or_assign(
+    const K &key, const V &obj) {
+  shard &s = shard_of(key);
+  write_lock guard(s.lock);
+  auto next = std::make_unique<version>(
+      *s.current.load(std::memory_order_relaxed));
+  bool inserted = next->insert_or_assign(key, obj);
+  s.publish_(std::move(next));
+  if (inserted) s.elements.fetch_add(1, std::memory_order_relaxed);
+  return inserted;
+}
+
+template <typename K, typename V, typename Compare, typename Hash,
+          typename Allocator>
+bool concurrent_map<K, V, Compare, Hash, Allocator>::erase(const K &key) {
+  shard &s = shard_of(key);
+  write_lock guard(s.lock);
+  const version *old = s.current.load(std::memory_order_relaxed);
+  if (!old->contains(key)) return false;
+  auto next = std::make_unique<version>(*old);
+  next->erase(key);
+  s.publish_(std::move(next));
+  s.elements.fetch_sub(1, std::memory_order_relaxed);
+  return true;
+}
+
+template <typename K, typename V, typename Compare, typename Hash,
+          typename Allocator>
+void concurrent_map<K, V, Compare, Hash, Allocator>::clear() {
+  for (shard &s : shards_) {
+    write_lock guard(s.lock);
+    const version *old = s.current.load(std::memory_order_relaxed);
+    if (old->empty()) continue;
+    s.publish_(
+        std::make_unique<version>(old->key_comp(), old->get_allocator()));
+    s.elements.store(0, std::memory_order_relaxed);
+  }
+}
+
+template <typename K, typename V, typename Compare, typename Hash,
+          typename Allocator>
+typename concurrent_map<K, V, Compare, Hash, Allocator>::size_type
+concurrent_map<K, V, Compare, Hash, Allocator>::size() const {
+  size_type res = 0;
+  for (const shard &s : shards_)
+    res += s.elements.load(std::memory_order_relaxed);
+  return res;
+}
+
+template <typename K, typename V, typename Compare, typename Hash,
+          typename Allocator>
+bool concurrent_map<K, V, Compare, Hash, Allocator>::empty() const {
+  return size() == 0;
+}
+
+// Merges snapshots of the shards through a heap of their current
+// elements. A snapshot shares the version, it keeps its nodes alive
+// without the epoch pinned while f runs.
+template <typename K, typename V, typename Compare, typename Hash,
+          typename Allocator>
+template <typename F>
+void concurrent_map<K, V, Compare, Hash, Allocator>::for_each(F f) {
+  using iterator = typename version::iterator;
+  std::vector<version> snapshots;
+  snapshots.reserve(shards_.size());
+  {
+    epoch::guard pin;
+    for (shard &s : shards_)
+      snapshots.push_back(*s.current.load(std::memory_order_acquire));
+  }
+  std::vector<std::pair<iterator, iterator>> heap;
+  for (const version &v : snapshots)
+    if (!v.empty()) heap.emplace_back(v.begin(), v.end());
+  Compare comp = snapshots.front().key_comp();
+  auto later = [&comp](std::pair<iterator, iterator> &a,
+                       std::pair<iterator, iterator> &b) {
+    return comp((*b.first).first, (*a.first).first);
+  };
+  std::make_heap(heap.begin(), heap.end(), later);
+  while (!heap.empty()) {
+    std::pop_heap(heap.begin(), heap.end(), later);
+    auto &top = heap.back();
+    f(*top.first);
+    if (++top.first != top.second)
+      std::push_heap(heap.begin(), heap.end(), later);
+    else
+      heap.pop_back();
+  }
+}
+
+}  // namespace s21
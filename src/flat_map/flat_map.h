@@ -0,0 +1,91 @@
+#ifndef FLAT_MAP_H
+#define FLAT_MAP_H
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+
+#include "../flat_tree/flat_tree.h"
+namespace s21 {
+// Sorted-vector map for read-mostly tables, see flat_tree.h. Keys and
+// values are stored apart, so iterators yield pairs of references.
+template <typename K, typename V>
+class flat_map : public flat_tree<K, V, false> {
+  using base = flat_tree<K, V, false>;
+
+ public:
+  class iterator;
+  class const_iterator;
+  using key_type = K;
+  using mapped_type = V;
+  using value_type = std::pair<K, V>;
+  using reference = std::pair<const K &, V &>;
+  using const_reference = std::pair<const K &, const V &>;
+  using size_type = size_t;
+
+  flat_map() = default;
+  flat_map(std::initializer_list<value_type> const &items);
+  template <typename InputIt>
+  flat_map(InputIt first, InputIt last);
+
+  V &at(const K &key);
+  V &operator[](const K &key);
+
+  std::pair<iterator, bool> insert(const value_type &value);
+  std::pair<iterator, bool> insert(const K &key, const V &obj);
+  std::pair<iterator, bool> insert_or_assign(const K &key, const V &obj);
+  template <typename... Args>
+  std::vector<std::pair<iterator, bool>> insert_many(Args &&...args);
+  template <typename InputIt>
+  void insert_range(InputIt first, InputIt last);
+  void erase(iterator pos);
+
+  iterator begin();
+  iterator end();
+
+  iterator find(const K &key);
+  iterator lower_bound(const K &key);
+  iterator upper_bound(const K &key);
+  std::pair<iterator, iterator> equal_range(const K &key);
+
+  class iterator {
+    friend class flat_map;
+
+   public:
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type = flat_map::value_type;
+    using difference_type = std::ptrdiff_t;
+    using reference = flat_map::reference;
+    // Keeps the pair of references alive for operator->.
+    struct pointer {
+      reference ref;
+      reference *operator->() { return &ref; };
+    };
+
+    iterator() = default;
+    reference operator*() const { return reference(*key, *value); };
+    pointer operator->() const { return pointer{**this}; };
+    iterator &operator++();
+    iterator &operator--();
+    bool operator==(const iterator &it) const { return key == it.key; };
+    bool operator!=(const iterator &it) const { return key != it.key; };
+
+   protected:
+    iterator(K *k, V *v) : key(k), value(v){};
+    K *key = nullptr;
+    V *value = nullptr;
+  };
+  class const_iterator : public iterator {
+   public:
+    const_iterator() = default;
+    const_iterator(const iterator &it) : iterator(it){};
+    const_reference operator*() const {
+      return const_reference(*this->key, *this->value);
+    };
+  };
+
+ protected:
+  iterator make_iter_(size_t i);
+};
+}  // namespace s21
+#include "flat_map.tpp"
+#endif  // FLAT_MAP_H
@@ -0,0 +1,134 @@
+#include "flat_map.h"
+namespace s21 {
+
+template <typename K, typename V>
+flat_map<K, V>::flat_map(const std::initializer_list<value_type> &items)
+    : flat_map(items.begin(), items.end()) {}
+
+template <typename K, typename V>
+template <typename InputIt>
+flat_map<K, V>::flat_map(InputIt first, InputIt last) {
+  insert_range(first, last);
+}
+
+template <typename K, typename V>
+V &flat_map<K, V>::at(const K &key) {
+  size_t i = this->find_index_(key);
+  if (i == this->size()) throw std::out_of_range("Out of range");
+  return this->values_.data()[i];
+}
+
+// The value is only built when the key is missing.
+template <typename K, typename V>
+V &flat_map<K, V>::operator[](const K &key) {
+  size_t i = this->insert_(key).first;
+  return this->values_.data()[i];
+}
+
+template <typename K, typename V>
+std::pair<typename flat_map<K, V>::iterator, bool> flat_map<K, V>::insert(
+    const value_type &value) {
+  return insert(value.first, value.second);
+}
+
+template <typename K, typename V>
+std::pair<typename flat_map<K, V>::iterator, bool> flat_map<K, V>::insert(
+    const K &key, const V &obj) {
+  std::pair<size_t, bool> res = this->insert_(key, obj);
+  return std::make_pair(make_iter_(res.first), res.second);
+}
+
+template <typename K, typename V>
+std::pair<typename flat_map<K, V>::iterator, bool>
+flat_map<K, V>::insert_or_assign(const K &key, const V &obj) {
+  std::pair<size_t, bool> res = this->insert_(key, obj);
+  if (!res.second) this->values_.data()[res.first] = obj;
+  return std::make_pair(make_iter_(res.first), res.second);
+}
+
+template <typename K, typename V>
+template <typename... Args>
+std::vector<std::pair<typename flat_map<K, V>::iterator, bool>>
+flat_map<K, V>::insert_many(Args &&...args) {
+  std::vector<std::pair<iterator, bool>> res;
+  for (const auto &arg : {args...}) res.push_back(insert(arg));
+  return res;
+}
+
+// Sorts the new elements once and merges them in a single pass; among
+// equal keys the one already present, then the first given wins.
+template <typename K, typename V>
+template <typename InputIt>
+void flat_map<K, V>::insert_range(InputIt first, InputIt last) {
+  std::vector<value_type> items(first, last);
+  auto less = [](const value_type &a, const value_type &b) {
+    return a.first < b.first;
+  };
+  std::stable_sort(items.begin(), items.end(), less);
+  items.erase(std::unique(items.begin(), items.end(),
+                          [](const value_type &a, const value_type &b) {
+                            return !(a.first < b.first);
+                          }),
+              items.end());
+  this->merge_(
+      items.size(), [&items](size_t j) -> K & { return items[j].first; },
+      [&items](size_t j) -> V & { return items[j].second; }, [](size_t) {});
+}
+
+template <typename K, typename V>
+void flat_map<K, V>::erase(iterator pos) {
+  this->erase_(pos.key - this->keys_.data());
+}
+
+template <typename K, typename V>
+typename flat_map<K, V>::iterator flat_map<K, V>::make_iter_(size_t i) {
+  return iterator(this->keys_.data() + i, this->values_.data() + i);
+}
+
+template <typename K, typename V>
+typename flat_map<K, V>::iterator flat_map<K, V>::begin() {
+  return make_iter_(0);
+}
+
+template <typename K, typename V>
+typename flat_map<K, V>::iterator flat_map<K, V>::end() {
+  return make_iter_(this->size());
+}
+
+template <typename K, typename V>
+typename flat_map<K, V>::iterator flat_map<K, V>::find(const K &key) {
+  return make_iter_(this->find_index_(key));
+}
+
+template <typename K, typename V>
+typename flat_map<K, V>::iterator flat_map<K, V>::lower_bound(const K &key) {
+  return make_iter_(this->lower_index_(key));
+}
+
+template <typename K, typename V>
+typename flat_map<K, V>::iterator flat_map<K, V>::upper_bound(const K &key) {
+  return make_iter_(this->upper_index_(key));
+}
+
+template <typename K, typename V>
+std::pair<typename flat_map<K, V>::iterator,
+          typename flat_map<K, V>::iterator>
+flat_map<K, V>::equal_range(const K &key) {
+  return std::make_pair(lower_bound(key), upper_bound(key));
+}
+
+template <typename K, typename V>
+typename flat_map<K, V>::iterator &flat_map<K, V>::iterator::operator++() {
+  ++key;
+  ++value;
+  return *this;
+}
+
+template <typename K, typename V>
+typename flat_map<K, V>::iterator &flat_map<K, V>::iterator::operator--() {
+  --key;
+  --value;
+  return *this;
+}
+
+}  // namespace s21
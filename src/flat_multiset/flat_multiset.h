@@ -0,0 +1,42 @@
+#ifndef FLAT_MULTISET_H
+#define FLAT_MULTISET_H
+#include <initializer_list>
+
+#include "../flat_tree/flat_tree.h"
+namespace s21 {
+// Sorted-vector multiset, see flat_tree.h. Equal keys keep their
+// insertion order.
+template <typename K>
+class flat_multiset : public flat_tree<K, void, true> {
+ public:
+  using key_type = K;
+  using value_type = K;
+  using reference = const value_type &;
+  using const_reference = const value_type &;
+  using iterator = const K *;
+  using const_iterator = const K *;
+  using size_type = size_t;
+
+  flat_multiset() = default;
+  flat_multiset(std::initializer_list<value_type> const &items);
+  template <typename InputIt>
+  flat_multiset(InputIt first, InputIt last);
+
+  iterator insert(const value_type &value);
+  template <typename... Args>
+  std::vector<iterator> insert_many(Args &&...args);
+  template <typename InputIt>
+  void insert_range(InputIt first, InputIt last);
+  void erase(iterator pos);
+
+  iterator begin();
+  iterator end();
+
+  iterator find(const K &key);
+  iterator lower_bound(const K &key);
+  iterator upper_bound(const K &key);
+  std::pair<iterator, iterator> equal_range(const K &key);
+};
+}  // namespace s21
+#include "flat_multiset.tpp"
+#endif  // FLAT_MULTISET_H
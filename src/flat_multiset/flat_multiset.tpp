@@ -0,0 +1,80 @@
+#include "flat_multiset.h"
+namespace s21 {
+
+template <typename K>
+flat_multiset<K>::flat_multiset(
+    const std::initializer_list<value_type> &items)
+    : flat_multiset(items.begin(), items.end()) {}
+
+template <typename K>
+template <typename InputIt>
+flat_multiset<K>::flat_multiset(InputIt first, InputIt last) {
+  insert_range(first, last);
+}
+
+template <typename K>
+typename flat_multiset<K>::iterator flat_multiset<K>::insert(
+    const value_type &value) {
+  return begin() + this->insert_(value).first;
+}
+
+template <typename K>
+template <typename... Args>
+std::vector<typename flat_multiset<K>::iterator> flat_multiset<K>::insert_many(
+    Args &&...args) {
+  std::vector<iterator> res;
+  for (const auto &arg : {args...}) res.push_back(insert(arg));
+  return res;
+}
+
+// Sorts the new keys once and merges them in a single pass.
+template <typename K>
+template <typename InputIt>
+void flat_multiset<K>::insert_range(InputIt first, InputIt last) {
+  std::vector<K> items(first, last);
+  std::stable_sort(items.begin(), items.end());
+  this->merge_(
+      items.size(), [&items](size_t j) -> K & { return items[j]; },
+      [](size_t) -> char { return 0; }, [](size_t) {});
+}
+
+template <typename K>
+void flat_multiset<K>::erase(iterator pos) {
+  this->erase_(pos - begin());
+}
+
+template <typename K>
+typename flat_multiset<K>::iterator flat_multiset<K>::begin() {
+  return this->keys_.data();
+}
+
+template <typename K>
+typename flat_multiset<K>::iterator flat_multiset<K>::end() {
+  return begin() + this->size();
+}
+
+template <typename K>
+typename flat_multiset<K>::iterator flat_multiset<K>::find(const K &key) {
+  return begin() + this->find_index_(key);
+}
+
+template <typename K>
+typename flat_multiset<K>::iterator flat_multiset<K>::lower_bound(
+    const K &key) {
+  return begin() + this->lower_index_(key);
+}
+
+template <typename K>
+typename flat_multiset<K>::iterator flat_multiset<K>::upper_bound(
+    const K &key) {
+  return begin() + this->upper_index_(key);
+}
+
+template <typename K>
+std::pair<typename flat_multiset<K>::iterator,
+          typename flat_multiset<K>::iterator>
+flat_multiset<K>::equal_range(const K &key) {
+  return std::make_pair(lower_bound(key), upper_bound(key));
+}
+
+}  // namespace s21
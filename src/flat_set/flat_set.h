@@ -0,0 +1,41 @@
+#ifndef FLAT_SET_H
+#define FLAT_SET_H
+#include <initializer_list>
+
+#include "../flat_tree/flat_tree.h"
+namespace s21 {
+// Sorted-vector set for read-mostly tables, see flat_tree.h.
+template <typename K>
+class flat_set : public flat_tree<K, void, false> {
+ public:
+  using key_type = K;
+  using value_type = K;
+  using reference = const value_type &;
+  using const_reference = const value_type &;
+  using iterator = const K *;
+  using const_iterator = const K *;
+  using size_type = size_t;
+
+  flat_set() = default;
+  flat_set(std::initializer_list<value_type> const &items);
+  template <typename InputIt>
+  flat_set(InputIt first, InputIt last);
+
+  std::pair<iterator, bool> insert(const value_type &value);
+  template <typename... Args>
+  std::vector<std::pair<iterator, bool>> insert_many(Args &&...args);
+  template <typename InputIt>
+  void insert_range(InputIt first, InputIt last);
+  void erase(iterator pos);
+
+  iterator begin();
+  iterator end();
+
+  iterator find(const K &key);
+  iterator lower_bound(const K &key);
+  iterator upper_bound(const K &key);
+  std::pair<iterator, iterator> equal_range(const K &key);
+};
+}  // namespace s21
+#include "flat_set.tpp"
+#endif  // FLAT_SET_H
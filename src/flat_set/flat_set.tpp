@@ -0,0 +1,80 @@
+#include "flat_set.h"
+namespace s21 {
+
+template <typename K>
+flat_set<K>::flat_set(const std::initializer_list<value_type> &items)
+    : flat_set(items.begin(), items.end()) {}
+
+template <typename K>
+template <typename InputIt>
+flat_set<K>::flat_set(InputIt first, InputIt last) {
+  insert_range(first, last);
+}
+
+template <typename K>
+std::pair<typename flat_set<K>::iterator, bool> flat_set<K>::insert(
+    const value_type &value) {
+  std::pair<size_t, bool> res = this->insert_(value);
+  return std::make_pair(begin() + res.first, res.second);
+}
+
+template <typename K>
+template <typename... Args>
+std::vector<std::pair<typename flat_set<K>::iterator, bool>>
+flat_set<K>::insert_many(Args &&...args) {
+  std::vector<std::pair<iterator, bool>> res;
+  for (const auto &arg : {args...}) res.push_back(insert(arg));
+  return res;
+}
+
+// Sorts the new keys once and merges them in a single pass.
+template <typename K>
+template <typename InputIt>
+void flat_set<K>::insert_range(InputIt first, InputIt last) {
+  std::vector<K> items(first, last);
+  std::sort(items.begin(), items.end());
+  items.erase(std::unique(items.begin(), items.end(),
+                          [](const K &a, const K &b) { return !(a < b); }),
+              items.end());
+  this->merge_(
+      items.size(), [&items](size_t j) -> K & { return items[j]; },
+      [](size_t) -> char { return 0; }, [](size_t) {});
+}
+
+template <typename K>
+void flat_set<K>::erase(iterator pos) {
+  this->erase_(pos - begin());
+}
+
+template <typename K>
+typename flat_set<K>::iterator flat_set<K>::begin() {
+  return this->keys_.data();
+}
+
+template <typename K>
+typename flat_set<K>::iterator flat_set<K>::end() {
+  return begin() + this->size();
+}
+
+template <typename K>
+typename flat_set<K>::iterator flat_set<K>::find(const K &key) {
+  return begin() + this->find_index_(key);
+}
+
+template <typename K>
+typename flat_set<K>::iterator flat_set<K>::lower_bound(const K &key) {
+  return begin() + this->lower_index_(key);
+}
+
+template <typename K>
+typename flat_set<K>::iterator flat_set<K>::upper_bound(const K &key) {
+  return begin() + this->upper_index_(key);
+}
+
+template <typename K>
+std::pair<typename flat_set<K>::iterator, typename flat_set<K>::iterator>
+flat_set<K>::equal_range(const K &key) {
+  return std::make_pair(lower_bound(key), upper_bound(key));
+}
+
+}  // namespace s21
@@ -0,0 +1,55 @@
+#ifndef FLAT_TREE_H
+#define FLAT_TREE_H
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "../vector/s21_vector.h"
+
+// Sorted-array core of flat_map, flat_set and flat_multiset. Keys and
+// values sit in two parallel s21::vectors, so an element costs about
+// sizeof(K) + sizeof(V). V is void for the sets. Lookups are binary
+// searches over the key array; inserting or erasing shifts the tail and
+// invalidates iterators.
+template <typename K, typename V, bool Multi>
+class flat_tree {
+ protected:
+  static constexpr bool kHasValues = !std::is_void<V>::value;
+  using stored_type = std::conditional_t<kHasValues, V, char>;
+
+ public:
+  using key_type = K;
+  using size_type = size_t;
+
+  bool empty();
+  size_type size();
+  size_type max_size();
+  void clear();
+  void reserve(size_type n);
+  void shrink_to_fit();
+  void swap(flat_tree &other);
+  void merge(flat_tree &other);
+
+  bool contains(const K &key);
+  size_type count(const K &key);
+
+ protected:
+  size_t lower_index_(const K &key);
+  size_t upper_index_(const K &key);
+  size_t find_index_(const K &key);
+
+  template <typename... Args>
+  std::pair<size_t, bool> insert_(const K &key, Args &&...value);
+  void erase_(size_t i);
+  template <typename KeyAt, typename ValueAt, typename Reject>
+  void merge_(size_t n, KeyAt key_at, ValueAt value_at, Reject reject);
+
+  s21::vector<K> keys_;
+  s21::vector<stored_type> values_;
+};
+
+#include "flat_tree.tpp"
+#endif  // FLAT_TREE_H
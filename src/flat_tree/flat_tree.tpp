@@ -0,0 +1,184 @@
+#include "flat_tree.h"
+
+template <typename K, typename V, bool Multi>
+bool flat_tree<K, V, Multi>::empty() {
+  return keys_.empty();
+}
+
+template <typename K, typename V, bool Multi>
+size_t flat_tree<K, V, Multi>::size() {
+  return keys_.size();
+}
+
+template <typename K, typename V, bool Multi>
+size_t flat_tree<K, V, Multi>::max_size() {
+  return std::numeric_limits<size_t>::max() /
+         (sizeof(K) + (kHasValues ? sizeof(stored_type) : 0));
+}
+
+template <typename K, typename V, bool Multi>
+void flat_tree<K, V, Multi>::clear() {
+  keys_.clear();
+  values_.clear();
+}
+
+template <typename K, typename V, bool Multi>
+void flat_tree<K, V, Multi>::reserve(size_t n) {
+  keys_.reserve(n);
+  if constexpr (kHasValues) values_.reserve(n);
+}
+
+template <typename K, typename V, bool Multi>
+void flat_tree<K, V, Multi>::shrink_to_fit() {
+  keys_.shrink_to_fit();
+  values_.shrink_to_fit();
+}
+
+template <typename K, typename V, bool Multi>
+void flat_tree<K, V, Multi>::swap(flat_tree &other) {
+  keys_.swap(other.keys_);
+  values_.swap(other.values_);
+}
+
+template <typename K, typename V, bool Multi>
+bool flat_tree<K, V, Multi>::contains(const K &key) {
+  return find_index_(key) != size();
+}
+
+template <typename K, typename V, bool Multi>
+size_t flat_tree<K, V, Multi>::count(const K &key) {
+  return upper_index_(key) - lower_index_(key);
+}
+
+// For arithmetic keys the halving step compiles to a conditional move, so
+// the loop runs log2(n) iterations without mispredicted branches.
+template <typename K, typename V, bool Multi>
+size_t flat_tree<K, V, Multi>::lower_index_(const K &key) {
+  const K *first = keys_.data();
+  size_t n = keys_.size();
+  if constexpr (std::is_arithmetic<K>::value) {
+    if (!n) return 0;
+    const K *base = first;
+    while (n > 1) {
+      size_t half = n / 2;
+      base = base[half] < key ? base + half : base;
+      n -= half;
+    }
+    return base - first + (*base < key);
+  } else {
+    return std::lower_bound(first, first + n, key) - first;
+  }
+}
+
+template <typename K, typename V, bool Multi>
+size_t flat_tree<K, V, Multi>::upper_index_(const K &key) {
+  const K *first = keys_.data();
+  size_t n = keys_.size();
+  if constexpr (std::is_arithmetic<K>::value) {
+    if (!n) return 0;
+    const K *base = first;
+    while (n > 1) {
+      size_t half = n / 2;
+      base = key < base[half] ? base : base + half;
+      n -= half;
+    }
+    return base - first + !(key < *base);
+  } else {
+    return std::upper_bound(first, first + n, key) - first;
+  }
+}
+
+// Index of the first element equal to key, size() if there is none.
+template <typename K, typename V, bool Multi>
+size_t flat_tree<K, V, Multi>::find_index_(const K &key) {
+  size_t i = lower_index_(key);
+  if (i != keys_.size() && key < keys_.data()[i]) return keys_.size();
+  return i;
+}
+
+// Multi trees insert after the equal keys, unique ones return the index of
+// the equal key instead. The value is only built for a new element. When
+// it fails to go in, the key comes out again so the arrays stay parallel.
+template <typename K, typename V, bool Multi>
+template <typename... Args>
+std::pair<size_t, bool> flat_tree<K, V, Multi>::insert_(const K &key,
+                                                        Args &&...value) {
+  size_t i = Multi ? upper_index_(key) : lower_index_(key);
+  if (!Multi && i != keys_.size() && !(key < keys_.data()[i]))
+    return std::make_pair(i, false);
+  keys_.insert(keys_.begin() + i, key);
+  if constexpr (kHasValues) {
+    try {
+      values_.insert(values_.begin() + i,
+                     stored_type(std::forward<Args>(value)...));
+    } catch (...) {
+      keys_.erase(keys_.begin() + i);
+      throw;
+    }
+  }
+  return std::make_pair(i, true);
+}
+
+template <typename K, typename V, bool Multi>
+void flat_tree<K, V, Multi>::erase_(size_t i) {
+  keys_.erase(keys_.begin() + i);
+  if constexpr (kHasValues) values_.erase(values_.begin() + i);
+}
+
+// Merges n sorted elements into the arrays in one pass. Element j has key
+// key_at(j) and value value_at(j), both moved from. Unique trees keep
+// their own element on equal keys and hand j to reject.
+template <typename K, typename V, bool Multi>
+template <typename KeyAt, typename ValueAt, typename Reject>
+void flat_tree<K, V, Multi>::merge_(size_t n, KeyAt key_at,
+                                    ValueAt value_at, Reject reject) {
+  size_t old = keys_.size();
+  s21::vector<K> keys(old + n);
+  s21::vector<stored_type> values(kHasValues ? old + n : 0);
+  K *old_keys = keys_.data();
+  stored_type *old_values = values_.data();
+  size_t i = 0;
+  size_t j = 0;
+  size_t out = 0;
+  while (i < old || j < n) {
+    if (j == n || (i < old && !(key_at(j) < old_keys[i]))) {
+      if (!Multi && j < n && !(old_keys[i] < key_at(j))) {
+        reject(j++);
+        continue;
+      }
+      keys.data()[out] = std::move(old_keys[i]);
+      if constexpr (kHasValues)
+        values.data()[out] = std::move(old_values[i]);
+      ++i;
+    } else {
+      keys.data()[out] = std::move(key_at(j));
+      if constexpr (kHasValues) values.data()[out] = std::move(value_at(j));
+      ++j;
+    }
+    ++out;
+  }
+  keys.resize(out);
+  if constexpr (kHasValues) values.resize(out);
+  keys_.swap(keys);
+  values_.swap(values);
+}
+
+// Moves over the elements of other; keys this tree already has stay in
+// other unless Multi.
+template <typename K, typename V, bool Multi>
+void flat_tree<K, V, Multi>::merge(flat_tree &other) {
+  if (&other == this) return;
+  s21::vector<K> rest_keys;
+  s21::vector<stored_type> rest_values;
+  K *keys = other.keys_.data();
+  stored_type *values = other.values_.data();
+  merge_(
+      other.keys_.size(), [keys](size_t j) -> K & { return keys[j]; },
+      [values](size_t j) -> stored_type & { return values[j]; },
+      [&](size_t j) {
+        rest_keys.push_back(std::move(keys[j]));
+        if constexpr (kHasValues) rest_values.push_back(std::move(values[j]));
+      });
+  other.keys_ = std::move(rest_keys);
+  other.values_ = std::move(rest_values);
+}
@@ -0,0 +1,166 @@
+#ifndef HASH_TABLE_H
+#define HASH_TABLE_H
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+// Open-addressing core of unordered_map and unordered_set. Every slot has
+// a control byte, empty or the low 7 bits of the hash, and lookups compare
+// 16 control bytes at a time (SSE2 when available). Probing is linear, so
+// erase shifts the following run back instead of leaving tombstones.
+// Inserting or erasing may move elements and invalidates iterators.
+template <typename K, typename T, typename Hash, typename KeyEqual,
+          typename Allocator>
+class hash_table {
+ protected:
+  using ctrl_t = std::int8_t;
+  static constexpr ctrl_t kEmpty = -128;
+  static constexpr size_t kGroup = 16;
+  static constexpr size_t kMinCapacity = 16;
+
+  // Bit i is set for every control byte i of a 16-byte window that
+  // matches.
+  class group {
+   public:
+    explicit group(const ctrl_t *ctrl);
+    unsigned match(ctrl_t h2) const;
+    unsigned match_empty() const;
+    unsigned match_full() const;
+
+   private:
+#ifdef __SSE2__
+    __m128i ctrl_;
+#else
+    ctrl_t ctrl_[kGroup];
+#endif
+  };
+
+ public:
+  class iterator;
+  class const_iterator;
+  using key_type = K;
+  using value_type = T;
+  using reference = value_type &;
+  using const_reference = const value_type &;
+  using size_type = size_t;
+  using hasher = Hash;
+  using key_equal = KeyEqual;
+  using allocator_type = Allocator;
+
+  hash_table() = default;
+  explicit hash_table(const Allocator &alloc) : alloc_(alloc){};
+  hash_table(const hash_table &other);
+  hash_table(hash_table &&other);
+  ~hash_table();
+  hash_table &operator=(const hash_table &other);
+  hash_table &operator=(hash_table &&other);
+
+  allocator_type get_allocator() const { return alloc_; };
+
+  iterator begin();
+  iterator end();
+
+  bool empty();
+  size_type size();
+  size_type max_size();
+
+  void clear();
+  void erase(iterator pos);
+  void swap(hash_table &other);
+  void merge(hash_table &other);
+
+  iterator find(const K &key);
+  bool contains(const K &key);
+  size_type count(const K &key);
+
+  size_type bucket_count();
+  float load_factor();
+  float max_load_factor();
+  void max_load_factor(float ml);
+  void rehash(size_type count);
+  void reserve(size_type count);
+
+  // Set elements are keys, so they are handed out const. Map slots keep a
+  // const key of their own.
+  using element_ = std::conditional_t<std::is_same<K, T>::value, const T, T>;
+
+  class iterator {
+    friend class hash_table;
+
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = element_ *;
+    using reference = element_ &;
+
+    iterator() = default;
+    element_ &operator*() const { return table->slots_[index]; };
+    element_ *operator->() const { return &table->slots_[index]; };
+    iterator &operator++();
+    bool operator==(const iterator &it) const { return index == it.index; };
+    bool operator!=(const iterator &it) const { return index != it.index; };
+
+   protected:
+    iterator(hash_table *t, size_t i) : table(t), index(i){};
+    hash_table *table = nullptr;
+    size_t index = 0;
+  };
+  class const_iterator : public iterator {
+   public:
+    const_iterator() = default;
+    const_iterator(const iterator &it) : iterator(it){};
+    const T &operator*() const { return iterator::operator*(); };
+    const T *operator->() const { return iterator::operator->(); };
+  };
+
+ protected:
+  static const K &key_of(const T &slot);
+  static decltype(auto) take_(T &slot);
+  size_t hash_(const K &key) const;
+  static ctrl_t h2_(size_t hash) { return hash & 0x7f; };
+  void set_ctrl_(size_t i, ctrl_t c);
+  size_t next_full_(size_t i);
+  iterator make_iter_(size_t i) { return iterator(this, i); };
+  size_t find_index_(const K &key, size_t hash);
+  size_t find_empty_(size_t hash);
+
+  template <typename... Args>
+  std::pair<size_t, bool> emplace_key_(const K &key, Args &&...args);
+  template <typename... Args>
+  size_t insert_new_(size_t hash, Args &&...args);
+  void erase_index_(size_t i);
+  void resize_(size_t capacity);
+  size_t growth_limit_(size_t capacity);
+  size_t capacity_for_(size_t count);
+  void release_();
+  void copy_(const hash_table &other);
+
+  using ctrl_alloc = typename std::allocator_traits<
+      Allocator>::template rebind_alloc<ctrl_t>;
+  using slot_alloc =
+      typename std::allocator_traits<Allocator>::template rebind_alloc<T>;
+
+  Allocator alloc_;
+  Hash hash_fn_;
+  KeyEqual eq_;
+  // capacity_ + kGroup - 1 bytes, the tail mirrors the first bytes so a
+  // window may start at any slot.
+  ctrl_t *ctrl_ = nullptr;
+  T *slots_ = nullptr;
+  size_t capacity_ = 0;
+  size_t size_ = 0;
+  float max_load_ = 0.875f;
+};
+
+#include "hash_table.tpp"
+#endif  // HASH_TABLE_H
@@ -0,0 +1,492 @@
+#include "hash_table.h"
+
+#ifdef __SSE2__
+template <typename K, typename T, typename Hash, typename KeyEqual,
+          typename Allocator>
+hash_table<K, T, Hash, KeyEqual, Allocator>::group::group(const ctrl_t *ctrl)
+    : ctrl_(_mm_loadu_si128(reinterpret_cast<const __m128i *>(ctrl))) {}
+
+template <typename K, typename T, typename Hash, typename KeyEqual,
+          typename Allocator>
+unsigned hash_table<K, T, Hash, KeyEqual, Allocator>::group::match(
+    ctrl_t h2) const {
+  return _mm_movemask_epi8(_mm_cmpeq_epi8(ctrl_, _mm_set1_epi8(h2)));
+}
+
+// Empty bytes are the only ones with the sign bit set.
+template <typename K, typename T, typename Hash, typename KeyEqual,
+          typename Allocator>
+unsigned hash_table<K, T, Hash, KeyEqual, Allocator>::group::match_empty()
+    const {
+  return _mm_movemask_epi8(ctrl_);
+}
+#else
+template <typename K, typename T, typename Hash, typename KeyEqual,
+          typename Allocator>
+hash_table<K, T, Hash, KeyEqual, Allocator>::group::group(const ctrl_t *ctrl) {
+  std::copy(ctrl, ctrl + kGroup, ctrl_);
+}
+
+template <typename K, typename T, typename Hash, typename KeyEqual,
+          typename Allocator>
+unsigned hash_table<K, T, Hash, KeyEqual, Allocator>::group::match(
+    ctrl_t h2) const {
+  unsigned res = 0;
+  for (size_t i = 0; i < kGroup; ++i) res |= unsigned(ctrl_[i] == h2) << i;
+  return res;
+}
+
+template <typename K, typename T, typename Hash, typename KeyEqual,
+          typename Allocator>
+unsigned hash_table<K, T, Hash, KeyEqual, Allocator>::group::match_empty()
+    const {
+  return match(kEmpty);
+}
+#endif
+
+template <typename K, typename T, typename Hash, typename KeyEqual,
+          typename Allocator>
+unsigned hash_table<K, T, Hash, KeyEqual, Allocator>::group::match_full()
+    const {
+  return ~match_empty() & 0xffff;
+}
+
+template <typename K, typename T, typename Hash, typename KeyEqual,
+          typename Allocator>
+hash_table<K, T, Hash, KeyEqual, Allocator>::hash_table(
+    const hash_table &other)
+    : alloc_(std::allocator_traits<Allocator>::
+                 select_on_container_copy_construction(other.alloc_)) {
+  copy_(other);
+}
+
+template <typename K, typename T, typename Hash, typename KeyEqual,
+          typename Allocator>
+hash_table<K, T, Hash, KeyEqual, Allocator>::hash_table(hash_table &&other)
+    : alloc_(other.alloc_),
+      hash_fn_(other.hash_fn_),
+      eq_(other.eq_),
+      ctrl_(other.ctrl_),
+      slots_(other.slots_),
+      capacity_(other.capacity_),
+      size_(other.size_),
+      max_load_(other.max_load_) {
+  other.ctrl_ = nullptr;
+  other.slots_ = nullptr;
+  other.capacity_ = 0;
+  other.size_ = 0;
+}
+
+template <typename K, typename T, typename Hash, typename KeyEqual,
+          typename Allocator>
+hash_table<K, T, Hash, KeyEqual, Allocator>::~hash_table() {
+  release_();
+}
+
+template <typename K, typename T, typename Hash, typename KeyEqual,
+          typename Allocator>
+hash_table<K, T, Hash, KeyEqual, Allocator> &
+hash_table<K, T, Hash, KeyEqual, Allocator>::operator=(
+    const hash_table &other) {
+  if (&other == this) return *this;
+  release_();
+  copy_(other);
+  return *this;
+}
+
+// Storage is taken over when the allocators allow it, otherwise the
+// elements are copied.
+template <typename K, typename T, typename Hash, typename KeyEqual,
+          typename Allocator>
+hash_table<K, T, Hash, KeyEqual, Allocator> &
+hash_table<K, T, Hash, KeyEqual, Allocator>::operator=(hash_table &&other) {
+  if (&other == this) return *this;
+  using traits = std::allocator_traits<Allocator>;
+  if (!traits::propagate_on_container_move_assignment::value &&
+      alloc_ != other.alloc_) {
+    *this = other;
+    other.clear();
+    return *this;
+  }
+  release_();
+  if constexpr (traits::propagate_on_container_move_assignment::value)
+    alloc_ = other.alloc_;
+  swap(other);
+  return *this;
+}
+
+template <typename K, typename T, typename Hash, typename KeyEqual,
+          typename Allocator>
+const K &hash_table<K, T, Hash, KeyEqual, Allocator>::key_of(const T &slot) {
+  if constexpr (std::is_same<K, T>::value)
+    return slot;
+  else
+    return slot.first;
+}
+
+// The slot as an rvalue to build another slot from. A map slot has a const
+// key, which is moved all the same, the old slot is destroyed right after.
+template <typename K, typename T, typename Hash, typename KeyEqual,
+          typename Allocator>
+decltype(auto) hash_table<K, T, Hash, KeyEqual, Allocator>::take_(T &slot) {
+  if constexpr (std::is_same<K, T>::value)
+    return std::move(slot);
+  else
+    return std::pair<K &&, typename T::second_type &&>(
+        std::move(const_cast<K &>(slot.first)), std::move(slot.second));
+}
+
+// std::hash is the identity for integers, so the bits are mixed before
+// they are split into the probe start and the 7-bit control tag.
+template <typename K, typename T, typename Hash, typename KeyEqual,
+          typename Allocator>
+size_t hash_table<K, T, Hash, KeyEqual, Allocator>::hash_(
+    const K &key) const {
+  std::uint64_t h = hash_fn_(key) * 0x9e3779b97f4a7c15ull;
+  return static_cast<size_t>(h ^ (h >> 32));
+}
+
+template <typename K, typename T, typename Hash, typename KeyEqual,
+          typename Allocator>
+void hash_table<K, T, Hash, KeyEqual, Allocator>::set_ctrl_(size_t i,
+                                                             ctrl_t c) {
+  ctrl_[i] = c;
+  if (i < kGroup - 1) ctrl_[capacity_ + i] = c;
+}
+
+// First full slot at or after i, capacity_ if there is none.
+template <typename K, typename T, typename Hash, typename KeyEqual,
+          typename Allocator>
+size_t hash_table<K, T, Hash, KeyEqual, Allocator>::next_full_(size_t i) {
+  for (; i < capacity_; i += kGroup) {
+    unsigned mask = group(ctrl_ + i).match_full();
+    if (mask) return std::min(i + __builtin_ctz(mask), capacity_);
+  }
+  return capacity_;
+}
+
+// Walks the probe run from the home slot; a key is never stored past an
+// empty slot, so the first window holding one ends the search.
+template <typename K, typename T, typename Hash, typename KeyEqual,
+          typename Allocator>
+size_t hash_table<K, T, Hash, KeyEqual, Allocator>::find_index_(
+    const K &key, size_t hash) {
+  if (!capacity_) return 0;
+  size_t mask = capacity_ - 1;
+  for (size_t pos = (hash >> 7) & mask;; pos = (pos + kGroup) & mask) {
+    group g(ctrl_ + pos);
+    for (unsigned m = g.match(h2_(hash)); m; m &= m - 1) {
+      size_t i = (pos + __builtin_ctz(m)) & mask;
+      if (eq_(key, key_of(slots_[i]))) return i;
+    }
+    if (g.match_empty()) return capacity_;
+  }
+}
+
+template <typename K, typename T, typename Hash, typename KeyEqual,
+          typename Allocator>
+size_t hash_table<K, T, Hash, KeyEqual, Allocator>::find_empty_(
+    size_t hash) {
+  size_t mask = capacity_ - 1;
+  for (size_t pos = (hash >> 7) & mask;; pos = (pos + kGroup) & mask) {
+    unsigned m = group(ctrl_ + pos).match_empty();
+    if (m) return (pos + __builtin_ctz(m)) & mask;
+  }
+}
+
+template <typename K, typename T, typename Hash, typename KeyEqual,
+          typename Allocator>
+template <typename... Args>
+std::pair<size_t, bool> hash_table<K, T, Hash, KeyEqual,
+                                   Allocator>::emplace_key_(const K &key,
+                                                            Args &&...args) {
+  size_t hash = hash_(key);
+  size_t i = find_index_(key, hash);
+  if (i != capacity_) return std::make_pair(i, false);
+  return std::make_pair(insert_new_(hash, std::forward<Args>(args)...),
+                        true);
+}
+
+// Inserts an element whose key is known to be absent.
+template <typename K, typename T, typename Hash, typename KeyEqual,
+          typename Allocator>
+template <typename... Args>
+size_t hash_table<K, T, Hash, KeyEqual, Allocator>::insert_new_(
+    size_t hash, Args &&...args) {
+  if (size_ + 1 > growth_limit_(capacity_))
+    resize_(capacity_for_(size_ + 1));
+  size_t i = find_empty_(hash);
+  slot_alloc a(alloc_);
+  std::allocator_traits<slot_alloc>::construct(a, slots_ + i,
+                                               std::forward<Args>(args)...);
+  set_ctrl_(i, h2_(hash));
+  size_++;
+  return i;
+}
+
+// Backward-shift deletion: every later element of the run that may live
+// in the hole moves into it, so the run stays free of gaps.
+template <typename K, typename T, typename Hash, typename KeyEqual,
+          typename Allocator>
+void hash_table<K, T, Hash, KeyEqual, Allocator>::erase_index_(size_t i) {
+  using traits = std::allocator_traits<slot_alloc>;
+  slot_alloc a(alloc_);
+  size_t mask = capacity_ - 1;
+  size_t hole = i;
+  traits::destroy(a, slots_ + hole);
+  for (size_t j = (hole + 1) & mask; ctrl_[j] != kEmpty; j = (j + 1) & mask) {
+    size_t home = (hash_(key_of(slots_[j])) >> 7) & mask;
+    if (((j - home) & mask) >= ((j - hole) & mask)) {
+      traits::construct(a, slots_ + hole, take_(slots_[j]));
+      traits::destroy(a, slots_ + j);
+      set_ctrl_(hole, ctrl_[j]);
+      hole = j;
+    }
+  }
+  set_ctrl_(hole, kEmpty);
+  size_--;
+}
+
+template <typename K, typename T, typename Hash, typename KeyEqual,
+          typename Allocator>
+size_t hash_table<K, T, Hash, KeyEqual, Allocator>::growth_limit_(
+    size_t capacity) {
+  return std::min(capacity ? capacity - 1 : 0,
+                  static_cast<size_t>(capacity * max_load_));
+}
+
+// Smallest power of two holding count elements within the load factor.
+template <typename K, typename T, typename Hash, typename KeyEqual,
+          typename Allocator>
+size_t hash_table<K, T, Hash, KeyEqual, Allocator>::capacity_for_(
+    size_t count) {
+  size_t capacity = kMinCapacity;
+  while (growth_limit_(capacity) < count) capacity *= 2;
+  return capacity;
+}
+
+template <typename K, typename T, typename Hash, typename KeyEqual,
+          typename Allocator>
+void hash_table<K, T, Hash, KeyEqual, Allocator>::resize_(size_t capacity) {
+  using traits = std::allocator_traits<slot_alloc>;
+  ctrl_alloc ca(alloc_);
+  slot_alloc sa(alloc_);
+  ctrl_t *old_ctrl = ctrl_;
+  T *old_slots = slots_;
+  size_t old_capacity = capacity_;
+  ctrl_ = std::allocator_traits<ctrl_alloc>::allocate(ca,
+                                                      capacity + kGroup - 1);
+  std::fill(ctrl_, ctrl_ + capacity + kGroup - 1, kEmpty);
+  slots_ = traits::allocate(sa, capacity);
+  capacity_ = capacity;
+  for (size_t i = 0; i < old_capacity; ++i) {
+    if (old_ctrl[i] == kEmpty) continue;
+    size_t hash = hash_(key_of(old_slots[i]));
+    size_t j = find_empty_(hash);
+    traits::construct(sa, slots_ + j, take_(old_slots[i]));
+    traits::destroy(sa, old_slots + i);
+    set_ctrl_(j, h2_(hash));
+  }
+  if (old_capacity) {
+    std::allocator_traits<ctrl_alloc>::deallocate(ca, old_ctrl,
+                                                  old_capacity + kGroup - 1);
+    traits::deallocate(sa, old_slots, old_capacity);
+  }
+}
+
+template <typename K, typename T, typename Hash, typename KeyEqual,
+          typename Allocator>
+void hash_table<K, T, Hash, KeyEqual, Allocator>::release_() {
+  if (!capacity_) return;
+  clear();
+  ctrl_alloc ca(alloc_);
+  slot_alloc sa(alloc_);
+  std::allocator_traits<ctrl_alloc>::deallocate(ca, ctrl_,
+                                                capacity_ + kGroup - 1);
+  std::allocator_traits<slot_alloc>::deallocate(sa, slots_, capacity_);
+  ctrl_ = nullptr;
+  slots_ = nullptr;
+  capacity_ = 0;
+}
+
+// Same capacity and slot layout as other, so nothing is rehashed.
+template <typename K, typename T, typename Hash, typename KeyEqual,
+          typename Allocator>
+void hash_table<K, T, Hash, KeyEqual, Allocator>::copy_(
+    const hash_table &other) {
+  hash_fn_ = other.hash_fn_;
+  eq_ = other.eq_;
+  max_load_ = other.max_load_;
+  if (!other.capacity_) return;
+  ctrl_alloc ca(alloc_);
+  slot_alloc sa(alloc_);
+  capacity_ = other.capacity_;
+  ctrl_ = std::allocator_traits<ctrl_alloc>::allocate(ca,
+                                                      capacity_ + kGroup - 1);
+  std::copy(other.ctrl_, other.ctrl_ + capacity_ + kGroup - 1, ctrl_);
+  slots_ = std::allocator_traits<slot_alloc>::allocate(sa, capacity_);
+  for (size_t i = 0; i < capacity_; ++i)
+    if (ctrl_[i] != kEmpty)
+      std::allocator_traits<slot_alloc>::construct(sa, slots_ + i,
+                                                   other.slots_[i]);
+  size_ = other.size_;
+}
+
+template <typename K, typename T, typename Hash, typename KeyEqual,
+          typename Allocator>
+typename hash_table<K, T, Hash, KeyEqual, Allocator>::iterator
+hash_table<K, T, Hash, KeyEqual, Allocator>::begin() {
+  return iterator(this, next_full_(0));
+}
+
+template <typename K, typename T, typename Hash, typename KeyEqual,
+          typename Allocator>
+typename hash_table<K, T, Hash, KeyEqual, Allocator>::iterator
+hash_table<K, T, Hash, KeyEqual, Allocator>::end() {
+  return iterator(this, capacity_);
+}
+
+template <typename K, typename T, typename Hash, typename KeyEqual,
+          typename Allocator>
+bool hash_table<K, T, Hash, KeyEqual, Allocator>::empty() {
+  return !size_;
+}
+
+template <typename K, typename T, typename Hash, typename KeyEqual,
+          typename Allocator>
+size_t hash_table<K, T, Hash, KeyEqual, Allocator>::size() {
+  return size_;
+}
+
+template <typename K, typename T, typename Hash, typename KeyEqual,
+          typename Allocator>
+size_t hash_table<K, T, Hash, KeyEqual, Allocator>::max_size() {
+  return std::numeric_limits<size_t>::max() / (sizeof(T) + 1) / 2;
+}
+
+// Keeps the buckets.
+template <typename K, typename T, typename Hash, typename KeyEqual,
+          typename Allocator>
+void hash_table<K, T, Hash, KeyEqual, Allocator>::clear() {
+  slot_alloc a(alloc_);
+  for (size_t i = 0; i < capacity_; ++i)
+    if (ctrl_[i] != kEmpty)
+      std::allocator_traits<slot_alloc>::destroy(a, slots_ + i);
+  if (capacity_) std::fill(ctrl_, ctrl_ + capacity_ + kGroup - 1, kEmpty);
+  size_ = 0;
+}
+
+template <typename K, typename T, typename Hash, typename KeyEqual,
+          typename Allocator>
+void hash_table<K, T, Hash, KeyEqual, Allocator>::erase(iterator pos) {
+  erase_index_(pos.index);
+}
+
+template <typename K, typename T, typename Hash, typename KeyEqual,
+          typename Allocator>
+void hash_table<K, T, Hash, KeyEqual, Allocator>::swap(hash_table &other) {
+  using std::swap;
+  swap(hash_fn_, other.hash_fn_);
+  swap(eq_, other.eq_);
+  std::swap(ctrl_, other.ctrl_);
+  std::swap(slots_, other.slots_);
+  std::swap(capacity_, other.capacity_);
+  std::swap(size_, other.size_);
+  std::swap(max_load_, other.max_load_);
+  if constexpr (std::allocator_traits<
+                    Allocator>::propagate_on_container_swap::value)
+    swap(alloc_, other.alloc_);
+}
+
+// Moves over the elements of other whose keys this table lacks.
+template <typename K, typename T, typename Hash, typename KeyEqual,
+          typename Allocator>
+void hash_table<K, T, Hash, KeyEqual, Allocator>::merge(hash_table &other) {
+  if (&other == this) return;
+  for (size_t i = other.next_full_(0); i < other.capacity_;) {
+    T &slot = other.slots_[i];
+    size_t hash = hash_(key_of(slot));
+    if (find_index_(key_of(slot), hash) != capacity_) {
+      i = other.next_full_(i + 1);
+      continue;
+    }
+    insert_new_(hash, take_(slot));
+    // The shift may move a later element into slot i.
+    other.erase_index_(i);
+    i = other.next_full_(i);
+  }
+}
+
+template <typename K, typename T, typename Hash, typename KeyEqual,
+          typename Allocator>
+typename hash_table<K, T, Hash, KeyEqual, Allocator>::iterator
+hash_table<K, T, Hash, KeyEqual, Allocator>::find(const K &key) {
+  return iterator(this, find_index_(key, hash_(key)));
+}
+
+template <typename K, typename T, typename Hash, typename KeyEqual,
+          typename Allocator>
+bool hash_table<K, T, Hash, KeyEqual, Allocator>::contains(const K &key) {
+  return find_index_(key, hash_(key)) != capacity_;
+}
+
+template <typename K, typename T, typename Hash, typename KeyEqual,
+          typename Allocator>
+size_t hash_table<K, T, Hash, KeyEqual, Allocator>::count(const K &key) {
+  return contains(key);
+}
+
+template <typename K, typename T, typename Hash, typename KeyEqual,
+          typename Allocator>
+size_t hash_table<K, T, Hash, KeyEqual, Allocator>::bucket_count() {
+  return capacity_;
+}
+
+template <typename K, typename T, typename Hash, typename KeyEqual,
+          typename Allocator>
+float hash_table<K, T, Hash, KeyEqual, Allocator>::load_factor() {
+  return capacity_ ? static_cast<float>(size_) / capacity_ : 0.0f;
+}
+
+template <typename K, typename T, typename Hash, typename KeyEqual,
+          typename Allocator>
+float hash_table<K, T, Hash, KeyEqual, Allocator>::max_load_factor() {
+  return max_load_;
+}
+
+// Kept within [1/8, 15/16]: above that linear probe runs grow long, and a
+// table must keep an empty slot for lookups to stop.
+template <typename K, typename T, typename Hash, typename KeyEqual,
+          typename Allocator>
+void hash_table<K, T, Hash, KeyEqual, Allocator>::max_load_factor(float ml) {
+  max_load_ = std::min(std::max(ml, 0.125f), 0.9375f);
+  if (size_ > growth_limit_(capacity_)) resize_(capacity_for_(size_));
+}
+
+// At least count buckets, and enough for the current elements.
+template <typename K, typename T, typename Hash, typename KeyEqual,
+          typename Allocator>
+void hash_table<K, T, Hash, KeyEqual, Allocator>::rehash(size_t count) {
+  if (!count && !size_) {
+    release_();
+    return;
+  }
+  size_t capacity = capacity_for_(size_);
+  while (capacity < count) capacity *= 2;
+  if (capacity != capacity_) resize_(capacity);
+}
+
+// Room for count elements without further rehashing.
+template <typename K, typename T, typename Hash, typename KeyEqual,
+          typename Allocator>
+void hash_table<K, T, Hash, KeyEqual, Allocator>::reserve(size_t count) {
+  if (growth_limit_(capacity_) < count) resize_(capacity_for_(count));
+}
+
+template <typename K, typename T, typename Hash, typename KeyEqual,
+          typename Allocator>
+typename hash_table<K, T, Hash, KeyEqual, Allocator>::iterator &
+hash_table<K, T, Hash, KeyEqual, Allocator>::iterator::operator++() {
+  index = table->next_full_(index + 1);
+  return *this;
+}
@@ -1,53 +1,112 @@
 #ifndef MAP_H
 #define MAP_H
+#include <memory_resource>
+
 #include "../tree/tree.h"
 namespace s21 {
-template <typename K, typename V>
-class map : public tree<K, V> {
+template <typename K, typename V, typename Compare = std::less<K>,
+          typename Allocator = std::allocator<std::pair<const K, V>>>
+class map : public tree<K, V, Compare, Allocator> {
  public:
   class map_iter;
   class map_const_iter;
   using key_type = K;
   using mappet_type = V;
-  using value_type = std::pair<K, V>;
+  using mapped_type = V;
+  using value_type = std::pair<const K, V>;
   using reference = value_type &;
   using const_reference = const value_type &;
   using iterator = map_iter;
   using const_iterator = map_const_iter;
   using size_type = size_t;
+  using allocator_type = Allocator;
+  using key_compare = Compare;
+  using node_type = typename tree<K, V, Compare, Allocator>::node_handle;
+  struct insert_return_type;
 
   map();
-  map(std::initializer_list<value_type> const &items);
+  explicit map(const Allocator &alloc);
+  explicit map(const Compare &comp, const Allocator &alloc = Allocator());
+  map(std::initializer_list<value_type> const &items,
+      const Allocator &alloc = Allocator());
+  map(std::initializer_list<value_type> const &items, const Compare &comp,
+      const Allocator &alloc = Allocator());
+  template <typename InputIt>
+  map(InputIt first, InputIt last, const Allocator &alloc = Allocator());
+  template <typename InputIt>
+  map(InputIt first, InputIt last, const Compare &comp,
+      const Allocator &alloc = Allocator());
   map(const map &m);
   map(map &&m);
   ~map();
 
-  V &at(const K &key);
+  template <typename InputIt>
+  void assign_sorted(InputIt first, InputIt last);
+
+  template <typename Q = K>
+  V &at(const Q &key);
   V &operator[](const K &key);
+  V &operator[](K &&key);
 
   std::pair<iterator, bool> insert(const value_type &value);
   std::pair<iterator, bool> insert(const K &key, const V &obj);
-  std::pair<iterator, bool> insert_or_assign(const K &key, const V &obj);
+  iterator insert(iterator hint, const value_type &value);
+  template <typename... Args>
+  iterator emplace_hint(iterator hint, Args &&...args);
+  template <typename... Args>
+  std::pair<iterator, bool> emplace(Args &&...args);
+  template <typename... Args>
+  std::pair<iterator, bool> try_emplace(const K &key, Args &&...args);
+  template <typename... Args>
+  std::pair<iterator, bool> try_emplace(K &&key, Args &&...args);
+  template <typename M>
+  std::pair<iterator, bool> insert_or_assign(const K &key, M &&obj);
   template <typename... Args>
   std::vector<std::pair<iterator, bool>> insert_many(Args &&...args);
 
+  node_type extract(iterator pos);
+  node_type extract(const K &key);
+  insert_return_type insert(node_type &&node);
+
   iterator begin();
   iterator end();
 
-  class map_iter : public tree<K, V>::iter {
-    friend class map<K, V>;
+  template <typename Q = K>
+  iterator find(const Q &key);
+  template <typename Q = K>
+  size_type count(const Q &key);
+  template <typename Q = K>
+  iterator lower_bound(const Q &key);
+  template <typename Q = K>
+  iterator upper_bound(const Q &key);
+  template <typename Q = K>
+  std::pair<iterator, iterator> equal_range(const Q &key);
+
+  class map_iter : public tree<K, V, Compare, Allocator>::iter {
+    friend class map<K, V, Compare, Allocator>;
 
    public:
-    map_iter() : tree<K, V>::iter(){};
-    std::pair<K, V> &operator*();
+    map_iter() : tree<K, V, Compare, Allocator>::iter(){};
+    value_type &operator*();
   };
   class map_const_iter : public map_iter {
    public:
     map_const_iter() : map_iter(){};
-    const std::pair<K, V> operator*() const { return map_iter::operator*(); };
+    const value_type &operator*() const { return this->current->data; };
+  };
+  struct insert_return_type {
+    iterator position;
+    bool inserted;
+    node_type node;
   };
 };
 
+namespace pmr {
+template <typename K, typename V>
+using map = s21::map<K, V, std::less<K>,
+                     std::pmr::polymorphic_allocator<std::pair<const K, V>>>;
+}  // namespace pmr
+
 }  // namespace s21
 #include "map.tpp"
 #endif  // MAP_H
\ No newline at end of file
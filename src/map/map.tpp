@@ -1,99 +1,206 @@
 #include "map.h"
 namespace s21 {
 
-template <typename K, typename V>
-map<K, V>::map() {
+template <typename K, typename V, typename Compare, typename Allocator>
+map<K, V, Compare, Allocator>::map() {
   this->end_.left = this->root;
   this->end_.right = this->root;
 };
 
-template <typename K, typename V>
-map<K, V>::map(const std::initializer_list<value_type> &items) {
-  for (auto i = items.begin(); i != items.end(); ++i) {
-    insert(*i);
-  }
+template <typename K, typename V, typename Compare, typename Allocator>
+map<K, V, Compare, Allocator>::map(const Allocator &alloc)
+    : map(Compare(), alloc) {}
+
+template <typename K, typename V, typename Compare, typename Allocator>
+map<K, V, Compare, Allocator>::map(const Compare &comp, const Allocator &alloc)
+    : tree<K, V, Compare, Allocator>(comp, alloc) {
+  this->end_.left = this->root;
+  this->end_.right = this->root;
+}
+
+template <typename K, typename V, typename Compare, typename Allocator>
+map<K, V, Compare, Allocator>::map(
+    const std::initializer_list<value_type> &items, const Allocator &alloc)
+    : map(items.begin(), items.end(), Compare(), alloc) {}
+
+template <typename K, typename V, typename Compare, typename Allocator>
+map<K, V, Compare, Allocator>::map(
+    const std::initializer_list<value_type> &items, const Compare &comp,
+    const Allocator &alloc)
+    : map(items.begin(), items.end(), comp, alloc) {}
+
+template <typename K, typename V, typename Compare, typename Allocator>
+template <typename InputIt>
+map<K, V, Compare, Allocator>::map(InputIt first, InputIt last,
+                                   const Allocator &alloc)
+    : map(first, last, Compare(), alloc) {}
+
+template <typename K, typename V, typename Compare, typename Allocator>
+template <typename InputIt>
+map<K, V, Compare, Allocator>::map(InputIt first, InputIt last,
+                                   const Compare &comp, const Allocator &alloc)
+    : map(comp, alloc) {
+  assign_sorted(first, last);
 }
 
-template <typename K, typename V>
-map<K, V>::map(const map &m) {
-  this->copy(m);
+// Builds the tree in linear time while the input is sorted, see
+// tree::assign_sorted_.
+template <typename K, typename V, typename Compare, typename Allocator>
+template <typename InputIt>
+void map<K, V, Compare, Allocator>::assign_sorted(InputIt first, InputIt last) {
+  this->assign_sorted_(
+      first, last,
+      [](const auto &item) -> const auto & { return item.first; },
+      [](const auto &item) -> const auto & { return item.second; }, false);
 }
 
-template <typename K, typename V>
-map<K, V>::map(map &&other) {
-  this->root = other.root;
-  this->end_ = other.end_;
-  other.root = &other.end_;
-  other.end_.right = nullptr;
-  other.end_.left = nullptr;
-  other.end_.parent = nullptr;
-  other.end_.key = 0;
-  this->size_ = other.size_;
-  other.size_ = 0;
+template <typename K, typename V, typename Compare, typename Allocator>
+map<K, V, Compare, Allocator>::map(const map &m)
+    : tree<K, V, Compare, Allocator>(
+          m.key_comp(), std::allocator_traits<Allocator>::
+                            select_on_container_copy_construction(
+                                m.get_allocator())) {
+  this->copy(m, m.size_);
 }
 
-template <typename K, typename V>
-map<K, V>::~map() {
+template <typename K, typename V, typename Compare, typename Allocator>
+map<K, V, Compare, Allocator>::map(map &&other)
+    : tree<K, V, Compare, Allocator>(other.key_comp(), other.get_allocator()) {
+  this->attach_(other.detach_());
+  this->pool_.swap(other.pool_);
+}
+
+template <typename K, typename V, typename Compare, typename Allocator>
+map<K, V, Compare, Allocator>::~map() {
   this->clear();
 }
 
-template <typename K, typename V>
-V &map<K, V>::at(const K &key) {
-  typename tree<K, V>::Node *node = this->find_node(key);
+template <typename K, typename V, typename Compare, typename Allocator>
+template <typename Q>
+V &map<K, V, Compare, Allocator>::at(const Q &key) {
+  typename tree<K, V, Compare, Allocator>::Node *node = this->find_node(key);
   if (!node) throw std::out_of_range("Out of range");
-  return node->value;
-}
-template <typename K, typename V>
-V &map<K, V>::operator[](const K &key) {
-  typename tree<K, V>::Node *node = this->find_node(key);
-  if (!node || node == &this->end_) {
-    std::pair<iterator, bool> ib = insert(key, mappet_type());
-    node = ib.first.current;
-  }
-  return node->value;
+  return node->value();
+}
+template <typename K, typename V, typename Compare, typename Allocator>
+V &map<K, V, Compare, Allocator>::operator[](const K &key) {
+  return this->try_emplace_(key).first->value();
+}
+
+template <typename K, typename V, typename Compare, typename Allocator>
+V &map<K, V, Compare, Allocator>::operator[](K &&key) {
+  return this->try_emplace_(std::move(key)).first->value();
 }
 
-template <typename K, typename V>
-std::pair<typename map<K, V>::iterator, bool> map<K, V>::insert(const K &key,
-                                                                const V &obj) {
-  std::pair<typename tree<K, V>::Node *, bool> nb = this->insert_(key, obj);
+template <typename K, typename V, typename Compare, typename Allocator>
+std::pair<typename map<K, V, Compare, Allocator>::iterator, bool>
+map<K, V, Compare, Allocator>::insert(const K &key, const V &obj) {
+  std::pair<typename tree<K, V, Compare, Allocator>::Node *, bool> nb =
+      this->insert_(key, obj);
   std::pair<iterator, bool> res;
   res.first.end = &(this->end_);
   res.first.current = nb.first;
-  res.first.next = res.first.Forw(res.first.current);
-  res.first.cur_value =
-      std::make_pair(res.first.current->key, res.first.current->value);
   res.second = nb.second;
   return res;
 }
-template <typename K, typename V>
-std::pair<typename map<K, V>::iterator, bool> map<K, V>::insert(
-    const value_type &value) {
+template <typename K, typename V, typename Compare, typename Allocator>
+std::pair<typename map<K, V, Compare, Allocator>::iterator, bool>
+map<K, V, Compare, Allocator>::insert(const value_type &value) {
   return insert(value.first, value.second);
 }
 
-template <typename K, typename V>
-std::pair<typename map<K, V>::iterator, bool> map<K, V>::insert_or_assign(
-    const K &key, const V &obj) {
-  typename tree<K, V>::Node *node = this->find_node(key);
-  std::pair<iterator, bool> res;
-  if (node && node != &this->end_) {
-    node->value = obj;
-    res.first.end = &(this->end_);
-    res.first.current = node;
-    res.first.next = res.first.Forw(res.first.current);
-    res.first.cur_value =
-        std::make_pair(res.first.current->key, res.first.current->value);
-    res.second = 0;
-  } else
-    res = insert(key, obj);
+// O(1) amortized when value belongs right next to hint, see
+// tree::insert_hint_.
+template <typename K, typename V, typename Compare, typename Allocator>
+typename map<K, V, Compare, Allocator>::iterator
+map<K, V, Compare, Allocator>::insert(iterator hint, const value_type &value) {
+  return this->template make_iter_<iterator>(
+      this->insert_hint_(hint.current, value.first, value.second).first);
+}
 
-  return res;
+template <typename K, typename V, typename Compare, typename Allocator>
+template <typename... Args>
+typename map<K, V, Compare, Allocator>::iterator
+map<K, V, Compare, Allocator>::emplace_hint(iterator hint, Args &&...args) {
+  return this->template make_iter_<iterator>(
+      this->emplace_hint_(hint.current, std::forward<Args>(args)...).first);
+}
+
+// Unlinks the element without freeing or copying it, see
+// tree::node_handle. An empty handle when there is none.
+template <typename K, typename V, typename Compare, typename Allocator>
+typename map<K, V, Compare, Allocator>::node_type
+map<K, V, Compare, Allocator>::extract(iterator pos) {
+  return this->extract_(pos.current);
+}
+
+template <typename K, typename V, typename Compare, typename Allocator>
+typename map<K, V, Compare, Allocator>::node_type
+map<K, V, Compare, Allocator>::extract(const K &key) {
+  return this->extract_(this->find_node(key));
 }
-template <typename K, typename V>
+
+// A node of this map is relinked without allocating, one of another map
+// hands over its key and value, see tree::splice_. On an equal key the
+// node comes back in the result.
+template <typename K, typename V, typename Compare, typename Allocator>
+typename map<K, V, Compare, Allocator>::insert_return_type
+map<K, V, Compare, Allocator>::insert(node_type &&node) {
+  auto nb = this->insert_handle_(node, false);
+  return {this->template make_iter_<iterator>(nb.first), nb.second,
+          std::move(node)};
+}
+
+// Builds the pair in a new node, which goes back to the pool when the key
+// is already there.
+template <typename K, typename V, typename Compare, typename Allocator>
+template <typename... Args>
+std::pair<typename map<K, V, Compare, Allocator>::iterator, bool>
+map<K, V, Compare, Allocator>::emplace(Args &&...args) {
+  auto nb = this->emplace_(std::forward<Args>(args)...);
+  return std::make_pair(this->template make_iter_<iterator>(nb.first),
+                        nb.second);
+}
+
+// The value is built from args only when key is missing, see
+// tree::try_emplace_.
+template <typename K, typename V, typename Compare, typename Allocator>
 template <typename... Args>
-std::vector<std::pair<typename map<K, V>::iterator, bool>>
-map<K, V>::insert_many(Args &&...args) {
+std::pair<typename map<K, V, Compare, Allocator>::iterator, bool>
+map<K, V, Compare, Allocator>::try_emplace(const K &key, Args &&...args) {
+  auto nb = this->try_emplace_(key, std::forward<Args>(args)...);
+  return std::make_pair(this->template make_iter_<iterator>(nb.first),
+                        nb.second);
+}
+
+template <typename K, typename V, typename Compare, typename Allocator>
+template <typename... Args>
+std::pair<typename map<K, V, Compare, Allocator>::iterator, bool>
+map<K, V, Compare, Allocator>::try_emplace(K &&key, Args &&...args) {
+  auto nb = this->try_emplace_(std::move(key), std::forward<Args>(args)...);
+  return std::make_pair(this->template make_iter_<iterator>(nb.first),
+                        nb.second);
+}
+
+template <typename K, typename V, typename Compare, typename Allocator>
+template <typename M>
+std::pair<typename map<K, V, Compare, Allocator>::iterator, bool>
+map<K, V, Compare, Allocator>::insert_or_assign(const K &key, M &&obj) {
+  typename tree<K, V, Compare, Allocator>::Node *parent;
+  typename tree<K, V, Compare, Allocator>::Node **link;
+  auto *node = this->find_slot_(key, parent, link);
+  bool inserted = !node;
+  if (node)
+    node->value() = std::forward<M>(obj);
+  else
+    node = this->link_node_(parent, link,
+                            this->new_node(key, std::forward<M>(obj)));
+  return std::make_pair(this->template make_iter_<iterator>(node), inserted);
+}
+template <typename K, typename V, typename Compare, typename Allocator>
+template <typename... Args>
+std::vector<std::pair<typename map<K, V, Compare, Allocator>::iterator, bool>>
+map<K, V, Compare, Allocator>::insert_many(Args &&...args) {
   std::vector<std::pair<iterator, bool>> res;
   for (const auto &arg : {args...}) {
     res.push_back(insert(arg));
@@ -101,29 +208,64 @@ map<K, V>::insert_many(Args &&...args) {
   return res;
 }
 
-template <typename K, typename V>
-typename map<K, V>::iterator map<K, V>::begin() {
+template <typename K, typename V, typename Compare, typename Allocator>
+typename map<K, V, Compare, Allocator>::iterator
+map<K, V, Compare, Allocator>::begin() {
   iterator a;
   a.end = &(this->end_);
   a.current = this->end_.right;
-  a.next = a.Forw(a.current);
-  a.cur_value = std::make_pair(a.current->key, a.current->value);
   return a;
 }
 
-template <typename K, typename V>
-typename map<K, V>::iterator map<K, V>::end() {
+template <typename K, typename V, typename Compare, typename Allocator>
+typename map<K, V, Compare, Allocator>::iterator
+map<K, V, Compare, Allocator>::end() {
   iterator a;
   a.end = &(this->end_);
   a.current = &(this->end_);
-  a.next = a.Forw(a.current);
-  a.cur_value = std::make_pair(a.current->key, a.current->value);
   return a;
 }
 
-template <typename K, typename V>
-std::pair<K, V> &map<K, V>::iterator::operator*() {
-  return this->cur_value;
+template <typename K, typename V, typename Compare, typename Allocator>
+template <typename Q>
+typename map<K, V, Compare, Allocator>::iterator
+map<K, V, Compare, Allocator>::find(const Q &key) {
+  typename tree<K, V, Compare, Allocator>::Node *node = this->find_node(key);
+  return this->template make_iter_<iterator>(node ? node : &this->end_);
+}
+
+template <typename K, typename V, typename Compare, typename Allocator>
+template <typename Q>
+size_t map<K, V, Compare, Allocator>::count(const Q &key) {
+  return this->contains(key);
+}
+
+template <typename K, typename V, typename Compare, typename Allocator>
+template <typename Q>
+typename map<K, V, Compare, Allocator>::iterator
+map<K, V, Compare, Allocator>::lower_bound(const Q &key) {
+  return this->template make_iter_<iterator>(this->lower_bound_(key));
+}
+
+template <typename K, typename V, typename Compare, typename Allocator>
+template <typename Q>
+typename map<K, V, Compare, Allocator>::iterator
+map<K, V, Compare, Allocator>::upper_bound(const Q &key) {
+  return this->template make_iter_<iterator>(this->upper_bound_(key));
+}
+
+template <typename K, typename V, typename Compare, typename Allocator>
+template <typename Q>
+std::pair<typename map<K, V, Compare, Allocator>::iterator,
+          typename map<K, V, Compare, Allocator>::iterator>
+map<K, V, Compare, Allocator>::equal_range(const Q &key) {
+  return std::make_pair(lower_bound(key), upper_bound(key));
+}
+
+template <typename K, typename V, typename Compare, typename Allocator>
+typename map<K, V, Compare, Allocator>::value_type &
+map<K, V, Compare, Allocator>::iterator::operator*() {
+  return this->current->data;
 }
 
 }  // namespace s21
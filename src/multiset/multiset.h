@@ -1,10 +1,13 @@
 #ifndef MULTISET_H
 #define MULTISET_H
+#include <memory_resource>
+
 #include "../tree/tree.h"
 
 namespace s21 {
-template <typename K>
-class multiset : protected tree<K, K> {
+template <typename K, typename Compare = std::less<K>,
+          typename Allocator = std::allocator<K>>
+class multiset : protected tree<K, K, Compare, Allocator> {
  public:
   class multiset_iter;
   class multiset_const_iter;
@@ -15,58 +18,104 @@ class multiset : protected tree<K, K> {
   using iterator = multiset_iter;
   using const_iterator = multiset_const_iter;
   using size_type = size_t;
+  using allocator_type = Allocator;
+  using key_compare = Compare;
+  using node_type = typename tree<K, K, Compare, Allocator>::node_handle;
 
   multiset();
-  multiset(std::initializer_list<value_type> const &items);
+  explicit multiset(const Allocator &alloc);
+  explicit multiset(const Compare &comp,
+                    const Allocator &alloc = Allocator());
+  multiset(std::initializer_list<value_type> const &items,
+           const Allocator &alloc = Allocator());
+  multiset(std::initializer_list<value_type> const &items,
+           const Compare &comp,
+           const Allocator &alloc = Allocator());
+  template <typename InputIt>
+  multiset(InputIt first, InputIt last, const Allocator &alloc = Allocator());
+  template <typename InputIt>
+  multiset(InputIt first, InputIt last, const Compare &comp,
+           const Allocator &alloc = Allocator());
   multiset(const multiset &s);
   multiset(multiset &&s);
   ~multiset();
 
-  using tree<K, K>::contains;
-  using tree<K, K>::clear;
-  using tree<K, K>::empty;
-  using tree<K, K>::size;
-  using tree<K, K>::max_size;
-  using tree<K, K>::operator=;
+  template <typename InputIt>
+  void assign_sorted(InputIt first, InputIt last);
+
+  using tree<K, K, Compare, Allocator>::contains;
+  using tree<K, K, Compare, Allocator>::clear;
+  using tree<K, K, Compare, Allocator>::empty;
+  using tree<K, K, Compare, Allocator>::size;
+  using tree<K, K, Compare, Allocator>::max_size;
+  using tree<K, K, Compare, Allocator>::get_allocator;
+  using tree<K, K, Compare, Allocator>::key_comp;
+  using tree<K, K, Compare, Allocator>::operator=;
+  using tree<K, K, Compare, Allocator>::rank;
+  using tree<K, K, Compare, Allocator>::count_range;
 
   iterator insert(const K &key);
+  iterator insert(iterator hint, const K &key);
+  iterator insert(const K &key, size_type n);
+  template <typename... Args>
+  iterator emplace_hint(iterator hint, Args &&...args);
   template <typename... Args>
   std::vector<iterator> insert_many(Args &&...args);
 
+  node_type extract(iterator pos);
+  node_type extract(const K &key);
+  iterator insert(node_type &&node);
+
   void erase(iterator pos);
+  size_type erase(const K &key, size_type n);
+  size_type erase_all(const K &key);
   void swap(multiset &other);
   void merge(multiset &other);
 
   iterator begin();
   iterator end();
 
-  size_type count(const K &key);
-  iterator find(const K &key);
-  std::pair<iterator, iterator> equal_range(const K &key);
-  iterator lower_bound(const K &key);
-  iterator upper_bound(const K &key);
+  template <typename Q = K>
+  size_type count(const Q &key);
+  template <typename Q = K>
+  iterator find(const Q &key);
+  template <typename Q = K>
+  std::pair<iterator, iterator> equal_range(const Q &key);
+  template <typename Q = K>
+  iterator lower_bound(const Q &key);
+  template <typename Q = K>
+  iterator upper_bound(const Q &key);
+  iterator nth(size_type k);
 
-  class multiset_iter : protected tree<K, K>::iter {
-    friend class multiset<K>;
+  class multiset_iter : protected tree<K, K, Compare, Allocator>::iter {
+    friend class multiset<K, Compare, Allocator>;
+    friend class tree<K, K, Compare, Allocator>;
 
    public:
-    multiset_iter() : tree<K, K>::iter(), current_duplicate(0){};
+    multiset_iter()
+        : tree<K, K, Compare, Allocator>::iter(), current_duplicate(0){};
     iterator &operator++();
     iterator &operator--();
     bool operator==(const iterator &it);
     bool operator!=(const iterator &it);
-    K &operator*();
+    const K &operator*();
 
    private:
-    unsigned int current_duplicate;
+    size_t current_duplicate;
   };
   class multiset_const_iter : public multiset_iter {
    public:
     multiset_const_iter() : multiset_iter(){};
-    const K operator*() const { return multiset_iter::operator*(); };
+    const K &operator*() const { return this->current->key(); };
   };
 };
 
+namespace pmr {
+template <typename K>
+using multiset =
+    s21::multiset<K, std::less<K>, std::pmr::polymorphic_allocator<K>>;
+}  // namespace pmr
+
 }  // namespace s21
 
 #include "multiset.tpp"
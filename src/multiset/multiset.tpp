@@ -1,60 +1,136 @@
 #include "multiset.h"
 
 namespace s21 {
-template <typename K>
-multiset<K>::multiset() {
+template <typename K, typename Compare, typename Allocator>
+multiset<K, Compare, Allocator>::multiset() {
   this->end_.left = this->root;
   this->end_.right = this->root;
 };
 
-template <typename K>
-multiset<K>::multiset(const std::initializer_list<value_type> &items) {
-  for (auto i = items.begin(); i != items.end(); ++i) {
-    insert(*i);
-  }
+template <typename K, typename Compare, typename Allocator>
+multiset<K, Compare, Allocator>::multiset(const Allocator &alloc)
+    : multiset(Compare(), alloc) {}
+
+template <typename K, typename Compare, typename Allocator>
+multiset<K, Compare, Allocator>::multiset(const Compare &comp,
+                                          const Allocator &alloc)
+    : tree<K, K, Compare, Allocator>(comp, alloc) {
+  this->end_.left = this->root;
+  this->end_.right = this->root;
+}
+
+template <typename K, typename Compare, typename Allocator>
+multiset<K, Compare, Allocator>::multiset(
+    const std::initializer_list<value_type> &items, const Allocator &alloc)
+    : multiset(items.begin(), items.end(), Compare(), alloc) {}
+
+template <typename K, typename Compare, typename Allocator>
+multiset<K, Compare, Allocator>::multiset(
+    const std::initializer_list<value_type> &items, const Compare &comp,
+    const Allocator &alloc)
+    : multiset(items.begin(), items.end(), comp, alloc) {}
+
+template <typename K, typename Compare, typename Allocator>
+template <typename InputIt>
+multiset<K, Compare, Allocator>::multiset(InputIt first, InputIt last,
+                                          const Allocator &alloc)
+    : multiset(first, last, Compare(), alloc) {}
+
+template <typename K, typename Compare, typename Allocator>
+template <typename InputIt>
+multiset<K, Compare, Allocator>::multiset(InputIt first, InputIt last,
+                                          const Compare &comp,
+                                          const Allocator &alloc)
+    : multiset(comp, alloc) {
+  assign_sorted(first, last);
+}
+
+// Builds the tree in linear time while the input is sorted, see
+// tree::assign_sorted_.
+template <typename K, typename Compare, typename Allocator>
+template <typename InputIt>
+void multiset<K, Compare, Allocator>::assign_sorted(InputIt first,
+                                                    InputIt last) {
+  this->assign_sorted_(
+      first, last, [](const auto &item) -> const auto & { return item; },
+      [](const auto &item) -> const auto & { return item; }, true);
 }
 
-template <typename K>
-multiset<K>::multiset(const multiset &m) {
-  this->copy(m);
+template <typename K, typename Compare, typename Allocator>
+multiset<K, Compare, Allocator>::multiset(const multiset &m)
+    : tree<K, K, Compare, Allocator>(
+          m.key_comp(), std::allocator_traits<Allocator>::
+                            select_on_container_copy_construction(
+                                m.get_allocator())) {
+  this->copy(m, m.nodes_());
 }
 
-template <typename K>
-multiset<K>::multiset(multiset &&other) {
-  this->root = other.root;
-  this->end_ = other.end_;
-  other.root = &other.end_;
-  other.end_.right = other.root;
-  other.end_.left = other.root;
-  other.end_.parent = other.root;
-  other.end_.key = 0;
-  this->root->parent = &this->end_;
-  this->size_ = other.size_;
-  other.size_ = 0;
+template <typename K, typename Compare, typename Allocator>
+multiset<K, Compare, Allocator>::multiset(multiset &&other)
+    : tree<K, K, Compare, Allocator>(other.key_comp(), other.get_allocator()) {
+  this->attach_(other.detach_());
+  this->pool_.swap(other.pool_);
 }
 
-template <typename K>
-multiset<K>::~multiset() {
+template <typename K, typename Compare, typename Allocator>
+multiset<K, Compare, Allocator>::~multiset() {
   this->clear();
 }
 
-template <typename K>
-typename multiset<K>::iterator multiset<K>::insert(const K &key) {
-  std::pair<typename tree<K, K>::Node *, bool> nb = this->insert_(key, key);
-  if (!nb.second) this->size_++;
+template <typename K, typename Compare, typename Allocator>
+typename multiset<K, Compare, Allocator>::iterator
+multiset<K, Compare, Allocator>::insert(const K &key) {
+  std::pair<typename tree<K, K, Compare, Allocator>::Node *, bool> nb =
+      this->insert_(key, key);
+  if (!nb.second) this->add_duplicate_(nb.first);
+  iterator res;
+  res.end = &(this->end_);
+  res.current = nb.first;
+  res.current_duplicate = res.current->duplicates;
+  return res;
+}
+
+// Adds n copies in O(log n) whatever n is. The result points at the last
+// copy, or is end() when n is 0 and key is missing.
+template <typename K, typename Compare, typename Allocator>
+typename multiset<K, Compare, Allocator>::iterator
+multiset<K, Compare, Allocator>::insert(const K &key, size_type n) {
+  if (!n) return find(key);
+  std::pair<typename tree<K, K, Compare, Allocator>::Node *, bool> nb =
+      this->insert_(key, key);
+  this->add_duplicate_(nb.first, n - nb.second);
+  iterator res = this->template make_iter_<iterator>(nb.first);
+  res.current_duplicate = res.current->duplicates;
+  return res;
+}
+
+// O(1) amortized when key belongs next to hint or is equal to it or to a
+// neighbour, see tree::insert_hint_.
+template <typename K, typename Compare, typename Allocator>
+typename multiset<K, Compare, Allocator>::iterator
+multiset<K, Compare, Allocator>::insert(iterator hint, const K &key) {
+  std::pair<typename tree<K, K, Compare, Allocator>::Node *, bool> nb =
+      this->insert_hint_(hint.current, key, key);
+  if (!nb.second) this->add_duplicate_(nb.first);
   iterator res;
   res.end = &(this->end_);
   res.current = nb.first;
-  res.next = res.Forw(res.current);
   res.current_duplicate = res.current->duplicates;
-  res.cur_value = std::make_pair(res.current->key, res.current->value);
   return res;
 }
 
-template <typename K>
+template <typename K, typename Compare, typename Allocator>
+template <typename... Args>
+typename multiset<K, Compare, Allocator>::iterator
+multiset<K, Compare, Allocator>::emplace_hint(iterator hint, Args &&...args) {
+  K key(std::forward<Args>(args)...);
+  return insert(hint, key);
+}
+
+template <typename K, typename Compare, typename Allocator>
 template <typename... Args>
-std::vector<typename multiset<K>::iterator> multiset<K>::insert_many(
-    Args &&...args) {
+std::vector<typename multiset<K, Compare, Allocator>::iterator>
+multiset<K, Compare, Allocator>::insert_many(Args &&...args) {
   std::vector<iterator> res;
   for (const auto &arg : {args...}) {
     res.push_back(insert(arg));
@@ -62,128 +138,173 @@ std::vector<typename multiset<K>::iterator> multiset<K>::insert_many(
   return res;
 }
 
-template <typename K>
-void multiset<K>::erase(iterator pos) {
+// A node holds every copy of its key, so the handle takes them all, see
+// tree::node_handle.
+template <typename K, typename Compare, typename Allocator>
+typename multiset<K, Compare, Allocator>::node_type
+multiset<K, Compare, Allocator>::extract(iterator pos) {
+  return this->extract_(pos.current);
+}
+
+template <typename K, typename Compare, typename Allocator>
+typename multiset<K, Compare, Allocator>::node_type
+multiset<K, Compare, Allocator>::extract(const K &key) {
+  return this->extract_(this->find_node(key));
+}
+
+// The copies of an equal key grow by the count of the node, which is
+// freed then, see tree::splice_.
+template <typename K, typename Compare, typename Allocator>
+typename multiset<K, Compare, Allocator>::iterator
+multiset<K, Compare, Allocator>::insert(node_type &&node) {
+  iterator res = this->template make_iter_<iterator>(
+      this->insert_handle_(node, true).first);
+  if (res.current != res.end) res.current_duplicate = res.current->duplicates;
+  return res;
+}
+
+template <typename K, typename Compare, typename Allocator>
+void multiset<K, Compare, Allocator>::erase(iterator pos) {
   if (pos.current == pos.end) throw std::out_of_range("Out of range");
-  typename tree<K, K>::Node *node =
-      this->find_node(pos.cur_value.first);  // итератор *
-  if (node && node->duplicates > 0) {
-    node->duplicates--;
-    this->size_--;
-  } else {
-    this->erase_(pos.cur_value.first);
-    pos.current = pos.Back(pos.next);
+  if (pos.current->duplicates > 0)
+    this->remove_duplicate_(pos.current);
+  else
+    this->erase_node_(pos.current);
+}
+// Removes up to n copies of key in O(log n) and returns how many went.
+template <typename K, typename Compare, typename Allocator>
+typename multiset<K, Compare, Allocator>::size_type
+multiset<K, Compare, Allocator>::erase(const K &key, size_type n) {
+  typename tree<K, K, Compare, Allocator>::Node *node = this->find_node(key);
+  if (!node || node == &this->end_ || !n) return 0;
+  if (n <= node->duplicates) {
+    this->remove_duplicate_(node, n);
+    return n;
   }
+  size_type res = node->duplicates + 1;
+  this->erase_node_(node);
+  return res;
+}
+
+template <typename K, typename Compare, typename Allocator>
+typename multiset<K, Compare, Allocator>::size_type
+multiset<K, Compare, Allocator>::erase_all(const K &key) {
+  return erase(key, std::numeric_limits<size_type>::max());
+}
+
+template <typename K, typename Compare, typename Allocator>
+void multiset<K, Compare, Allocator>::swap(multiset &other) {
+  tree<K, K, Compare, Allocator>::swap(other);
+}
+template <typename K, typename Compare, typename Allocator>
+void multiset<K, Compare, Allocator>::merge(multiset &other) {
+  this->merge_(other, true);
 }
-template <typename K>
-void multiset<K>::swap(multiset &other) {
-  std::swap(this->root, other.root);
-  std::swap(this->end_, other.end_);
-  std::swap(this->size_, other.size_);
-  this->root->parent = &(this->end_);
-  other.root->parent = &(other.end_);
-}
-template <typename K>
-void multiset<K>::merge(multiset &other) {
-  for (auto i = other.begin(); i != other.end(); ++i) insert(*i);
-  other.clear();
-}
-template <typename K>
-typename multiset<K>::iterator multiset<K>::begin() {
+template <typename K, typename Compare, typename Allocator>
+typename multiset<K, Compare, Allocator>::iterator
+multiset<K, Compare, Allocator>::begin() {
   iterator a;
   a.end = &(this->end_);
   a.current = this->end_.right;
-  a.next = a.Forw(a.current);
-  a.cur_value = std::make_pair(a.current->key, a.current->value);
   return a;
 }
-template <typename K>
-typename multiset<K>::iterator multiset<K>::end() {
+template <typename K, typename Compare, typename Allocator>
+typename multiset<K, Compare, Allocator>::iterator
+multiset<K, Compare, Allocator>::end() {
   iterator a;
   a.end = &(this->end_);
   a.current = &(this->end_);
-  a.next = a.Forw(a.current);
-  a.cur_value = std::make_pair(a.current->key, a.current->value);
   return a;
 }
-template <typename K>
-size_t multiset<K>::count(const K &key) {
-  typename tree<K, K>::Node *node = this->find_node(key);
+template <typename K, typename Compare, typename Allocator>
+template <typename Q>
+size_t multiset<K, Compare, Allocator>::count(const Q &key) {
+  typename tree<K, K, Compare, Allocator>::Node *node = this->find_node(key);
   if (!node || node == &this->end_) return 0;
   return node->duplicates + 1;
 }
 
-template <typename K>
-typename multiset<K>::iterator multiset<K>::find(const K &key) {
+template <typename K, typename Compare, typename Allocator>
+template <typename Q>
+typename multiset<K, Compare, Allocator>::iterator
+multiset<K, Compare, Allocator>::find(const Q &key) {
   iterator a;
   a.end = &this->end_;
   a.current = this->find_node(key);
   if (a.current == nullptr) a.current = &this->end_;
-  a.next = a.Forw(a.current);
-  a.cur_value = std::make_pair(a.current->key, a.current->value);
   a.current_duplicate = 0;
   return a;
 }
-template <typename K>
-std::pair<typename multiset<K>::iterator, typename multiset<K>::iterator>
-multiset<K>::equal_range(const K &key) {
+template <typename K, typename Compare, typename Allocator>
+template <typename Q>
+std::pair<typename multiset<K, Compare, Allocator>::iterator,
+          typename multiset<K, Compare, Allocator>::iterator>
+multiset<K, Compare, Allocator>::equal_range(const Q &key) {
   return std::make_pair(lower_bound(key), upper_bound(key));
 }
 
-template <typename K>
-typename multiset<K>::iterator multiset<K>::lower_bound(const K &key) {
-  for (auto i = begin(); i != end(); ++i)
-    if (*i >= key) return i;
-  return end();
+template <typename K, typename Compare, typename Allocator>
+template <typename Q>
+typename multiset<K, Compare, Allocator>::iterator
+multiset<K, Compare, Allocator>::lower_bound(const Q &key) {
+  return this->template make_iter_<iterator>(this->lower_bound_(key));
 }
 
-template <typename K>
-typename multiset<K>::iterator multiset<K>::upper_bound(const K &key) {
-  for (auto i = begin(); i != end(); ++i)
-    if (*i > key) return i;
-  return end();
+template <typename K, typename Compare, typename Allocator>
+template <typename Q>
+typename multiset<K, Compare, Allocator>::iterator
+multiset<K, Compare, Allocator>::upper_bound(const Q &key) {
+  return this->template make_iter_<iterator>(this->upper_bound_(key));
+}
+
+// k-th smallest element counting duplicates, end() when k >= size().
+template <typename K, typename Compare, typename Allocator>
+typename multiset<K, Compare, Allocator>::iterator
+multiset<K, Compare, Allocator>::nth(size_type k) {
+  auto found = this->nth_(k);
+  iterator res = this->template make_iter_<iterator>(found.first);
+  res.current_duplicate = found.second;
+  return res;
 }
 
-template <typename K>
-typename multiset<K>::iterator &multiset<K>::iterator::operator++() {
+template <typename K, typename Compare, typename Allocator>
+typename multiset<K, Compare, Allocator>::iterator &
+multiset<K, Compare, Allocator>::iterator::operator++() {
   if (current_duplicate < this->current->duplicates)
     current_duplicate++;
   else {
-    this->current = this->next;
-    this->next = this->Forw(this->next);
-    this->cur_value = std::make_pair(this->current->key, this->current->value);
+    this->current = this->Forw(this->current);
     current_duplicate = 0;
   }
   return *this;
 }
-template <typename K>
-typename multiset<K>::iterator &multiset<K>::iterator::operator--() {
+template <typename K, typename Compare, typename Allocator>
+typename multiset<K, Compare, Allocator>::iterator &
+multiset<K, Compare, Allocator>::iterator::operator--() {
   if (current_duplicate > 0)
     current_duplicate--;
   else {
-    this->next = this->current;
     this->current = this->Back(this->current);
-    this->cur_value = std::make_pair(this->current->key, this->current->value);
     current_duplicate = this->current->duplicates;
   }
   return *this;
 }
 
-template <typename K>
-bool multiset<K>::iterator::operator==(const iterator &it) {
+template <typename K, typename Compare, typename Allocator>
+bool multiset<K, Compare, Allocator>::iterator::operator==(const iterator &it) {
   return (this->current == it.current &&
           this->current_duplicate == it.current_duplicate);
 }
 
-template <typename K>
-bool multiset<K>::iterator::operator!=(const iterator &it) {
+template <typename K, typename Compare, typename Allocator>
+bool multiset<K, Compare, Allocator>::iterator::operator!=(const iterator &it) {
   return !(this->current == it.current &&
            this->current_duplicate == it.current_duplicate);
 }
 
-template <typename K>
-K &multiset<K>::iterator::operator*() {
-  return this->cur_value.first;
+template <typename K, typename Compare, typename Allocator>
+const K &multiset<K, Compare, Allocator>::iterator::operator*() {
+  return this->current->key();
 }
 
 }  // namespace s21
@@ -0,0 +1,157 @@
+#ifndef PERSISTENT_MAP_H
+#define PERSISTENT_MAP_H
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+namespace s21 {
+// Ordered map whose versions share structure. A copy or snapshot() takes
+// O(1): it shares the root and bumps its reference count. An update copies
+// the nodes on its path that another version still references, O(log n)
+// of them, and changes the nodes this map owns alone in place. Shared
+// nodes are never written, so another thread may read a snapshot while
+// this map changes, and no side waits for the other.
+template <typename K, typename V, typename Compare = std::less<K>,
+          typename Allocator = std::allocator<std::pair<const K, V>>>
+class persistent_map {
+  struct node;
+  // An AVL tree this tall has more than 10^13 nodes.
+  static constexpr int kMaxHeight = 64;
+
+ public:
+  class iterator;
+  using key_type = K;
+  using mapped_type = V;
+  using value_type = std::pair<const K, V>;
+  using reference = const value_type &;
+  using const_reference = const value_type &;
+  using const_iterator = iterator;
+  using size_type = size_t;
+  using key_compare = Compare;
+  using allocator_type = Allocator;
+
+  persistent_map() : persistent_map(Compare()){};
+  explicit persistent_map(const Allocator &alloc)
+      : persistent_map(Compare(), alloc){};
+  explicit persistent_map(const Compare &comp,
+                          const Allocator &alloc = Allocator());
+  persistent_map(std::initializer_list<value_type> const &items,
+                 const Compare &comp = Compare(),
+                 const Allocator &alloc = Allocator());
+  template <typename InputIt>
+  persistent_map(InputIt first, InputIt last, const Compare &comp = Compare(),
+                 const Allocator &alloc = Allocator());
+  persistent_map(const persistent_map &m);
+  persistent_map(persistent_map &&m);
+  persistent_map &operator=(const persistent_map &m);
+  persistent_map &operator=(persistent_map &&m);
+  ~persistent_map();
+
+  // The current version, later updates of this map leave it as it is.
+  persistent_map snapshot() const { return *this; };
+
+  allocator_type get_allocator() const { return allocator_type(alloc_); };
+  key_compare key_comp() const { return comp_; };
+
+  const V &at(const K &key) const;
+
+  iterator begin() const;
+  iterator end() const;
+
+  bool empty() const { return size_ == 0; };
+  size_type size() const { return size_; };
+  size_type max_size() const;
+
+  void clear();
+  void swap(persistent_map &other);
+  bool insert(const value_type &value);
+  bool insert(const K &key, const V &obj);
+  bool insert_or_assign(const K &key, const V &obj);
+  void erase(iterator pos);
+  size_type erase(const K &key);
+
+  iterator find(const K &key) const;
+  bool contains(const K &key) const;
+  size_type count(const K &key) const { return contains(key); };
+  iterator lower_bound(const K &key) const;
+  iterator upper_bound(const K &key) const;
+
+  // Nodes have no parent links, they may sit in several versions, so the
+  // iterator keeps its path from the root. Updates of the map invalidate
+  // it, those of other versions do not.
+  class iterator {
+    friend class persistent_map;
+
+   public:
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type = std::pair<const K, V>;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const value_type *;
+    using reference = const value_type &;
+
+    iterator() = default;
+    reference operator*() const { return path_[depth_ - 1]->data; };
+    pointer operator->() const { return &path_[depth_ - 1]->data; };
+    iterator &operator++();
+    iterator &operator--();
+    bool operator==(const iterator &it) const {
+      return current_() == it.current_();
+    };
+    bool operator!=(const iterator &it) const { return !(*this == it); };
+
+   private:
+    explicit iterator(const node *root) : root_(root){};
+    const node *current_() const {
+      return depth_ ? path_[depth_ - 1] : nullptr;
+    };
+    void push_min_(const node *n);
+    void push_max_(const node *n);
+
+    const node *root_ = nullptr;
+    const node *path_[kMaxHeight] = {};
+    int depth_ = 0;
+  };
+
+ private:
+  struct node {
+    node(const K &key, const V &obj) : data(key, obj){};
+    std::pair<const K, V> data;
+    node *left = nullptr;
+    node *right = nullptr;
+    int height = 1;
+    // Links from parents and version roots.
+    std::atomic<size_t> refs{1};
+  };
+  using node_allocator =
+      typename std::allocator_traits<Allocator>::template rebind_alloc<node>;
+  using node_traits = std::allocator_traits<node_allocator>;
+
+  node *make_node_(const K &key, const V &obj);
+  static node *share_(node *n);
+  void release_(node *n);
+  void own_(node *&link);
+
+  static int height_(const node *n) { return n ? n->height : 0; };
+  static void update_(node *n);
+  void rotate_left_(node *&link);
+  void rotate_right_(node *&link);
+  void balance_(node *&link);
+
+  bool insert_(const K &key, const V &obj, bool assign);
+  void erase_(node *&link, const K &key);
+  node *take_min_(node *&link);
+
+  Compare comp_;
+  node_allocator alloc_;
+  node *root_ = nullptr;
+  size_type size_ = 0;
+};
+}  // namespace s21
+
+#include "persistent_map.tpp"
+#endif  // PERSISTENT_MAP_H
@@ -0,0 +1,438 @@
+#include "persistent_map.h"
+namespace s21 {
+
+template <typename K, typename V, typename Compare, typename Allocator>
+persistent_map<K, V, Compare, Allocator>::persistent_map(const Compare &comp,
+                                                         const Allocator &alloc)
+    : comp_(comp), alloc_(alloc) {}
+
+template <typename K, typename V, typename Compare, typename Allocator>
+persistent_map<K, V, Compare, Allocator>::persistent_map(
+    std::initializer_list<value_type> const &items, const Compare &comp,
+    const Allocator &alloc)
+    : persistent_map(items.begin(), items.end(), comp, alloc) {}
+
+template <typename K, typename V, typename Compare, typename Allocator>
+template <typename InputIt>
+persistent_map<K, V, Compare, Allocator>::persistent_map(InputIt first,
+                                                         InputIt last,
+                                                         const Compare &comp,
+                                                         const Allocator &alloc)
+    : persistent_map(comp, alloc) {
+  for (; first != last; ++first) insert(*first);
+}
+
+template <typename K, typename V, typename Compare, typename Allocator>
+persistent_map<K, V, Compare, Allocator>::persistent_map(
+    const persistent_map &m)
+    : comp_(m.comp_),
+      alloc_(node_traits::select_on_container_copy_construction(m.alloc_)),
+      root_(share_(m.root_)),
+      size_(m.size_) {}
+
+template <typename K, typename V, typename Compare, typename Allocator>
+persistent_map<K, V, Compare, Allocator>::persistent_map(persistent_map &&m)
+    : comp_(m.comp_), alloc_(m.alloc_), root_(m.root_), size_(m.size_) {
+  m.root_ = nullptr;
+  m.size_ = 0;
+}
+
+// Nodes shared with m may be freed through this map, so the allocator
+// always follows them.
+template <typename K, typename V, typename Compare, typename Allocator>
+persistent_map<K, V, Compare, Allocator> &
+persistent_map<K, V, Compare, Allocator>::operator=(const persistent_map &m) {
+  if (this != &m) {
+    node *root = share_(m.root_);
+    release_(root_);
+    comp_ = m.comp_;
+    alloc_ = m.alloc_;
+    root_ = root;
+    size_ = m.size_;
+  }
+  return *this;
+}
+
+template <typename K, typename V, typename Compare, typename Allocator>
+persistent_map<K, V, Compare, Allocator> &
+persistent_map<K, V, Compare, Allocator>::operator=(persistent_map &&m) {
+  if (this != &m) {
+    clear();
+    swap(m);
+  }
+  return *this;
+}
+
+template <typename K, typename V, typename Compare, typename Allocator>
+persistent_map<K, V, Compare, Allocator>::~persistent_map() {
+  release_(root_);
+}
+
+template <typename K, typename V, typename Compare, typename Allocator>
+const V &persistent_map<K, V, Compare, Allocator>::at(const K &key) const {
+  iterator it = find(key);
+  if (!it.depth_) throw std::out_of_range("Out of range");
+  return it->second;
+}
+
+template <typename K, typename V, typename Compare, typename Allocator>
+typename persistent_map<K, V, Compare, Allocator>::iterator
+persistent_map<K, V, Compare, Allocator>::begin() const {
+  iterator it(root_);
+  if (root_) it.push_min_(root_);
+  return it;
+}
+
+template <typename K, typename V, typename Compare, typename Allocator>
+typename persistent_map<K, V, Compare, Allocator>::iterator
+persistent_map<K, V, Compare, Allocator>::end() const {
+  return iterator(root_);
+}
+
+template <typename K, typename V, typename Compare, typename Allocator>
+typename persistent_map<K, V, Compare, Allocator>::size_type
+persistent_map<K, V, Compare, Allocator>::max_size() const {
+  return node_traits::max_size(alloc_);
+}
+
+// Frees only the nodes no other version references.
+template <typename K, typename V, typename Compare, typename Allocator>
+void persistent_map<K, V, Compare, Allocator>::clear() {
+  release_(root_);
+  root_ = nullptr;
+  size_ = 0;
+}
+
+template <typename K, typename V, typename Compare, typename Allocator>
+void persistent_map<K, V, Compare, Allocator>::swap(persistent_map &other) {
+  std::swap(comp_, other.comp_);
+  std::swap(alloc_, other.alloc_);
+  std::swap(root_, other.root_);
+  std::swap(size_, other.size_);
+}
+
+template <typename K, typename V, typename Compare, typename Allocator>
+bool persistent_map<K, V, Compare, Allocator>::insert(const value_type &value) {
+  return insert(value.first, value.second);
+}
+
+template <typename K, typename V, typename Compare, typename Allocator>
+bool persistent_map<K, V, Compare, Allocator>::insert(const K &key,
+                                                      const V &obj) {
+  bool inserted = insert_(key, obj, false);
+  size_ += inserted;
+  return inserted;
+}
+
+template <typename K, typename V, typename Compare, typename Allocator>
+bool persistent_map<K, V, Compare, Allocator>::insert_or_assign(const K &key,
+                                                                const V &obj) {
+  bool inserted = insert_(key, obj, true);
+  size_ += inserted;
+  return inserted;
+}
+
+// The key is copied first, its node may be freed on the way.
+template <typename K, typename V, typename Compare, typename Allocator>
+void persistent_map<K, V, Compare, Allocator>::erase(iterator pos) {
+  K key = pos->first;
+  erase(key);
+}
+
+template <typename K, typename V, typename Compare, typename Allocator>
+typename persistent_map<K, V, Compare, Allocator>::size_type
+persistent_map<K, V, Compare, Allocator>::erase(const K &key) {
+  if (!contains(key)) return 0;
+  erase_(root_, key);
+  --size_;
+  return 1;
+}
+
+template <typename K, typename V, typename Compare, typename Allocator>
+typename persistent_map<K, V, Compare, Allocator>::iterator
+persistent_map<K, V, Compare, Allocator>::find(const K &key) const {
+  iterator it = lower_bound(key);
+  if (it.depth_ && comp_(key, it->first)) it.depth_ = 0;
+  return it;
+}
+
+template <typename K, typename V, typename Compare, typename Allocator>
+bool persistent_map<K, V, Compare, Allocator>::contains(const K &key) const {
+  const node *n = root_;
+  while (n) {
+    if (comp_(key, n->data.first))
+      n = n->left;
+    else if (comp_(n->data.first, key))
+      n = n->right;
+    else
+      return true;
+  }
+  return false;
+}
+
+// The path to the answer is a prefix of the search path, it is cut at the
+// last node the search went left from.
+template <typename K, typename V, typename Compare, typename Allocator>
+typename persistent_map<K, V, Compare, Allocator>::iterator
+persistent_map<K, V, Compare, Allocator>::lower_bound(const K &key) const {
+  iterator it(root_);
+  int keep = 0;
+  for (const node *n = root_; n;) {
+    it.path_[it.depth_++] = n;
+    if (comp_(n->data.first, key)) {
+      n = n->right;
+    } else {
+      keep = it.depth_;
+      n = n->left;
+    }
+  }
+  it.depth_ = keep;
+  return it;
+}
+
+template <typename K, typename V, typename Compare, typename Allocator>
+typename persistent_map<K, V, Compare, Allocator>::iterator
+persistent_map<K, V, Compare, Allocator>::upper_bound(const K &key) const {
+  iterator it(root_);
+  int keep = 0;
+  for (const node *n = root_; n;) {
+    it.path_[it.depth_++] = n;
+    if (comp_(key, n->data.first)) {
+      keep = it.depth_;
+      n = n->left;
+    } else {
+      n = n->right;
+    }
+  }
+  it.depth_ = keep;
+  return it;
+}
+
+template <typename K, typename V, typename Compare, typename Allocator>
+typename persistent_map<K, V, Compare, Allocator>::iterator &
+persistent_map<K, V, Compare, Allocator>::iterator::operator++() {
+  const node *n = path_[--depth_];
+  if (n->right) {
+    ++depth_;
+    push_min_(n->right);
+  } else {
+    while (depth_ && path_[depth_ - 1]->right == n) n = path_[--depth_];
+  }
+  return *this;
+}
+
+// From end() it steps to the largest element.
+template <typename K, typename V, typename Compare, typename Allocator>
+typename persistent_map<K, V, Compare, Allocator>::iterator &
+persistent_map<K, V, Compare, Allocator>::iterator::operator--() {
+  if (!depth_) {
+    push_max_(root_);
+    return *this;
+  }
+  const node *n = path_[--depth_];
+  if (n->left) {
+    ++depth_;
+    push_max_(n->left);
+  } else {
+    while (depth_ && path_[depth_ - 1]->left == n) n = path_[--depth_];
+  }
+  return *this;
+}
+
+template <typename K, typename V, typename Compare, typename Allocator>
+void persistent_map<K, V, Compare, Allocator>::iterator::push_min_(
+    const node *n) {
+  for (; n; n = n->left) path_[depth_++] = n;
+}
+
+template <typename K, typename V, typename Compare, typename Allocator>
+void persistent_map<K, V, Compare, Allocator>::iterator::push_max_(
+    const node *n) {
+  for (; n; n = n->right) path_[depth_++] = n;
+}
+
+template <typename K, typename V, typename Compare, typename Allocator>
+typename persistent_map<K, V, Compare, Allocator>::node *
+persistent_map<K, V, Compare, Allocator>::make_node_(const K &key,
+                                                     const V &obj) {
+  node *n = node_traits::allocate(alloc_, 1);
+  try {
+    node_traits::construct(alloc_, n, key, obj);
+  } catch (...) {
+    node_traits::deallocate(alloc_, n, 1);
+    throw;
+  }
+  return n;
+}
+
+template <typename K, typename V, typename Compare, typename Allocator>
+typename persistent_map<K, V, Compare, Allocator>::node *
+persistent_map<K, V, Compare, Allocator>::share_(node *n) {
+  if (n) n->refs.fetch_add(1, std::memory_order_relaxed);
+  return n;
+}
+
+// The last reference frees the node and drops its links to the children.
+// A version released on another thread synchronizes through the counter
+// with the writer that then finds the node unshared.
+template <typename K, typename V, typename Compare, typename Allocator>
+void persistent_map<K, V, Compare, Allocator>::release_(node *n) {
+  while (n && n->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    node *right = n->right;
+    release_(n->left);
+    node_traits::destroy(alloc_, n);
+    node_traits::deallocate(alloc_, n, 1);
+    n = right;
+  }
+}
+
+// A node only this version references changes in place. A shared one is
+// replaced under link by a copy that shares its children, so the tree is
+// whole again before anything below is touched.
+template <typename K, typename V, typename Compare, typename Allocator>
+void persistent_map<K, V, Compare, Allocator>::own_(node *&link) {
+  node *n = link;
+  if (n->refs.load(std::memory_order_acquire) == 1) return;
+  node *copy = make_node_(n->data.first, n->data.second);
+  copy->left = share_(n->left);
+  copy->right = share_(n->right);
+  copy->height = n->height;
+  link = copy;
+  release_(n);
+}
+
+template <typename K, typename V, typename Compare, typename Allocator>
+void persistent_map<K, V, Compare, Allocator>::update_(node *n) {
+  n->height = std::max(height_(n->left), height_(n->right)) + 1;
+}
+
+// link is owned, its child that moves up is made owned here.
+template <typename K, typename V, typename Compare, typename Allocator>
+void persistent_map<K, V, Compare, Allocator>::rotate_left_(node *&link) {
+  node *n = link;
+  own_(n->right);
+  node *r = n->right;
+  n->right = r->left;
+  r->left = n;
+  update_(n);
+  update_(r);
+  link = r;
+}
+
+template <typename K, typename V, typename Compare, typename Allocator>
+void persistent_map<K, V, Compare, Allocator>::rotate_right_(node *&link) {
+  node *n = link;
+  own_(n->left);
+  node *l = n->left;
+  n->left = l->right;
+  l->right = n;
+  update_(n);
+  update_(l);
+  link = l;
+}
+
+template <typename K, typename V, typename Compare, typename Allocator>
+void persistent_map<K, V, Compare, Allocator>::balance_(node *&link) {
+  node *n = link;
+  update_(n);
+  int balance = height_(n->left) - height_(n->right);
+  if (balance > 1) {
+    if (height_(n->left->left) < height_(n->left->right)) {
+      own_(n->left);
+      rotate_left_(n->left);
+    }
+    rotate_right_(link);
+  } else if (balance < -1) {
+    if (height_(n->right->right) < height_(n->right->left)) {
+      own_(n->right);
+      rotate_right_(n->right);
+    }
+    rotate_left_(link);
+  }
+}
+
+// One descent finds the key or its place and notes the turns. A present
+// key is left alone unless assign, so nothing is copied for it. Otherwise
+// the path is owned top down, then rebalanced bottom up. Returns whether
+// the key was new.
+template <typename K, typename V, typename Compare, typename Allocator>
+bool persistent_map<K, V, Compare, Allocator>::insert_(const K &key,
+                                                       const V &obj,
+                                                       bool assign) {
+  bool right[kMaxHeight];
+  int depth = 0;
+  bool found = false;
+  for (const node *n = root_; n && !found;) {
+    if (comp_(key, n->data.first)) {
+      right[depth++] = false;
+      n = n->left;
+    } else if (comp_(n->data.first, key)) {
+      right[depth++] = true;
+      n = n->right;
+    } else {
+      found = true;
+    }
+  }
+  if (found && !assign) return false;
+  node **links[kMaxHeight + 1] = {&root_};
+  for (int i = 0; i < depth; ++i) {
+    own_(*links[i]);
+    links[i + 1] = right[i] ? &(*links[i])->right : &(*links[i])->left;
+  }
+  if (found) {
+    own_(*links[depth]);
+    (*links[depth])->data.second = obj;
+    return false;
+  }
+  *links[depth] = make_node_(key, obj);
+  while (depth--) balance_(*links[depth]);
+  return true;
+}
+
+// The key is in the tree. A node with two children is replaced by the
+// smallest node of its right subtree.
+template <typename K, typename V, typename Compare, typename Allocator>
+void persistent_map<K, V, Compare, Allocator>::erase_(node *&link,
+                                                      const K &key) {
+  own_(link);
+  node *n = link;
+  if (comp_(key, n->data.first)) {
+    erase_(n->left, key);
+  } else if (comp_(n->data.first, key)) {
+    erase_(n->right, key);
+  } else {
+    // A lone child moves up as it is, its subtree stays balanced.
+    bool lone = !n->left || !n->right;
+    if (lone) {
+      link = n->left ? n->left : n->right;
+    } else {
+      node *min = take_min_(n->right);
+      min->left = n->left;
+      min->right = n->right;
+      link = min;
+    }
+    n->left = nullptr;
+    n->right = nullptr;
+    release_(n);
+    if (lone) return;
+  }
+  balance_(link);
+}
+
+// Unlinks the smallest node below link and returns it owned.
+template <typename K, typename V, typename Compare, typename Allocator>
+typename persistent_map<K, V, Compare, Allocator>::node *
+persistent_map<K, V, Compare, Allocator>::take_min_(node *&link) {
+  own_(link);
+  node *n = link;
+  if (!n->left) {
+    link = n->right;
+    n->right = nullptr;
+    return n;
+  }
+  node *min = take_min_(n->left);
+  balance_(link);
+  return min;
+}
+
+}  // namespace s21
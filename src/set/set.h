@@ -1,9 +1,12 @@
 #ifndef SET_H
 #define SET_H
+#include <memory_resource>
+
 #include "../tree/tree.h"
 namespace s21 {
-template <typename K>
-class set : public tree<K, K> {
+template <typename K, typename Compare = std::less<K>,
+          typename Allocator = std::allocator<K>>
+class set : public tree<K, K, Compare, Allocator> {
  public:
   class set_iter;
   class set_const_iter;
@@ -14,36 +17,80 @@ class set : public tree<K, K> {
   using iterator = set_iter;
   using const_iterator = set_const_iter;
   using size_type = size_t;
+  using allocator_type = Allocator;
+  using key_compare = Compare;
+  using node_type = typename tree<K, K, Compare, Allocator>::node_handle;
+  struct insert_return_type;
 
   set();
-  set(std::initializer_list<value_type> const &items);
+  explicit set(const Allocator &alloc);
+  explicit set(const Compare &comp, const Allocator &alloc = Allocator());
+  set(std::initializer_list<value_type> const &items,
+      const Allocator &alloc = Allocator());
+  set(std::initializer_list<value_type> const &items, const Compare &comp,
+      const Allocator &alloc = Allocator());
+  template <typename InputIt>
+  set(InputIt first, InputIt last, const Allocator &alloc = Allocator());
+  template <typename InputIt>
+  set(InputIt first, InputIt last, const Compare &comp,
+      const Allocator &alloc = Allocator());
   set(const set &s);
   set(set &&s);
   ~set();
 
+  template <typename InputIt>
+  void assign_sorted(InputIt first, InputIt last);
+
   iterator begin();
   iterator end();
 
   std::pair<iterator, bool> insert(const value_type &value);
+  iterator insert(iterator hint, const value_type &value);
+  template <typename... Args>
+  iterator emplace_hint(iterator hint, Args &&...args);
   template <typename... Args>
   std::vector<std::pair<iterator, bool>> insert_many(Args &&...args);
 
-  iterator find(const K &key);
+  node_type extract(iterator pos);
+  node_type extract(const K &key);
+  insert_return_type insert(node_type &&node);
 
-  class set_iter : public tree<K, K>::iter {
-    friend class set<K>;
+  template <typename Q = K>
+  iterator find(const Q &key);
+  template <typename Q = K>
+  size_type count(const Q &key);
+  template <typename Q = K>
+  iterator lower_bound(const Q &key);
+  template <typename Q = K>
+  iterator upper_bound(const Q &key);
+  template <typename Q = K>
+  std::pair<iterator, iterator> equal_range(const Q &key);
+  iterator nth(size_type k);
+
+  class set_iter : public tree<K, K, Compare, Allocator>::iter {
+    friend class set<K, Compare, Allocator>;
 
    public:
-    set_iter() : tree<K, K>::iter(){};
-    K &operator*();
+    set_iter() : tree<K, K, Compare, Allocator>::iter(){};
+    const K &operator*();
   };
   class set_const_iter : public set_iter {
    public:
     set_const_iter() : set_iter(){};
-    const K operator*() const { return set_iter::operator*(); };
+    const K &operator*() const { return this->current->key(); };
+  };
+  struct insert_return_type {
+    iterator position;
+    bool inserted;
+    node_type node;
   };
 };
 
+namespace pmr {
+template <typename K>
+using set = s21::set<K, std::less<K>, std::pmr::polymorphic_allocator<K>>;
+}  // namespace pmr
+
 }  // namespace s21
 
 #include "set.tpp"
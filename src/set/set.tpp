@@ -1,58 +1,109 @@
 #include "set.h"
 namespace s21 {
-template <typename K>
-set<K>::set() {
+template <typename K, typename Compare, typename Allocator>
+set<K, Compare, Allocator>::set() {
   this->end_.left = this->root;
   this->end_.right = this->root;
 };
 
-template <typename K>
-set<K>::set(const std::initializer_list<value_type> &items) {
-  for (auto i = items.begin(); i != items.end(); ++i) {
-    insert(*i);
-  }
+template <typename K, typename Compare, typename Allocator>
+set<K, Compare, Allocator>::set(const Allocator &alloc)
+    : set(Compare(), alloc) {}
+
+template <typename K, typename Compare, typename Allocator>
+set<K, Compare, Allocator>::set(const Compare &comp, const Allocator &alloc)
+    : tree<K, K, Compare, Allocator>(comp, alloc) {
+  this->end_.left = this->root;
+  this->end_.right = this->root;
+}
+
+template <typename K, typename Compare, typename Allocator>
+set<K, Compare, Allocator>::set(const std::initializer_list<value_type> &items,
+                                const Allocator &alloc)
+    : set(items.begin(), items.end(), Compare(), alloc) {}
+
+template <typename K, typename Compare, typename Allocator>
+set<K, Compare, Allocator>::set(const std::initializer_list<value_type> &items,
+                                const Compare &comp, const Allocator &alloc)
+    : set(items.begin(), items.end(), comp, alloc) {}
+
+template <typename K, typename Compare, typename Allocator>
+template <typename InputIt>
+set<K, Compare, Allocator>::set(InputIt first, InputIt last,
+                                const Allocator &alloc)
+    : set(first, last, Compare(), alloc) {}
+
+template <typename K, typename Compare, typename Allocator>
+template <typename InputIt>
+set<K, Compare, Allocator>::set(InputIt first, InputIt last,
+                                const Compare &comp, const Allocator &alloc)
+    : set(comp, alloc) {
+  assign_sorted(first, last);
+}
+
+// Builds the tree in linear time while the input is sorted, see
+// tree::assign_sorted_.
+template <typename K, typename Compare, typename Allocator>
+template <typename InputIt>
+void set<K, Compare, Allocator>::assign_sorted(InputIt first, InputIt last) {
+  this->assign_sorted_(
+      first, last, [](const auto &item) -> const auto & { return item; },
+      [](const auto &item) -> const auto & { return item; }, false);
 }
 
-template <typename K>
-set<K>::set(const set &m) {
-  this->copy(m);
+template <typename K, typename Compare, typename Allocator>
+set<K, Compare, Allocator>::set(const set &m)
+    : tree<K, K, Compare, Allocator>(
+          m.key_comp(), std::allocator_traits<Allocator>::
+                            select_on_container_copy_construction(
+                                m.get_allocator())) {
+  this->copy(m, m.size_);
 }
 
-template <typename K>
-set<K>::set(set &&other) {
-  this->root = other.root;
-  this->end_ = other.end_;
-  other.root = &other.end_;
-  other.end_.right = other.root;
-  other.end_.left = other.root;
-  other.end_.parent = other.root;
-  other.end_.key = 0;
-  this->root->parent = &this->end_;
-  this->size_ = other.size_;
-  other.size_ = 0;
+template <typename K, typename Compare, typename Allocator>
+set<K, Compare, Allocator>::set(set &&other)
+    : tree<K, K, Compare, Allocator>(other.key_comp(), other.get_allocator()) {
+  this->attach_(other.detach_());
+  this->pool_.swap(other.pool_);
 }
 
-template <typename K>
-set<K>::~set() {
+template <typename K, typename Compare, typename Allocator>
+set<K, Compare, Allocator>::~set() {
   this->clear();
 }
-template <typename K>
-std::pair<typename set<K>::iterator, bool> set<K>::insert(const K &key) {
-  std::pair<typename tree<K, K>::Node *, bool> nb = this->insert_(key, key);
+template <typename K, typename Compare, typename Allocator>
+std::pair<typename set<K, Compare, Allocator>::iterator, bool>
+set<K, Compare, Allocator>::insert(const K &key) {
+  std::pair<typename tree<K, K, Compare, Allocator>::Node *, bool> nb =
+      this->insert_(key, key);
   std::pair<iterator, bool> res;
   res.first.end = &(this->end_);
   res.first.current = nb.first;
-  res.first.next = res.first.Forw(res.first.current);
-  res.first.cur_value =
-      std::make_pair(res.first.current->key, res.first.current->value);
   res.second = nb.second;
   return res;
 }
 
-template <typename K>
+// O(1) amortized when value belongs right next to hint, see
+// tree::insert_hint_.
+template <typename K, typename Compare, typename Allocator>
+typename set<K, Compare, Allocator>::iterator
+set<K, Compare, Allocator>::insert(iterator hint, const value_type &value) {
+  return this->template make_iter_<iterator>(
+      this->insert_hint_(hint.current, value, value).first);
+}
+
+template <typename K, typename Compare, typename Allocator>
+template <typename... Args>
+typename set<K, Compare, Allocator>::iterator
+set<K, Compare, Allocator>::emplace_hint(iterator hint, Args &&...args) {
+  K key(std::forward<Args>(args)...);
+  return insert(hint, key);
+}
+
+template <typename K, typename Compare, typename Allocator>
 template <typename... Args>
-std::vector<std::pair<typename set<K>::iterator, bool>> set<K>::insert_many(
-    Args &&...args) {
+std::vector<std::pair<typename set<K, Compare, Allocator>::iterator, bool>>
+set<K, Compare, Allocator>::insert_many(Args &&...args) {
   std::vector<std::pair<iterator, bool>> res;
   for (const auto &arg : {args...}) {
     res.push_back(insert(arg));
@@ -60,38 +111,94 @@ std::vector<std::pair<typename set<K>::iterator, bool>> set<K>::insert_many(
   return res;
 }
 
-template <typename K>
-typename set<K>::iterator set<K>::find(const K &key) {
+// Unlinks the key without freeing or copying it, see tree::node_handle.
+// An empty handle when there is none.
+template <typename K, typename Compare, typename Allocator>
+typename set<K, Compare, Allocator>::node_type
+set<K, Compare, Allocator>::extract(iterator pos) {
+  return this->extract_(pos.current);
+}
+
+template <typename K, typename Compare, typename Allocator>
+typename set<K, Compare, Allocator>::node_type
+set<K, Compare, Allocator>::extract(const K &key) {
+  return this->extract_(this->find_node(key));
+}
+
+// See map::insert(node_type &&).
+template <typename K, typename Compare, typename Allocator>
+typename set<K, Compare, Allocator>::insert_return_type
+set<K, Compare, Allocator>::insert(node_type &&node) {
+  auto nb = this->insert_handle_(node, false);
+  return {this->template make_iter_<iterator>(nb.first), nb.second,
+          std::move(node)};
+}
+
+template <typename K, typename Compare, typename Allocator>
+template <typename Q>
+typename set<K, Compare, Allocator>::iterator
+set<K, Compare, Allocator>::find(const Q &key) {
   iterator a;
   a.end = &this->end_;
   a.current = this->find_node(key);
   if (a.current == nullptr) a.current = &this->end_;
-  a.next = a.Forw(a.current);
-  a.cur_value = std::make_pair(a.current->key, a.current->value);
   return a;
 }
 
-template <typename K>
-K &set<K>::iterator::operator*() {
-  return this->cur_value.first;
+template <typename K, typename Compare, typename Allocator>
+template <typename Q>
+size_t set<K, Compare, Allocator>::count(const Q &key) {
+  return this->contains(key);
+}
+
+template <typename K, typename Compare, typename Allocator>
+template <typename Q>
+typename set<K, Compare, Allocator>::iterator
+set<K, Compare, Allocator>::lower_bound(const Q &key) {
+  return this->template make_iter_<iterator>(this->lower_bound_(key));
+}
+
+template <typename K, typename Compare, typename Allocator>
+template <typename Q>
+typename set<K, Compare, Allocator>::iterator
+set<K, Compare, Allocator>::upper_bound(const Q &key) {
+  return this->template make_iter_<iterator>(this->upper_bound_(key));
+}
+
+template <typename K, typename Compare, typename Allocator>
+template <typename Q>
+std::pair<typename set<K, Compare, Allocator>::iterator,
+          typename set<K, Compare, Allocator>::iterator>
+set<K, Compare, Allocator>::equal_range(const Q &key) {
+  return std::make_pair(lower_bound(key), upper_bound(key));
+}
+
+// k-th smallest key in O(log n), end() when k >= size().
+template <typename K, typename Compare, typename Allocator>
+typename set<K, Compare, Allocator>::iterator
+set<K, Compare, Allocator>::nth(size_type k) {
+  return this->template make_iter_<iterator>(this->nth_(k).first);
+}
+
+template <typename K, typename Compare, typename Allocator>
+const K &set<K, Compare, Allocator>::iterator::operator*() {
+  return this->current->key();
 }
-template <typename K>
-typename set<K>::iterator set<K>::begin() {
+template <typename K, typename Compare, typename Allocator>
+typename set<K, Compare, Allocator>::iterator
+set<K, Compare, Allocator>::begin() {
   iterator a;
   a.end = &(this->end_);
   a.current = this->end_.right;
-  a.next = a.Forw(a.current);
-  a.cur_value = std::make_pair(a.current->key, a.current->value);
   return a;
 }
 
-template <typename K>
-typename set<K>::iterator set<K>::end() {
+template <typename K, typename Compare, typename Allocator>
+typename set<K, Compare, Allocator>::iterator
+set<K, Compare, Allocator>::end() {
   iterator a;
   a.end = &(this->end_);
   a.current = &(this->end_);
-  a.next = a.Forw(a.current);
-  a.cur_value = std::make_pair(a.current->key, a.current->value);
   return a;
 }
 }  // namespace s21
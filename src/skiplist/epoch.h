@@ -0,0 +1,52 @@
+#ifndef EPOCH_H
+#define EPOCH_H
+#include <atomic>
+#include <cstdint>
+
+// Epoch-based reclamation shared by all lock-free structures. A thread
+// pins the current epoch while it holds pointers into such a structure.
+// Memory unlinked in epoch e may be freed once the global epoch reaches
+// e + 2: every thread pinned back then has let go by that time.
+class epoch {
+  struct record;
+
+ public:
+  // Pins the epoch for the calling thread. Guards nest and may be copied,
+  // but have to end on the thread that made them.
+  class guard {
+   public:
+    guard();
+    guard(const guard &other);
+    guard &operator=(const guard &other);
+    ~guard();
+
+   private:
+    record *rec_;
+  };
+
+  static uint64_t current();
+  // Moves the global epoch on when every pinned thread has seen the
+  // current one. Returns the epoch after the attempt.
+  static uint64_t try_advance();
+  // An epoch retired at can be freed when safe(retired_at) is true.
+  static bool safe(uint64_t retired_at);
+
+ private:
+  // One per thread, reused once the thread has ended.
+  struct record {
+    // The epoch seen on pinning, 0 while not pinned.
+    std::atomic<uint64_t> pinned{0};
+    std::atomic<bool> used{true};
+    unsigned depth = 0;
+    record *next = nullptr;
+  };
+  static record &local_();
+  static record *acquire_();
+  static void pin_(record &rec);
+  static void unpin_(record &rec);
+  inline static std::atomic<uint64_t> global_{1};
+  inline static std::atomic<record *> records_{nullptr};
+};
+
+#include "epoch.tpp"
+#endif  // EPOCH_H
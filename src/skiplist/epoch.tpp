@@ -0,0 +1,74 @@
+#include "epoch.h"
+
+inline epoch::guard::guard() : rec_(&local_()) { pin_(*rec_); }
+
+inline epoch::guard::guard(const guard &other) : rec_(other.rec_) {
+  pin_(*rec_);
+}
+
+inline epoch::guard &epoch::guard::operator=(const guard &other) {
+  pin_(*other.rec_);
+  unpin_(*rec_);
+  rec_ = other.rec_;
+  return *this;
+}
+
+inline epoch::guard::~guard() { unpin_(*rec_); }
+
+inline uint64_t epoch::current() { return global_.load(); }
+
+inline uint64_t epoch::try_advance() {
+  uint64_t now = global_.load();
+  for (record *rec = records_.load(std::memory_order_acquire); rec;
+       rec = rec->next) {
+    uint64_t pinned = rec->pinned.load();
+    if (pinned && pinned != now) return now;
+  }
+  global_.compare_exchange_strong(now, now + 1);
+  return global_.load();
+}
+
+inline bool epoch::safe(uint64_t retired_at) {
+  return global_.load() >= retired_at + 2;
+}
+
+inline epoch::record &epoch::local_() {
+  struct owner {
+    owner() : rec(acquire_()){};
+    ~owner() { rec->used.store(false, std::memory_order_release); };
+    record *rec;
+  };
+  thread_local owner self;
+  return *self.rec;
+}
+
+// Records are never freed, a new thread takes over one left by a thread
+// that has ended.
+inline epoch::record *epoch::acquire_() {
+  for (record *rec = records_.load(std::memory_order_acquire); rec;
+       rec = rec->next) {
+    bool used = false;
+    if (!rec->used.load(std::memory_order_relaxed) &&
+        rec->used.compare_exchange_strong(used, true))
+      return rec;
+  }
+  record *rec = new record;
+  rec->next = records_.load(std::memory_order_relaxed);
+  while (!records_.compare_exchange_weak(rec->next, rec,
+                                         std::memory_order_release,
+                                         std::memory_order_relaxed)) {
+  }
+  return rec;
+}
+
+// The fence keeps the loads of the structure after the announcement.
+inline void epoch::pin_(record &rec) {
+  if (rec.depth++ == 0) {
+    rec.pinned.store(global_.load());
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+  }
+}
+
+inline void epoch::unpin_(record &rec) {
+  if (--rec.depth == 0) rec.pinned.store(0, std::memory_order_release);
+}
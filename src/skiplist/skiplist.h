@@ -0,0 +1,154 @@
+#ifndef SKIPLIST_H
+#define SKIPLIST_H
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "epoch.h"
+
+// Lock-free skip list core of skiplist_map. Every operation may run
+// concurrently with any other except destruction. A node is erased by
+// setting the low bit of its links from the top level down. The thread
+// that marks level 0 owns the erase. Searches unlink the marked nodes
+// they pass. Unlinked nodes are freed through epoch, so an iterator keeps
+// its node alive and steps past nodes erased under it.
+template <typename K, typename T, typename Compare, typename Allocator>
+class skiplist {
+ protected:
+  struct node;
+
+ public:
+  class iterator;
+  class const_iterator;
+  using key_type = K;
+  using value_type = T;
+  using reference = value_type &;
+  using const_reference = const value_type &;
+  using size_type = size_t;
+  using key_compare = Compare;
+  using allocator_type = Allocator;
+
+  skiplist() : skiplist(Compare()){};
+  explicit skiplist(const Compare &comp, const Allocator &alloc = Allocator());
+  explicit skiplist(const Allocator &alloc) : skiplist(Compare(), alloc){};
+  skiplist(const skiplist &) = delete;
+  skiplist &operator=(const skiplist &) = delete;
+  ~skiplist();
+
+  allocator_type get_allocator() const { return allocator_type(alloc_); };
+  key_compare key_comp() const { return comp_; };
+
+  iterator begin();
+  iterator end();
+
+  bool empty() const;
+  size_type size() const;
+  size_type max_size() const;
+
+  // Erases element by element, so it is safe next to other operations.
+  void clear();
+  void erase(iterator pos);
+  size_type erase(const K &key);
+
+  iterator find(const K &key);
+  bool contains(const K &key);
+  iterator lower_bound(const K &key);
+  iterator upper_bound(const K &key);
+
+  class iterator {
+    friend class skiplist;
+
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = T *;
+    using reference = T &;
+
+    iterator() = default;
+    T &operator*() const { return node_->value(); };
+    T *operator->() const { return &node_->value(); };
+    iterator &operator++();
+    bool operator==(const iterator &it) const { return node_ == it.node_; };
+    bool operator!=(const iterator &it) const { return node_ != it.node_; };
+
+   protected:
+    explicit iterator(node *n) : node_(n){};
+    node *node_ = nullptr;
+    // Keeps node_ from being freed, see epoch::guard.
+    epoch::guard pin_;
+  };
+  class const_iterator : public iterator {
+   public:
+    const_iterator() = default;
+    const_iterator(const iterator &it) : iterator(it){};
+    const T &operator*() const { return iterator::operator*(); };
+    const T *operator->() const { return iterator::operator->(); };
+  };
+
+ protected:
+  // p = 1/4 per level, enough for 4^16 elements.
+  static constexpr unsigned kMaxHeight = 16;
+  // Retired nodes between two attempts to free them.
+  static constexpr size_t kReclaimEvery = 64;
+  enum : unsigned { kInserting = 1, kErased = 2 };
+
+  // The tower of links follows the node in the same allocation.
+  struct node {
+    explicit node(unsigned h) : height(h){};
+    T &value() { return *std::launder(reinterpret_cast<T *>(storage)); };
+    std::atomic<uintptr_t> &next(unsigned level) {
+      return reinterpret_cast<std::atomic<uintptr_t> *>(this + 1)[level];
+    };
+    // The head has no element.
+    alignas(T) unsigned char storage[sizeof(T)];
+    // Both bits set means the inserter still links upper levels while an
+    // eraser already unlinked the node, the last of them frees it.
+    std::atomic<unsigned> state{kInserting};
+    unsigned height;
+    node *retired = nullptr;
+    uint64_t retired_at = 0;
+  };
+  using node_allocator =
+      typename std::allocator_traits<Allocator>::template rebind_alloc<node>;
+  using node_traits = std::allocator_traits<node_allocator>;
+
+  static const K &key_of(const T &slot);
+  static node *ptr_(uintptr_t link) {
+    return reinterpret_cast<node *>(link & ~uintptr_t(1));
+  };
+  static bool marked_(uintptr_t link) { return link & 1; };
+  static uintptr_t link_(node *n) { return reinterpret_cast<uintptr_t>(n); };
+  static unsigned random_height_();
+  static size_t slots_(unsigned height);
+
+  bool search_(const K &key, node **preds, node **succs);
+  bool try_search_(const K &key, node **preds, node **succs, bool &found);
+  template <typename... Args>
+  std::pair<iterator, bool> emplace_key_(const K &key, Args &&...args);
+  void link_upper_(node *fresh, node **preds, node **succs);
+  bool unlink_(node *victim);
+
+  node *make_node_(unsigned height);
+  void free_node_(node *n, bool with_value);
+  void retire_(node *n);
+  void reclaim_();
+
+  Compare comp_;
+  node_allocator alloc_;
+  node *head_;
+  std::atomic<size_t> size_{0};
+  // Levels any node has used so far, searches start at the top one.
+  std::atomic<unsigned> levels_{1};
+  std::atomic<node *> retired_{nullptr};
+  std::atomic<size_t> retire_count_{0};
+};
+
+#include "skiplist.tpp"
+#endif  // SKIPLIST_H
@@ -0,0 +1,369 @@
+#include "skiplist.h"
+
+template <typename K, typename T, typename Compare, typename Allocator>
+skiplist<K, T, Compare, Allocator>::skiplist(const Compare &comp,
+                                             const Allocator &alloc)
+    : comp_(comp), alloc_(alloc) {
+  head_ = make_node_(kMaxHeight);
+  head_->state.store(0, std::memory_order_relaxed);
+}
+
+// No other thread may use the list any more, so every linked node is an
+// element and every retired one is already unlinked.
+template <typename K, typename T, typename Compare, typename Allocator>
+skiplist<K, T, Compare, Allocator>::~skiplist() {
+  node *n = ptr_(head_->next(0).load(std::memory_order_acquire));
+  while (n) {
+    node *next = ptr_(n->next(0).load(std::memory_order_relaxed));
+    free_node_(n, true);
+    n = next;
+  }
+  n = retired_.load(std::memory_order_acquire);
+  while (n) {
+    node *next = n->retired;
+    free_node_(n, true);
+    n = next;
+  }
+  free_node_(head_, false);
+}
+
+template <typename K, typename T, typename Compare, typename Allocator>
+const K &skiplist<K, T, Compare, Allocator>::key_of(const T &slot) {
+  if constexpr (std::is_same<K, T>::value)
+    return slot;
+  else
+    return slot.first;
+}
+
+template <typename K, typename T, typename Compare, typename Allocator>
+unsigned skiplist<K, T, Compare, Allocator>::random_height_() {
+  thread_local uint64_t state =
+      0x9e3779b97f4a7c15ULL ^ reinterpret_cast<uintptr_t>(&state);
+  state ^= state << 13;
+  state ^= state >> 7;
+  state ^= state << 17;
+  uint64_t bits = state;
+  unsigned height = 1;
+  while (height < kMaxHeight && (bits & 3) == 0) {
+    ++height;
+    bits >>= 2;
+  }
+  return height;
+}
+
+template <typename K, typename T, typename Compare, typename Allocator>
+size_t skiplist<K, T, Compare, Allocator>::slots_(unsigned height) {
+  return 1 + (height * sizeof(std::atomic<uintptr_t>) + sizeof(node) - 1) /
+                 sizeof(node);
+}
+
+template <typename K, typename T, typename Compare, typename Allocator>
+typename skiplist<K, T, Compare, Allocator>::node *
+skiplist<K, T, Compare, Allocator>::make_node_(unsigned height) {
+  node *n = node_traits::allocate(alloc_, slots_(height));
+  ::new (static_cast<void *>(n)) node(height);
+  for (unsigned level = 0; level < height; ++level)
+    ::new (static_cast<void *>(&n->next(level))) std::atomic<uintptr_t>(0);
+  return n;
+}
+
+template <typename K, typename T, typename Compare, typename Allocator>
+void skiplist<K, T, Compare, Allocator>::free_node_(node *n, bool with_value) {
+  if (with_value) std::destroy_at(&n->value());
+  unsigned height = n->height;
+  n->~node();
+  node_traits::deallocate(alloc_, n, slots_(height));
+}
+
+// Fills preds and succs with the nodes around key on every level and
+// unlinks marked nodes on the way. Returns false when another thread
+// changed a link it had to swing, the caller starts over.
+template <typename K, typename T, typename Compare, typename Allocator>
+bool skiplist<K, T, Compare, Allocator>::try_search_(const K &key,
+                                                     node **preds,
+                                                     node **succs,
+                                                     bool &found) {
+  unsigned levels = levels_.load(std::memory_order_relaxed);
+  for (unsigned level = levels; level < kMaxHeight; ++level) {
+    preds[level] = head_;
+    succs[level] = nullptr;
+  }
+  node *pred = head_;
+  for (unsigned level = levels; level-- > 0;) {
+    node *curr = ptr_(pred->next(level).load(std::memory_order_acquire));
+    while (curr) {
+      uintptr_t succ = curr->next(level).load(std::memory_order_acquire);
+      if (marked_(succ)) {
+        uintptr_t expected = link_(curr);
+        if (!pred->next(level).compare_exchange_strong(
+                expected, succ & ~uintptr_t(1), std::memory_order_acq_rel))
+          return false;
+        curr = ptr_(succ);
+      } else if (comp_(key_of(curr->value()), key)) {
+        pred = curr;
+        curr = ptr_(succ);
+      } else {
+        break;
+      }
+    }
+    preds[level] = pred;
+    succs[level] = curr;
+  }
+  found = succs[0] && !comp_(key, key_of(succs[0]->value()));
+  return true;
+}
+
+template <typename K, typename T, typename Compare, typename Allocator>
+bool skiplist<K, T, Compare, Allocator>::search_(const K &key, node **preds,
+                                                 node **succs) {
+  bool found = false;
+  while (!try_search_(key, preds, succs, found)) {
+  }
+  return found;
+}
+
+// The element is built once the key is known to be missing and freed
+// again if another thread links the same key first.
+template <typename K, typename T, typename Compare, typename Allocator>
+template <typename... Args>
+std::pair<typename skiplist<K, T, Compare, Allocator>::iterator, bool>
+skiplist<K, T, Compare, Allocator>::emplace_key_(const K &key,
+                                                 Args &&...args) {
+  epoch::guard pin;
+  node *preds[kMaxHeight];
+  node *succs[kMaxHeight];
+  node *fresh = nullptr;
+  while (true) {
+    if (search_(key, preds, succs)) {
+      if (fresh) free_node_(fresh, true);
+      return {iterator(succs[0]), false};
+    }
+    if (!fresh) {
+      fresh = make_node_(random_height_());
+      unsigned levels = levels_.load(std::memory_order_relaxed);
+      while (levels < fresh->height &&
+             !levels_.compare_exchange_weak(levels, fresh->height,
+                                            std::memory_order_relaxed)) {
+      }
+      try {
+        ::new (static_cast<void *>(fresh->storage))
+            T(std::forward<Args>(args)...);
+      } catch (...) {
+        free_node_(fresh, false);
+        throw;
+      }
+    }
+    for (unsigned level = 0; level < fresh->height; ++level)
+      fresh->next(level).store(link_(succs[level]),
+                               std::memory_order_relaxed);
+    uintptr_t expected = link_(succs[0]);
+    if (preds[0]->next(0).compare_exchange_strong(expected, link_(fresh),
+                                                  std::memory_order_release,
+                                                  std::memory_order_relaxed))
+      break;
+  }
+  size_.fetch_add(1, std::memory_order_relaxed);
+  link_upper_(fresh, preds, succs);
+  return {iterator(fresh), true};
+}
+
+// Links the levels above 0. Stops at the first level an eraser has marked
+// already. If an eraser came by in the meantime, its search may have
+// missed levels linked after it, so this search unlinks them and the node
+// is retired here.
+template <typename K, typename T, typename Compare, typename Allocator>
+void skiplist<K, T, Compare, Allocator>::link_upper_(node *fresh,
+                                                     node **preds,
+                                                     node **succs) {
+  const K &key = key_of(fresh->value());
+  for (unsigned level = 1; level < fresh->height; ++level) {
+    bool linked = false;
+    while (!linked) {
+      uintptr_t next = fresh->next(level).load(std::memory_order_acquire);
+      if (marked_(next)) break;
+      if (next != link_(succs[level]) &&
+          !fresh->next(level).compare_exchange_strong(
+              next, link_(succs[level]), std::memory_order_acq_rel))
+        continue;
+      uintptr_t expected = link_(succs[level]);
+      linked = preds[level]->next(level).compare_exchange_strong(
+          expected, link_(fresh), std::memory_order_acq_rel);
+      if (!linked) search_(key, preds, succs);
+    }
+    if (!linked) break;
+  }
+  if (fresh->state.fetch_and(~kInserting, std::memory_order_acq_rel) &
+      kErased) {
+    search_(key, preds, succs);
+    retire_(fresh);
+  }
+}
+
+// Marks the upper levels top down, then races for level 0. Returns true
+// for the thread that erased the node.
+template <typename K, typename T, typename Compare, typename Allocator>
+bool skiplist<K, T, Compare, Allocator>::unlink_(node *victim) {
+  for (unsigned level = victim->height; level-- > 1;) {
+    uintptr_t next = victim->next(level).load(std::memory_order_acquire);
+    while (!marked_(next) &&
+           !victim->next(level).compare_exchange_weak(
+               next, next | 1, std::memory_order_acq_rel)) {
+    }
+  }
+  uintptr_t next = victim->next(0).load(std::memory_order_acquire);
+  while (!marked_(next)) {
+    if (victim->next(0).compare_exchange_weak(next, next | 1,
+                                              std::memory_order_acq_rel)) {
+      size_.fetch_sub(1, std::memory_order_relaxed);
+      unsigned state =
+          victim->state.fetch_or(kErased, std::memory_order_acq_rel);
+      node *preds[kMaxHeight];
+      node *succs[kMaxHeight];
+      search_(key_of(victim->value()), preds, succs);
+      if (!(state & kInserting)) retire_(victim);
+      return true;
+    }
+  }
+  return false;
+}
+
+template <typename K, typename T, typename Compare, typename Allocator>
+void skiplist<K, T, Compare, Allocator>::retire_(node *n) {
+  n->retired_at = epoch::current();
+  n->retired = retired_.load(std::memory_order_relaxed);
+  while (!retired_.compare_exchange_weak(n->retired, n,
+                                         std::memory_order_release,
+                                         std::memory_order_relaxed)) {
+  }
+  if (retire_count_.fetch_add(1, std::memory_order_relaxed) %
+          kReclaimEvery ==
+      kReclaimEvery - 1)
+    reclaim_();
+}
+
+// Takes the whole retired list, frees what no pinned thread can reach
+// any more and puts the rest back.
+template <typename K, typename T, typename Compare, typename Allocator>
+void skiplist<K, T, Compare, Allocator>::reclaim_() {
+  epoch::try_advance();
+  node *n = retired_.exchange(nullptr, std::memory_order_acquire);
+  node *keep = nullptr;
+  node *tail = nullptr;
+  while (n) {
+    node *next = n->retired;
+    if (epoch::safe(n->retired_at)) {
+      free_node_(n, true);
+    } else {
+      n->retired = keep;
+      keep = n;
+      if (!tail) tail = n;
+    }
+    n = next;
+  }
+  if (!keep) return;
+  tail->retired = retired_.load(std::memory_order_relaxed);
+  while (!retired_.compare_exchange_weak(tail->retired, keep,
+                                         std::memory_order_release,
+                                         std::memory_order_relaxed)) {
+  }
+}
+
+// Skips nodes erased since they were read.
+template <typename K, typename T, typename Compare, typename Allocator>
+typename skiplist<K, T, Compare, Allocator>::iterator &
+skiplist<K, T, Compare, Allocator>::iterator::operator++() {
+  node *n = ptr_(node_->next(0).load(std::memory_order_acquire));
+  while (n) {
+    uintptr_t next = n->next(0).load(std::memory_order_acquire);
+    if (!marked_(next)) break;
+    n = ptr_(next);
+  }
+  node_ = n;
+  return *this;
+}
+
+template <typename K, typename T, typename Compare, typename Allocator>
+typename skiplist<K, T, Compare, Allocator>::iterator
+skiplist<K, T, Compare, Allocator>::begin() {
+  iterator it(head_);
+  ++it;
+  return it;
+}
+
+template <typename K, typename T, typename Compare, typename Allocator>
+typename skiplist<K, T, Compare, Allocator>::iterator
+skiplist<K, T, Compare, Allocator>::end() {
+  return iterator();
+}
+
+template <typename K, typename T, typename Compare, typename Allocator>
+bool skiplist<K, T, Compare, Allocator>::empty() const {
+  return size() == 0;
+}
+
+template <typename K, typename T, typename Compare, typename Allocator>
+typename skiplist<K, T, Compare, Allocator>::size_type
+skiplist<K, T, Compare, Allocator>::size() const {
+  return size_.load(std::memory_order_relaxed);
+}
+
+template <typename K, typename T, typename Compare, typename Allocator>
+typename skiplist<K, T, Compare, Allocator>::size_type
+skiplist<K, T, Compare, Allocator>::max_size() const {
+  return node_traits::max_size(alloc_) / slots_(1);
+}
+
+template <typename K, typename T, typename Compare, typename Allocator>
+void skiplist<K, T, Compare, Allocator>::clear() {
+  for (iterator it = begin(); it != end(); ++it) unlink_(it.node_);
+}
+
+template <typename K, typename T, typename Compare, typename Allocator>
+void skiplist<K, T, Compare, Allocator>::erase(iterator pos) {
+  if (pos.node_) unlink_(pos.node_);
+}
+
+template <typename K, typename T, typename Compare, typename Allocator>
+typename skiplist<K, T, Compare, Allocator>::size_type
+skiplist<K, T, Compare, Allocator>::erase(const K &key) {
+  epoch::guard pin;
+  node *preds[kMaxHeight];
+  node *succs[kMaxHeight];
+  if (!search_(key, preds, succs)) return 0;
+  return unlink_(succs[0]) ? 1 : 0;
+}
+
+template <typename K, typename T, typename Compare, typename Allocator>
+typename skiplist<K, T, Compare, Allocator>::iterator
+skiplist<K, T, Compare, Allocator>::find(const K &key) {
+  epoch::guard pin;
+  node *preds[kMaxHeight];
+  node *succs[kMaxHeight];
+  return search_(key, preds, succs) ? iterator(succs[0]) : end();
+}
+
+template <typename K, typename T, typename Compare, typename Allocator>
+bool skiplist<K, T, Compare, Allocator>::contains(const K &key) {
+  epoch::guard pin;
+  node *preds[kMaxHeight];
+  node *succs[kMaxHeight];
+  return search_(key, preds, succs);
+}
+
+template <typename K, typename T, typename Compare, typename Allocator>
+typename skiplist<K, T, Compare, Allocator>::iterator
+skiplist<K, T, Compare, Allocator>::lower_bound(const K &key) {
+  epoch::guard pin;
+  node *preds[kMaxHeight];
+  node *succs[kMaxHeight];
+  search_(key, preds, succs);
+  return iterator(succs[0]);
+}
+
+template <typename K, typename T, typename Compare, typename Allocator>
+typename skiplist<K, T, Compare, Allocator>::iterator
+skiplist<K, T, Compare, Allocator>::upper_bound(const K &key) {
+  iterator it = lower_bound(key);
+  if (it != end() && !comp_(key, key_of(*it))) ++it;
+  return it;
+}
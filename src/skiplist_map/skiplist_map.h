@@ -0,0 +1,50 @@
+#ifndef SKIPLIST_MAP_H
+#define SKIPLIST_MAP_H
+#include <initializer_list>
+#include <stdexcept>
+#include <vector>
+
+#include "../skiplist/skiplist.h"
+namespace s21 {
+// Ordered map for many concurrent writers, see skiplist.h. Keys are const
+// in the nodes. Changing a value found through an iterator is not
+// synchronized with other threads reading it.
+template <typename K, typename V, typename Compare = std::less<K>,
+          typename Allocator = std::allocator<std::pair<const K, V>>>
+class skiplist_map
+    : public skiplist<K, std::pair<const K, V>, Compare, Allocator> {
+  using base = skiplist<K, std::pair<const K, V>, Compare, Allocator>;
+
+ public:
+  using typename base::const_iterator;
+  using typename base::iterator;
+  using key_type = K;
+  using mapped_type = V;
+  using value_type = std::pair<const K, V>;
+  using reference = value_type &;
+  using const_reference = const value_type &;
+  using size_type = size_t;
+  using allocator_type = Allocator;
+
+  skiplist_map() = default;
+  explicit skiplist_map(const Allocator &alloc) : base(alloc){};
+  explicit skiplist_map(const Compare &comp,
+                        const Allocator &alloc = Allocator())
+      : base(comp, alloc){};
+  skiplist_map(std::initializer_list<value_type> const &items,
+               const Allocator &alloc = Allocator());
+  template <typename InputIt>
+  skiplist_map(InputIt first, InputIt last,
+               const Allocator &alloc = Allocator());
+
+  V &at(const K &key);
+  V &operator[](const K &key);
+
+  std::pair<iterator, bool> insert(const value_type &value);
+  std::pair<iterator, bool> insert(const K &key, const V &obj);
+  template <typename... Args>
+  std::vector<std::pair<iterator, bool>> insert_many(Args &&...args);
+};
+}  // namespace s21
+#include "skiplist_map.tpp"
+#endif  // SKIPLIST_MAP_H
@@ -0,0 +1,52 @@
+#include "skiplist_map.h"
+namespace s21 {
+
+template <typename K, typename V, typename Compare, typename Allocator>
+skiplist_map<K, V, Compare, Allocator>::skiplist_map(
+    const std::initializer_list<value_type> &items, const Allocator &alloc)
+    : skiplist_map(items.begin(), items.end(), alloc) {}
+
+template <typename K, typename V, typename Compare, typename Allocator>
+template <typename InputIt>
+skiplist_map<K, V, Compare, Allocator>::skiplist_map(InputIt first,
+                                                     InputIt last,
+                                                     const Allocator &alloc)
+    : base(alloc) {
+  for (; first != last; ++first) insert(*first);
+}
+
+template <typename K, typename V, typename Compare, typename Allocator>
+V &skiplist_map<K, V, Compare, Allocator>::at(const K &key) {
+  iterator it = this->find(key);
+  if (it == this->end()) throw std::out_of_range("Out of range");
+  return it->second;
+}
+
+template <typename K, typename V, typename Compare, typename Allocator>
+V &skiplist_map<K, V, Compare, Allocator>::operator[](const K &key) {
+  return this->emplace_key_(key, key, mapped_type()).first->second;
+}
+
+template <typename K, typename V, typename Compare, typename Allocator>
+std::pair<typename skiplist_map<K, V, Compare, Allocator>::iterator, bool>
+skiplist_map<K, V, Compare, Allocator>::insert(const value_type &value) {
+  return this->emplace_key_(value.first, value);
+}
+
+template <typename K, typename V, typename Compare, typename Allocator>
+std::pair<typename skiplist_map<K, V, Compare, Allocator>::iterator, bool>
+skiplist_map<K, V, Compare, Allocator>::insert(const K &key, const V &obj) {
+  return this->emplace_key_(key, key, obj);
+}
+
+template <typename K, typename V, typename Compare, typename Allocator>
+template <typename... Args>
+std::vector<
+    std::pair<typename skiplist_map<K, V, Compare, Allocator>::iterator, bool>>
+skiplist_map<K, V, Compare, Allocator>::insert_many(Args &&...args) {
+  std::vector<std::pair<iterator, bool>> res;
+  for (const auto &arg : {args...}) res.push_back(insert(arg));
+  return res;
+}
+
+}  // namespace s21
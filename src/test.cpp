@@ -3,18 +3,36 @@
 #include <array>
 #include <list>
 #include <map>
+#include <memory_resource>
+#include <mutex>
 #include <queue>
+#include <random>
 #include <set>
 #include <stack>
+#include <unordered_map>
+#include <unordered_set>
 #include <string>
+#include <string_view>
+#include <thread>
 #include <vector>
 
 #include "array/s21_array.h"
+#include "btree_map/btree_map.h"
+#include "btree_multiset/btree_multiset.h"
+#include "btree_set/btree_set.h"
+#include "concurrent_map/concurrent_map.h"
+#include "flat_map/flat_map.h"
+#include "flat_multiset/flat_multiset.h"
+#include "flat_set/flat_set.h"
 #include "map/map.h"
 #include "multiset/multiset.h"
+#include "persistent_map/persistent_map.h"
 #include "queue/s21_queue.h"
 #include "set/set.h"
+#include "skiplist_map/skiplist_map.h"
 #include "stack/s21_stack.h"
+#include "unordered_map/unordered_map.h"
+#include "unordered_set/unordered_set.h"
 #include "vector/s21_vector.h"
 
 template <typename T, std::size_t N>
@@ -1097,6 +1115,1144 @@ TEST(S21MapTests, Erase2) {
   EXPECT_FALSE(m.contains(-30));
 }
 
+TEST(S21MapTests, InsertEraseChurn) {
+  s21::map<int, std::string> m;
+  std::map<int, std::string> orig;
+
+  for (int round = 0; round < 3; ++round) {
+    for (int i = 0; i < 2000; ++i) {
+      m.insert(i * 7 % 2003, std::to_string(i));
+      orig.insert(std::make_pair(i * 7 % 2003, std::to_string(i)));
+    }
+    for (int i = 0; i < 2000; i += 3) {
+      auto iter = m.begin();
+      for (int j = 0; j < 5 && iter != m.end(); ++j) ++iter;
+      if (iter == m.end()) break;
+      orig.erase((*iter).first);
+      m.erase(iter);
+    }
+    EXPECT_EQ(m.size(), orig.size());
+    auto my_it = m.begin();
+    for (auto orig_it = orig.begin(); orig_it != orig.end(); ++orig_it) {
+      EXPECT_EQ((*my_it).first, orig_it->first);
+      EXPECT_EQ((*my_it).second, orig_it->second);
+      ++my_it;
+    }
+    m.clear();
+    orig.clear();
+    EXPECT_TRUE(m.empty());
+  }
+}
+
+TEST(S21MapTests, IteratorStableAcrossInserts) {
+  s21::map<int, int> m;
+  auto [iter, inserted] = m.insert(500, -1);
+  for (int i = 0; i < 1000; ++i) m.insert(i, i);
+
+  --iter;
+  ++iter;
+  EXPECT_EQ((*iter).first, 500);
+  EXPECT_EQ((*iter).second, -1);
+  ++iter;
+  EXPECT_EQ((*iter).first, 501);
+}
+
+TEST(S21SetTests, InsertReturnsInsertedKey) {
+  for (int middle : {2, 4}) {
+    s21::set<int> s = {1, 3, 5};
+    s.insert(middle == 2 ? 6 : 0);
+    auto [iter, inserted] = s.insert(middle);
+    --iter;
+    ++iter;
+    EXPECT_TRUE(inserted);
+    EXPECT_EQ(*iter, middle);
+  }
+  s21::set<int> s = {1, 3};
+  auto [iter, inserted] = s.insert(2);
+  --iter;
+  ++iter;
+  EXPECT_EQ(*iter, 2);
+}
+
+// Tells which core a container is built on, the invariants differ.
+template <typename K, typename T, typename C, typename A, bool M>
+std::true_type on_btree(const btree<K, T, C, A, M> *);
+std::false_type on_btree(const void *);
+template <typename K, typename T, typename H, typename E, typename A>
+std::true_type on_hash_table(const hash_table<K, T, H, E, A> *);
+std::false_type on_hash_table(const void *);
+
+// Reaches into container internals to check their invariants. Trees get
+// the AVL shape, parent links and end_ bookkeeping. B+-trees get equal leaf
+// depth, node fill, parent links, separator bounds and the leaf chain. Hash
+// tables get probe runs without gaps and mirrored control bytes.
+template <typename Container>
+struct checked : Container {
+  using Container::Container;
+  using K = typename Container::key_type;
+  checked() = default;
+  explicit checked(const Container &c) : Container(c) {}
+
+  bool valid() {
+    if constexpr (decltype(on_btree(std::declval<Container *>()))::value)
+      return btree_valid();
+    else if constexpr (decltype(on_hash_table(
+                           std::declval<Container *>()))::value)
+      return hash_valid();
+    else
+      return tree_valid();
+  }
+  int height() { return this->root->height; }
+
+ private:
+  bool tree_valid() {
+    if (this->root == &this->end_) return this->size_ == 0;
+    bool ok = this->root->parent == &this->end_ &&
+              this->end_.parent == this->root &&
+              this->end_.right == Container::min(this->root) &&
+              this->end_.left == Container::max(this->root) &&
+              this->root->count == this->size_;
+    check(this->root, ok);
+    return ok;
+  }
+  template <typename Node>
+  int check(Node *node, bool &ok) {
+    if (!node) return -1;
+    Node *l = node->left;
+    Node *r = node->right;
+    if (l && (l->parent != node || !this->less_(l->key(), node->key())))
+      ok = false;
+    if (r && (r->parent != node || !this->less_(node->key(), r->key())))
+      ok = false;
+    int hl = check(node->left, ok);
+    int hr = check(node->right, ok);
+    if (hl - hr > 1 || hr - hl > 1) ok = false;
+    if (node->height != std::max(hl, hr) + 1) ok = false;
+    size_t count = 1 + node->duplicates;
+    if (l) count += l->count;
+    if (r) count += r->count;
+    if (node->count != count) ok = false;
+    return node->height;
+  }
+
+  bool btree_valid() {
+    using leaf_node = typename Container::leaf_node;
+    if (!this->root_)
+      return !this->size_ && !this->leftmost_ && !this->rightmost_;
+    bool ok = !this->root_->parent;
+    int depth = -1;
+    std::vector<leaf_node *> leaves;
+    check(this->root_, nullptr, nullptr, 0, depth, leaves, ok);
+    size_t size = 0;
+    for (size_t i = 0; i < leaves.size(); ++i) {
+      leaf_node *prev = i ? leaves[i - 1] : nullptr;
+      leaf_node *next = i + 1 < leaves.size() ? leaves[i + 1] : nullptr;
+      if (leaves[i]->prev != prev || leaves[i]->next != next) ok = false;
+      if (prev && prev->count && leaves[i]->count &&
+          this->less_(key(leaves[i]->slots()[0]),
+                      key(prev->slots()[prev->count - 1])))
+        ok = false;
+      size += leaves[i]->count;
+    }
+    return ok && size == this->size_ && this->leftmost_ == leaves.front() &&
+           this->rightmost_ == leaves.back();
+  }
+  static const K &key(const typename Container::value_type &slot) {
+    return Container::key_of(slot);
+  }
+  template <typename Node, typename Leaf>
+  void check(Node *node, const K *lo, const K *hi, int level, int &depth,
+             std::vector<Leaf *> &leaves, bool &ok) {
+    using inner_node = typename Container::inner_node;
+    if (node != this->root_ &&
+        node->count < (node->leaf ? Container::kLeafMin : Container::kInnerMin))
+      ok = false;
+    if (node->leaf) {
+      Leaf *leaf = static_cast<Leaf *>(node);
+      if (depth < 0) depth = level;
+      if (depth != level) ok = false;
+      for (size_t i = 0; i < leaf->count; ++i) {
+        const K &k = key(leaf->slots()[i]);
+        if ((lo && this->less_(k, *lo)) || (hi && this->less_(*hi, k)))
+          ok = false;
+        if (i && this->less_(k, key(leaf->slots()[i - 1]))) ok = false;
+      }
+      leaves.push_back(leaf);
+      return;
+    }
+    inner_node *inner = static_cast<inner_node *>(node);
+    for (size_t i = 0; i <= inner->count; ++i) {
+      if (inner->children[i]->parent != inner) ok = false;
+      check(inner->children[i], i ? inner->keys() + i - 1 : lo,
+            i < inner->count ? inner->keys() + i : hi, level + 1, depth,
+            leaves, ok);
+    }
+  }
+
+  bool hash_valid() {
+    size_t cap = this->capacity_;
+    size_t size = 0;
+    bool ok = true;
+    for (size_t i = 0; i < cap; ++i) {
+      if (i < Container::kGroup - 1 && this->ctrl_[cap + i] != this->ctrl_[i])
+        ok = false;
+      if (this->ctrl_[i] == Container::kEmpty) continue;
+      ++size;
+      size_t hash = this->hash_(Container::key_of(this->slots_[i]));
+      if (this->ctrl_[i] != Container::h2_(hash)) ok = false;
+      for (size_t j = (hash >> 7) & (cap - 1); j != i; j = (j + 1) & (cap - 1))
+        if (this->ctrl_[j] == Container::kEmpty) ok = false;
+    }
+    return ok && size == this->size_ && size <= this->growth_limit_(cap);
+  }
+};
+
+TEST(S21MapTests, CopyKeepsShape) {
+  std::mt19937 gen(11);
+  checked<s21::map<int, int>> m;
+  for (int i = 0; i < 5000; ++i) m.insert(static_cast<int>(gen() % 100000), i);
+  checked<s21::map<int, int>> copy(m);
+  EXPECT_TRUE(copy.valid());
+  EXPECT_EQ(copy.height(), m.height());
+  ASSERT_EQ(copy.size(), m.size());
+  auto it = copy.begin();
+  for (const auto &item : m) {
+    EXPECT_EQ(*it, item);
+    ++it;
+  }
+
+  checked<s21::multiset<int>> ms;
+  for (int i = 0; i < 300; ++i) ms.insert(i % 7);
+  checked<s21::multiset<int>> ms_copy(ms);
+  EXPECT_TRUE(ms_copy.valid());
+  EXPECT_EQ(ms_copy.size(), 300U);
+  EXPECT_EQ(ms_copy.count(3), ms.count(3));
+
+  s21::map<int, int> empty;
+  s21::map<int, int> empty_copy(empty);
+  EXPECT_TRUE(empty_copy.begin() == empty_copy.end());
+  empty_copy.insert(1, 1);
+  EXPECT_EQ(empty_copy.size(), 1U);
+}
+
+struct ThrowingCopy {
+  ThrowingCopy() = default;
+  ThrowingCopy(const ThrowingCopy &other) : text(other.text) {
+    if (budget >= 0 && budget-- == 0) throw std::runtime_error("copy");
+  }
+  std::string text = std::string(32, 'x');
+  static int budget;
+};
+int ThrowingCopy::budget = -1;
+
+TEST(S21MapTests, CopyThrows) {
+  s21::map<int, ThrowingCopy> m;
+  for (int i = 0; i < 100; ++i) m[i];
+  ThrowingCopy::budget = 50;
+  using map_type = s21::map<int, ThrowingCopy>;
+  EXPECT_THROW(map_type copy(m), std::runtime_error);
+  ThrowingCopy::budget = -1;
+  s21::map<int, ThrowingCopy> copy(m);
+  EXPECT_EQ(copy.size(), 100U);
+}
+
+TEST(S21SetTests, SwapWithEmpty) {
+  checked<s21::set<int>> empty;
+  checked<s21::set<int>> full{1, 2, 3};
+  empty.swap(full);
+  EXPECT_TRUE(full.empty());
+  EXPECT_TRUE(full.begin() == full.end());
+  full.insert(7);
+  empty.insert(4);
+  EXPECT_TRUE(full.valid());
+  EXPECT_TRUE(empty.valid());
+  EXPECT_EQ(full.size(), 1);
+  EXPECT_EQ(empty.size(), 4);
+  std::vector<int> keys;
+  for (auto it = empty.begin(); it != empty.end(); ++it) keys.push_back(*it);
+  EXPECT_EQ(keys, std::vector<int>({1, 2, 3, 4}));
+  EXPECT_EQ(*full.begin(), 7);
+
+  checked<s21::set<int>> other;
+  full.clear();
+  full.swap(other);
+  full.insert(1);
+  other.insert(2);
+  EXPECT_TRUE(full.valid());
+  EXPECT_TRUE(other.valid());
+}
+
+TEST(S21MapTests, RangeCtorSorted) {
+  std::vector<std::pair<int, std::string>> items;
+  for (int i = 0; i < 1000; ++i) items.emplace_back(i, std::to_string(i));
+  checked<s21::map<int, std::string>> m(items.begin(), items.end());
+
+  EXPECT_TRUE(m.valid());
+  EXPECT_EQ(m.size(), 1000);
+  auto last = m.end();
+  --last;
+  EXPECT_EQ((*m.begin()).first, 0);
+  EXPECT_EQ((*last).first, 999);
+  int expected = 0;
+  for (auto iter = m.begin(); iter != m.end(); ++iter, ++expected) {
+    EXPECT_EQ((*iter).first, expected);
+    EXPECT_EQ((*iter).second, std::to_string(expected));
+  }
+
+  m.insert(-1, "-1");
+  m.insert(1000, "1000");
+  m.erase(m.begin());
+  EXPECT_TRUE(m.valid());
+  EXPECT_EQ(m.size(), 1001);
+  last = m.end();
+  --last;
+  EXPECT_EQ((*m.begin()).first, 0);
+  EXPECT_EQ((*last).first, 1000);
+}
+
+TEST(S21SetTests, AssignSorted) {
+  checked<s21::set<int>> s = {100, 200};
+  std::vector<int> sorted = {1, 2, 2, 3, 5, 8, 8, 13};
+  s.assign_sorted(sorted.begin(), sorted.end());
+  EXPECT_TRUE(s.valid());
+  std::set<int> orig(sorted.begin(), sorted.end());
+  EXPECT_EQ(s.size(), orig.size());
+  auto my_it = s.begin();
+  for (auto orig_it = orig.begin(); orig_it != orig.end(); ++orig_it, ++my_it)
+    EXPECT_EQ(*my_it, *orig_it);
+
+  std::vector<int> unsorted = {1, 4, 9, 3, 7, 2, 10, 0, 4};
+  s.assign_sorted(unsorted.begin(), unsorted.end());
+  EXPECT_TRUE(s.valid());
+  orig = std::set<int>(unsorted.begin(), unsorted.end());
+  EXPECT_EQ(s.size(), orig.size());
+  my_it = s.begin();
+  for (auto orig_it = orig.begin(); orig_it != orig.end(); ++orig_it, ++my_it)
+    EXPECT_EQ(*my_it, *orig_it);
+}
+
+TEST(S21MultisetTests, RangeCtorDuplicates) {
+  std::vector<int> items = {1, 1, 1, 2, 3, 3, 7, 7, 7, 7, 5, 1};
+  checked<s21::multiset<int>> ms(items.begin(), items.end());
+  std::multiset<int> orig(items.begin(), items.end());
+
+  EXPECT_TRUE(ms.valid());
+  EXPECT_EQ(ms.size(), orig.size());
+  EXPECT_EQ(ms.count(1), 4);
+  EXPECT_EQ(ms.count(7), 4);
+  EXPECT_EQ(ms.count(5), 1);
+  auto my_it = ms.begin();
+  for (auto orig_it = orig.begin(); orig_it != orig.end(); ++orig_it, ++my_it)
+    EXPECT_EQ(*my_it, *orig_it);
+}
+
+TEST(S21MultisetTests, EqualRangeDuplicates) {
+  s21::multiset<int> ms;
+  std::multiset<int> orig;
+  for (int i = 0; i < 300; ++i) {
+    ms.insert(i * 37 % 50);
+    orig.insert(i * 37 % 50);
+  }
+  for (int key = -1; key <= 50; ++key) {
+    auto [first, last] = ms.equal_range(key);
+    auto [orig_first, orig_last] = orig.equal_range(key);
+    size_t count = 0;
+    for (; first != last; ++first, ++orig_first, ++count)
+      EXPECT_EQ(*first, *orig_first);
+    EXPECT_EQ(count, orig.count(key));
+    EXPECT_TRUE(orig_first == orig_last);
+    if (orig_last == orig.end())
+      EXPECT_TRUE(last == ms.end());
+    else
+      EXPECT_EQ(*last, *orig_last);
+  }
+}
+
+TEST(S21SetTests, Bounds) {
+  s21::set<int> s = {10, 20, 30, 40, 50};
+  EXPECT_EQ(*s.lower_bound(20), 20);
+  EXPECT_EQ(*s.upper_bound(20), 30);
+  EXPECT_EQ(*s.lower_bound(21), 30);
+  EXPECT_EQ(*s.lower_bound(-5), 10);
+  EXPECT_TRUE(s.lower_bound(51) == s.end());
+  EXPECT_TRUE(s.upper_bound(50) == s.end());
+
+  auto [first, last] = s.equal_range(40);
+  EXPECT_EQ(*first, 40);
+  EXPECT_EQ(*last, 50);
+  auto range = s.equal_range(45);
+  EXPECT_TRUE(range.first == range.second);
+}
+
+TEST(S21MapTests, Bounds) {
+  s21::map<int, std::string> m = {{1, "one"}, {5, "five"}, {9, "nine"}};
+  EXPECT_EQ((*m.lower_bound(5)).second, "five");
+  EXPECT_EQ((*m.upper_bound(5)).second, "nine");
+  EXPECT_EQ((*m.lower_bound(2)).first, 5);
+  EXPECT_TRUE(m.upper_bound(9) == m.end());
+
+  int count = 0;
+  for (auto iter = m.lower_bound(1); iter != m.upper_bound(5); ++iter) ++count;
+  EXPECT_EQ(count, 2);
+  auto [first, last] = m.equal_range(9);
+  ++first;
+  EXPECT_TRUE(first == last);
+}
+
+TEST(S21SetTests, OrderStatistics) {
+  checked<s21::set<int>> s;
+  std::set<int> orig;
+  std::mt19937 gen(3);
+  for (int i = 0; i < 3000; ++i) {
+    int key = static_cast<int>(gen() % 1000);
+    if (gen() % 3) {
+      s.insert(key);
+      orig.insert(key);
+    } else if (s.contains(key)) {
+      s.erase(s.find(key));
+      orig.erase(key);
+    }
+  }
+  EXPECT_TRUE(s.valid());
+  ASSERT_EQ(s.size(), orig.size());
+  size_t k = 0;
+  for (int key : orig) {
+    EXPECT_EQ(*s.nth(k), key);
+    EXPECT_EQ(s.rank(key), k);
+    ++k;
+  }
+  EXPECT_TRUE(s.nth(s.size()) == s.end());
+  EXPECT_EQ(s.rank(-1), 0);
+  EXPECT_EQ(s.rank(1000), orig.size());
+  EXPECT_EQ(s.count_range(100, 200),
+            std::distance(orig.lower_bound(100), orig.lower_bound(200)));
+  EXPECT_EQ(s.count_range(200, 100), 0);
+}
+
+TEST(S21MultisetTests, OrderStatistics) {
+  checked<s21::multiset<int>> s = {5, 1, 3, 3, 3, 7, 1};
+  EXPECT_TRUE(s.valid());
+  std::vector<int> sorted = {1, 1, 3, 3, 3, 5, 7};
+  for (size_t k = 0; k < sorted.size(); ++k) EXPECT_EQ(*s.nth(k), sorted[k]);
+  auto it = s.nth(3);
+  EXPECT_EQ(*++it, 3);
+  EXPECT_EQ(*++it, 5);
+  EXPECT_EQ(s.rank(3), 2);
+  EXPECT_EQ(s.rank(4), 5);
+  EXPECT_EQ(s.count_range(1, 4), 5);
+  EXPECT_EQ(s.count_range(3, 3), 0);
+
+  s.erase(s.find(3));
+  s.erase(s.find(1));
+  s.erase(s.find(1));
+  EXPECT_TRUE(s.valid());
+  EXPECT_EQ(s.size(), 4);
+  EXPECT_EQ(*s.nth(0), 3);
+  EXPECT_EQ(s.rank(5), 2);
+  EXPECT_EQ(s.count_range(0, 100), 4);
+}
+
+struct CopyCounter {
+  static int copies;
+  CopyCounter() = default;
+  CopyCounter(const CopyCounter &) { ++copies; }
+  CopyCounter(CopyCounter &&) = default;
+  CopyCounter &operator=(CopyCounter &&) = default;
+  CopyCounter &operator=(const CopyCounter &) {
+    ++copies;
+    return *this;
+  }
+  int tag = 0;
+};
+int CopyCounter::copies = 0;
+
+TEST(S21MapTests, KeysAreConst) {
+  s21::map<int, int> m{{1, 2}};
+  s21::set<int> s{1};
+  s21::multiset<int> ms{1};
+  static_assert(std::is_same_v<decltype((*m.begin()).first), const int>);
+  static_assert(std::is_same_v<decltype(*s.begin()), const int &>);
+  static_assert(std::is_same_v<decltype(*ms.begin()), const int &>);
+  (*m.begin()).second = 3;
+  EXPECT_EQ(m.at(1), 3);
+}
+
+TEST(S21MapTests, IteratorsDoNotCopy) {
+  s21::map<int, CopyCounter> m;
+  for (int i = 0; i < 100; ++i) m.insert(i, CopyCounter());
+  CopyCounter::copies = 0;
+  int keys = 0;
+  for (auto it = m.begin(); it != m.end(); ++it) keys += (*it).first;
+  auto last = m.end();
+  --last;
+  m.upper_bound(50);
+  m.lower_bound(10);
+  EXPECT_EQ(keys, 4950);
+  EXPECT_EQ(CopyCounter::copies, 0);
+  m.insert(5, CopyCounter());
+  EXPECT_EQ(CopyCounter::copies, 0);
+
+  (*m.lower_bound(7)).second.tag = 42;
+  (*last).second.tag = 99;
+  EXPECT_EQ(m.at(7).tag, 42);
+  EXPECT_EQ(m.at(99).tag, 99);
+}
+
+struct CountedKey {
+  static int comparisons;
+  int key = 0;
+  bool operator<(const CountedKey &other) const {
+    ++comparisons;
+    return key < other.key;
+  }
+  bool operator>(const CountedKey &other) const { return other < *this; }
+  bool operator!=(const CountedKey &other) const {
+    return *this < other || other < *this;
+  }
+};
+int CountedKey::comparisons = 0;
+
+TEST(S21SetTests, ScanWithoutComparisons) {
+  s21::set<CountedKey> s;
+  for (int i = 0; i < 1000; ++i) s.insert(CountedKey{(i * 7919) % 1000});
+  CountedKey::comparisons = 0;
+  int expected = 0;
+  for (auto it = s.begin(); it != s.end(); ++it) {
+    EXPECT_EQ((*it).key, expected++);
+  }
+  auto it = s.end();
+  for (int i = 999; i >= 0; --i) {
+    --it;
+    EXPECT_EQ((*it).key, i);
+  }
+  EXPECT_TRUE(it == s.begin());
+  EXPECT_EQ(CountedKey::comparisons, 0);
+}
+
+TEST(S21SetTests, HintedInsert) {
+  checked<s21::set<CountedKey>> s;
+  CountedKey::comparisons = 0;
+  for (int i = 0; i < 1000; ++i) s.insert(s.end(), CountedKey{i});
+  EXPECT_LE(CountedKey::comparisons, 1000);
+  EXPECT_TRUE(s.valid());
+
+  checked<s21::set<int>> down;
+  auto pos = down.end();
+  for (int i = 1000; i > 0; --i) pos = down.insert(pos, i);
+  EXPECT_TRUE(down.valid());
+  EXPECT_EQ(down.size(), 1000U);
+  EXPECT_EQ(*down.begin(), 1);
+  EXPECT_EQ(*down.emplace_hint(down.begin(), 0), 0);
+  EXPECT_EQ(*down.insert(down.end(), 500), 500);
+  EXPECT_EQ(down.size(), 1001U);
+
+  // Wrong hints still find the place.
+  std::mt19937 gen(5);
+  std::set<int> expected;
+  checked<s21::set<int>> random;
+  for (int i = 0; i < 2000; ++i) {
+    int key = static_cast<int>(gen() % 500);
+    auto hint = random.lower_bound(static_cast<int>(gen() % 500));
+    EXPECT_EQ(*random.insert(hint, key), key);
+    expected.insert(key);
+  }
+  EXPECT_TRUE(random.valid());
+  EXPECT_TRUE(std::equal(expected.begin(), expected.end(), random.begin()));
+}
+
+TEST(S21MapTests, HintedInsert) {
+  checked<s21::map<int, std::string>> m;
+  for (int i = 0; i < 1000; i += 2)
+    m.emplace_hint(m.end(), i, std::to_string(i));
+  for (int i = 1; i < 1000; i += 2)
+    m.insert(m.find(i - 1), std::make_pair(i, std::to_string(i)));
+  EXPECT_TRUE(m.valid());
+  EXPECT_EQ(m.size(), 1000U);
+  auto it = m.emplace_hint(m.find(10), 10, "x");
+  EXPECT_EQ((*it).second, "10");
+  int expected = 0;
+  for (const auto &item : m) EXPECT_EQ(item.second, std::to_string(expected++));
+}
+
+// Neither copyable nor movable, only emplace can put it into a map.
+struct Pinned {
+  Pinned() = default;
+  explicit Pinned(int v) : value(v) {}
+  Pinned(const Pinned &) = delete;
+  Pinned &operator=(const Pinned &) = delete;
+  int value = 0;
+};
+
+TEST(S21MapTests, HintedEmplaceBuildsInPlace) {
+  checked<s21::map<int, Pinned>> m;
+  for (int i = 0; i < 100; ++i)
+    m.emplace_hint(m.end(), std::piecewise_construct, std::make_tuple(i),
+                   std::make_tuple(i));
+  auto it = m.emplace_hint(m.begin(), std::piecewise_construct,
+                           std::make_tuple(50), std::make_tuple(-1));
+  EXPECT_TRUE(m.valid());
+  EXPECT_EQ(m.size(), 100U);
+  EXPECT_EQ((*it).second.value, 50);
+}
+
+TEST(S21MultisetTests, HintedInsert) {
+  checked<s21::multiset<int>> ms;
+  auto pos = ms.end();
+  for (int i = 0; i < 300; ++i) pos = ms.insert(pos, i / 3);
+  ms.emplace_hint(ms.begin(), 0);
+  ms.insert(ms.find(50), 51);
+  EXPECT_TRUE(ms.valid());
+  EXPECT_EQ(ms.size(), 302U);
+  EXPECT_EQ(ms.count(0), 4U);
+  EXPECT_EQ(ms.count(51), 4U);
+  EXPECT_EQ(ms.count(99), 3U);
+}
+
+struct AllocCounter {
+  size_t allocations = 0;
+  size_t deallocations = 0;
+};
+
+template <typename T>
+struct counting_allocator {
+  using value_type = T;
+
+  explicit counting_allocator(AllocCounter *c) : counter(c) {}
+  template <typename U>
+  counting_allocator(const counting_allocator<U> &other)
+      : counter(other.counter) {}
+
+  T *allocate(size_t n) {
+    ++counter->allocations;
+    return std::allocator<T>().allocate(n);
+  }
+  void deallocate(T *p, size_t n) {
+    ++counter->deallocations;
+    std::allocator<T>().deallocate(p, n);
+  }
+  bool operator==(const counting_allocator &other) const {
+    return counter == other.counter;
+  }
+  bool operator!=(const counting_allocator &other) const {
+    return counter != other.counter;
+  }
+
+  AllocCounter *counter;
+};
+
+TEST(S21MapTests, CountingAllocator) {
+  AllocCounter counter;
+  using alloc = counting_allocator<std::pair<const int, int>>;
+  {
+    s21::map<int, int, std::less<int>, alloc> m{alloc(&counter)};
+    EXPECT_EQ(counter.allocations, 0);
+
+    // The first block has room for 7 nodes, the second one for 15.
+    m.insert(0, 0);
+    EXPECT_EQ(counter.allocations, 1);
+    for (int i = 1; i < 7; ++i) m.insert(i, i);
+    EXPECT_EQ(counter.allocations, 1);
+    m.insert(7, 7);
+    EXPECT_EQ(counter.allocations, 2);
+
+    m.erase(m.begin());
+    m.insert(100, 100);
+    m[3] = 30;
+    EXPECT_EQ(counter.allocations, 2);
+    EXPECT_EQ(counter.deallocations, 0);
+
+    // A copy takes one block for all its nodes.
+    s21::map<int, int, std::less<int>, alloc> copy(m);
+    EXPECT_EQ(copy.size(), m.size());
+    EXPECT_EQ(counter.allocations, 3);
+
+    m.clear();
+    EXPECT_EQ(counter.deallocations, 2);
+    m.insert(1, 1);
+    EXPECT_EQ(counter.allocations, 4);
+  }
+  EXPECT_EQ(counter.allocations, counter.deallocations);
+}
+
+TEST(S21MapTests, CountingAllocatorMoveSwap) {
+  AllocCounter counter;
+  using alloc = counting_allocator<int>;
+  {
+    s21::set<int, std::less<int>, alloc> s1({1, 2, 3}, alloc(&counter));
+    s21::multiset<int, std::less<int>, alloc> ms({4, 4, 5}, alloc(&counter));
+    EXPECT_EQ(counter.allocations, 2);
+
+    s21::set<int, std::less<int>, alloc> s2(std::move(s1));
+    s21::set<int, std::less<int>, alloc> s3({7}, alloc(&counter));
+    s2.swap(s3);
+    EXPECT_EQ(counter.allocations, 3);
+    EXPECT_EQ(counter.deallocations, 0);
+    EXPECT_EQ(s3.size(), 3);
+    EXPECT_TRUE(s3.contains(2));
+  }
+  EXPECT_EQ(counter.allocations, counter.deallocations);
+}
+
+TEST(S21MapTests, PmrArena) {
+  char buffer[1 << 16];
+  std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer),
+                                            std::pmr::null_memory_resource());
+  s21::pmr::map<int, int> m(&arena);
+  s21::pmr::set<int> s(&arena);
+  s21::pmr::multiset<int> ms(&arena);
+  for (int i = 0; i < 300; ++i) {
+    m.insert(i, i * 2);
+    s.insert(i % 50);
+    ms.insert(i % 50);
+  }
+  EXPECT_EQ(m.get_allocator().resource(), &arena);
+  EXPECT_EQ(m.size(), 300);
+  EXPECT_EQ(m.at(150), 300);
+  EXPECT_EQ(s.size(), 50);
+  EXPECT_EQ(ms.size(), 300);
+  EXPECT_EQ(ms.count(7), 6);
+}
+
+TEST(S21SetTests, MergeOverlapping) {
+  checked<s21::set<int>> s1;
+  checked<s21::set<int>> s2;
+  std::set<int> o1, o2;
+  for (int i = 0; i < 2000; i += 2) {
+    s1.insert(i);
+    o1.insert(i);
+  }
+  for (int i = 0; i < 3000; i += 3) {
+    s2.insert(i);
+    o2.insert(i);
+  }
+  s1.merge(s2);
+  o1.merge(o2);
+  EXPECT_TRUE(s1.valid());
+  EXPECT_TRUE(s2.valid());
+  EXPECT_TRUE(std::equal(o1.begin(), o1.end(), s1.begin()));
+  EXPECT_TRUE(std::equal(o2.begin(), o2.end(), s2.begin()));
+  EXPECT_EQ(s1.size(), o1.size());
+  EXPECT_EQ(s2.size(), o2.size());
+  s2.insert(-1);
+  EXPECT_EQ(*s2.begin(), -1);
+}
+
+TEST(S21SetTests, MergeSmallIntoLarge) {
+  checked<s21::set<int>> s1;
+  for (int i = 0; i < 1000; ++i) s1.insert(i);
+  checked<s21::set<int>> s2 = {-5, 10, 500, 2000};
+  s1.merge(s2);
+  EXPECT_TRUE(s1.valid());
+  EXPECT_TRUE(s2.valid());
+  EXPECT_EQ(s1.size(), 1002);
+  EXPECT_EQ(s2.size(), 2);
+  EXPECT_EQ(*s2.begin(), 10);
+  EXPECT_EQ(*s1.begin(), -5);
+}
+
+TEST(S21SetTests, MergeDisjointReusesNodes) {
+  AllocCounter counter;
+  using alloc = counting_allocator<int>;
+  {
+    checked<s21::set<int, std::less<int>, alloc>> s1{alloc(&counter)};
+    checked<s21::set<int, std::less<int>, alloc>> s2{alloc(&counter)};
+    for (int i = 0; i < 100; ++i) s1.insert(i);
+    for (int i = 100; i < 200; ++i) s2.insert(i);
+    size_t allocations = counter.allocations;
+    s1.merge(s2);
+    EXPECT_EQ(counter.allocations, allocations);
+    EXPECT_EQ(counter.deallocations, 0);
+    EXPECT_TRUE(s1.valid());
+    EXPECT_TRUE(s2.empty());
+    EXPECT_EQ(s1.size(), 200);
+    EXPECT_EQ(*s1.nth(150), 150);
+  }
+  EXPECT_EQ(counter.allocations, counter.deallocations);
+}
+
+TEST(S21MapTests, MergeDifferentAllocators) {
+  std::pmr::monotonic_buffer_resource r1, r2;
+  checked<s21::pmr::map<int, std::string>> m1{&r1};
+  checked<s21::pmr::map<int, std::string>> m2{&r2};
+  for (int i = 0; i < 50; ++i) m1.insert(i * 2, "a");
+  for (int i = 0; i < 50; ++i) m2.insert(i * 3, "b");
+  m1.merge(m2);
+  EXPECT_TRUE(m1.valid());
+  EXPECT_TRUE(m2.valid());
+  EXPECT_EQ(m1.size(), 50 + 33);
+  EXPECT_EQ(m2.size(), 17);
+  EXPECT_EQ(m1.at(3), "b");
+  EXPECT_EQ(m1.at(6), "a");
+  EXPECT_EQ(m2.at(6), "b");
+}
+
+TEST(S21MultisetTests, MergeDuplicates) {
+  checked<s21::multiset<int>> s1;
+  checked<s21::multiset<int>> s2;
+  std::multiset<int> orig;
+  for (int i = 0; i < 500; ++i) {
+    s1.insert(i % 100);
+    s2.insert(i % 70);
+    orig.insert(i % 100);
+    orig.insert(i % 70);
+  }
+  s1.merge(s2);
+  EXPECT_TRUE(s1.valid());
+  EXPECT_TRUE(s2.empty());
+  EXPECT_EQ(s1.size(), orig.size());
+  EXPECT_EQ(s1.count(5), orig.count(5));
+  EXPECT_EQ(s1.count(90), orig.count(90));
+  EXPECT_EQ(*s1.nth(700), *std::next(orig.begin(), 700));
+}
+
+TEST(S21MapTests, NodeHandles) {
+  AllocCounter counter;
+  using alloc = counting_allocator<std::pair<const int, CopyCounter>>;
+  using map = checked<s21::map<int, CopyCounter, std::less<int>, alloc>>;
+  {
+    map m{alloc(&counter)};
+    map other{alloc(&counter)};
+    for (int i = 0; i < 100; ++i)
+      (*m.insert(i, CopyCounter()).first).second.tag = i;
+    other.insert(-1, CopyCounter());
+    size_t allocations = counter.allocations;
+    CopyCounter::copies = 0;
+
+    // Rekeying relinks the same node.
+    auto node = m.extract(10);
+    EXPECT_EQ(m.size(), 99);
+    EXPECT_FALSE(m.contains(10));
+    EXPECT_EQ(node.key(), 10);
+    node.key() = 1000;
+    auto res = m.insert(std::move(node));
+    EXPECT_TRUE(res.inserted);
+    EXPECT_TRUE(res.node.empty());
+    EXPECT_EQ((*res.position).first, 1000);
+    EXPECT_EQ((*res.position).second.tag, 10);
+
+    // An equal key leaves the node in the result.
+    node = m.extract(m.begin());
+    node.key() = 50;
+    res = m.insert(std::move(node));
+    EXPECT_FALSE(res.inserted);
+    EXPECT_EQ(res.node.mapped().tag, 0);
+    EXPECT_EQ((*res.position).second.tag, 50);
+    res.node = map::node_type();
+    EXPECT_EQ(m.size(), 99);
+
+    // Another map takes the key and value into its own pool.
+    auto moved = other.insert(m.extract(20));
+    EXPECT_TRUE(moved.inserted);
+    EXPECT_EQ(other.at(20).tag, 20);
+    EXPECT_EQ(m.size(), 98);
+
+    EXPECT_TRUE(m.extract(20).empty());
+    EXPECT_FALSE(m.insert(map::node_type()).inserted);
+    EXPECT_TRUE(m.valid());
+    EXPECT_TRUE(other.valid());
+    EXPECT_EQ(counter.allocations, allocations);
+    EXPECT_EQ(CopyCounter::copies, 0);
+  }
+  EXPECT_EQ(counter.allocations, counter.deallocations);
+}
+
+TEST(S21SetTests, NodeHandles) {
+  checked<s21::set<std::string>> s;
+  for (int i = 0; i < 50; ++i) s.insert(std::to_string(i));
+  auto node = s.extract("7");
+  node.key() = "x";
+  auto res = s.insert(std::move(node));
+  EXPECT_TRUE(res.inserted);
+  EXPECT_EQ(*res.position, "x");
+  EXPECT_FALSE(s.contains("7"));
+  EXPECT_EQ(s.size(), 50);
+  EXPECT_TRUE(s.valid());
+}
+
+TEST(S21SetTests, MergeWithHandleOut) {
+  s21::set<int> other;
+  for (int i = 0; i < 100; ++i) other.insert(i);
+  auto node = other.extract(50);
+  {
+    s21::set<int> self{1000, 1001};
+    self.merge(other);
+    EXPECT_EQ(self.size(), 101);
+    EXPECT_TRUE(other.empty());
+  }
+  EXPECT_EQ(node.key(), 50);
+  node = s21::set<int>::node_type();
+  other.insert(node.empty() ? 7 : 0);
+  EXPECT_TRUE(other.contains(7));
+}
+
+TEST(S21SetTests, ClearAndSplitWithHandleOut) {
+  checked<s21::set<std::string>> s;
+  for (int i = 0; i < 100; ++i) s.insert(std::to_string(i));
+  auto node = s.extract("5");
+  s.clear();
+  EXPECT_TRUE(s.valid());
+  s.insert("x");
+  node = s21::set<std::string>::node_type();
+
+  for (int i = 0; i < 100; ++i) s.insert(std::to_string(i));
+  node = s.extract("5");
+  {
+    checked<s21::set<std::string>> right;
+    s.split("1", right);
+    EXPECT_TRUE(s.valid());
+    EXPECT_TRUE(right.valid());
+    EXPECT_EQ(s.size(), 1U);
+    EXPECT_EQ(right.size(), 99U);
+  }
+  EXPECT_EQ(node.key(), "5");
+  node = s21::set<std::string>::node_type();
+  EXPECT_TRUE(node.empty());
+}
+
+TEST(S21MultisetTests, NodeHandles) {
+  checked<s21::multiset<int>> s1{1, 2, 2, 2, 3};
+  checked<s21::multiset<int>> s2{2, 4};
+  auto node = s1.extract(2);
+  EXPECT_EQ(node.count(), 3);
+  EXPECT_EQ(s1.size(), 2);
+  EXPECT_EQ(s1.count(2), 0);
+  auto it = s2.insert(std::move(node));
+  EXPECT_EQ(*it, 2);
+  EXPECT_EQ(s2.count(2), 4);
+  EXPECT_EQ(s2.size(), 5);
+  s2.insert(s2.extract(s2.find(4)));
+  EXPECT_EQ(s2.count(4), 1);
+  EXPECT_TRUE(s1.valid());
+  EXPECT_TRUE(s2.valid());
+}
+
+TEST(S21MultisetTests, BulkCounts) {
+  checked<s21::multiset<int>> s{1, 2, 2, 9};
+  const size_t many = 3000000000;
+  auto it = s.insert(5, many);
+  EXPECT_EQ(*it, 5);
+  EXPECT_EQ(s.count(5), many);
+  EXPECT_EQ(s.size(), many + 4);
+  EXPECT_EQ(*s.nth(many + 2), 5);
+  EXPECT_EQ(*s.nth(many + 3), 9);
+  EXPECT_EQ(s.rank(9), many + 3);
+  EXPECT_TRUE(s.valid());
+
+  s.insert(2, 10);
+  EXPECT_EQ(s.count(2), 12);
+  EXPECT_EQ(s.erase(5, 1000000000), 1000000000);
+  EXPECT_EQ(s.count(5), many - 1000000000);
+  EXPECT_EQ(s.erase(2, 100), 12);
+  EXPECT_FALSE(s.contains(2));
+  EXPECT_EQ(s.erase_all(5), many - 1000000000);
+  EXPECT_EQ(s.erase_all(5), 0);
+  EXPECT_EQ(s.erase(1, 0), 0);
+  EXPECT_TRUE(s.insert(7, 0) == s.end());
+  EXPECT_EQ(s.size(), 2);
+  EXPECT_TRUE(s.valid());
+}
+
+TEST(S21MultisetTests, BulkCountsAgainstStd) {
+  checked<s21::multiset<int>> s;
+  std::multiset<int> orig;
+  std::mt19937 gen(5);
+  for (int i = 0; i < 2000; ++i) {
+    int key = static_cast<int>(gen() % 50);
+    size_t n = gen() % 4;
+    if (gen() % 2) {
+      s.insert(key, n);
+      for (size_t j = 0; j < n; ++j) orig.insert(key);
+    } else {
+      size_t gone = std::min(n, orig.count(key));
+      EXPECT_EQ(s.erase(key, n), gone);
+      for (size_t j = 0; j < gone; ++j) orig.erase(orig.find(key));
+    }
+  }
+  EXPECT_TRUE(s.valid());
+  EXPECT_TRUE(std::equal(orig.begin(), orig.end(), s.begin()));
+  EXPECT_EQ(s.size(), orig.size());
+}
+
+static std::set<int> random_set(size_t n, int range, unsigned seed) {
+  std::mt19937 gen(seed);
+  std::set<int> res;
+  while (res.size() < n) res.insert(static_cast<int>(gen() % range));
+  return res;
+}
+
+TEST(S21SetTests, SetAlgebra) {
+  for (unsigned seed = 0; seed < 20; ++seed) {
+    std::set<int> a = random_set(seed * 40, 2000, seed);
+    std::set<int> b = random_set(300 - seed * 10, 2000, seed + 100);
+    std::vector<int> expected;
+
+    checked<s21::set<int>> u(a.begin(), a.end());
+    u.set_union(s21::set<int>(b.begin(), b.end()));
+    std::set_union(a.begin(), a.end(), b.begin(), b.end(),
+                   std::back_inserter(expected));
+    EXPECT_TRUE(u.valid());
+    ASSERT_EQ(u.size(), expected.size());
+    EXPECT_TRUE(std::equal(expected.begin(), expected.end(), u.begin()));
+
+    expected.clear();
+    checked<s21::set<int>> i(a.begin(), a.end());
+    i.set_intersection(s21::set<int>(b.begin(), b.end()));
+    std::set_intersection(a.begin(), a.end(), b.begin(), b.end(),
+                          std::back_inserter(expected));
+    EXPECT_TRUE(i.valid());
+    ASSERT_EQ(i.size(), expected.size());
+    EXPECT_TRUE(std::equal(expected.begin(), expected.end(), i.begin()));
+
+    expected.clear();
+    checked<s21::set<int>> d(a.begin(), a.end());
+    d.set_difference(s21::set<int>(b.begin(), b.end()));
+    std::set_difference(a.begin(), a.end(), b.begin(), b.end(),
+                        std::back_inserter(expected));
+    EXPECT_TRUE(d.valid());
+    ASSERT_EQ(d.size(), expected.size());
+    EXPECT_TRUE(std::equal(expected.begin(), expected.end(), d.begin()));
+  }
+}
+
+template <typename Set>
+bool same_keys(Set &a, Set &b) {
+  if (a.size() != b.size()) return false;
+  for (auto i = a.begin(), j = b.begin(); i != a.end(); ++i, ++j)
+    if (*i != *j) return false;
+  return true;
+}
+
+TEST(S21SetTests, ParallelSetAlgebra) {
+  std::set<int> a = random_set(120000, 400000, 1);
+  std::set<int> b = random_set(90000, 400000, 2);
+  s21::set<int> other(b.begin(), b.end());
+  for (size_t threads : {2, 4}) {
+    checked<s21::set<int>> seq(a.begin(), a.end());
+    checked<s21::set<int>> par(a.begin(), a.end());
+    seq.set_union(other);
+    par.set_union(other, threads);
+    EXPECT_TRUE(par.valid());
+    ASSERT_EQ(par.size(), seq.size());
+    EXPECT_TRUE(same_keys(seq, par));
+
+    seq.set_difference(s21::set<int>(a.begin(), a.end()));
+    par.set_difference(s21::set<int>(a.begin(), a.end()), threads);
+    EXPECT_TRUE(par.valid());
+    ASSERT_EQ(par.size(), seq.size());
+    EXPECT_TRUE(same_keys(seq, par));
+
+    par.set_union(s21::set<int>(a.begin(), a.end()), threads);
+    par.set_intersection(other, threads);
+    EXPECT_TRUE(par.valid());
+    EXPECT_EQ(par.size(), b.size());
+    EXPECT_TRUE(std::equal(b.begin(), b.end(), par.begin()));
+  }
+}
+
+template <typename T>
+struct budget_allocator {
+  using value_type = T;
+
+  explicit budget_allocator(size_t *b) : budget(b) {}
+  template <typename U>
+  budget_allocator(const budget_allocator<U> &other) : budget(other.budget) {}
+
+  T *allocate(size_t n) {
+    if (!*budget) throw std::bad_alloc();
+    --*budget;
+    return std::allocator<T>().allocate(n);
+  }
+  void deallocate(T *p, size_t n) { std::allocator<T>().deallocate(p, n); }
+  bool operator==(const budget_allocator &other) const {
+    return budget == other.budget;
+  }
+  bool operator!=(const budget_allocator &other) const {
+    return budget != other.budget;
+  }
+
+  size_t *budget;
+};
+
+TEST(S21SetTests, ParallelSetAlgebraThrows) {
+  using alloc = budget_allocator<int>;
+  using set = checked<s21::set<int, std::less<int>, alloc>>;
+  std::vector<int> evens, odds;
+  for (int i = 0; i < 100000; ++i) {
+    evens.push_back(2 * i);
+    odds.push_back(2 * i + 1);
+  }
+  size_t unlimited = -1;
+  size_t budget = -1;
+  set other(odds.begin(), odds.end(), alloc(&unlimited));
+  set s(evens.begin(), evens.end(), alloc(&budget));
+  budget = 1;
+  EXPECT_THROW(s.set_union(other, 4), std::bad_alloc);
+  budget = -1;
+  EXPECT_TRUE(s.valid());
+  s.insert(1);
+  EXPECT_TRUE(s.contains(1));
+  EXPECT_TRUE(s.valid());
+}
+
+TEST(S21SetTests, SetAlgebraSelfAndEmpty) {
+  s21::set<int> empty;
+  checked<s21::set<int>> s = {1, 2, 3};
+  s.set_union(s);
+  s.set_intersection(s);
+  s.set_union(empty);
+  s.set_difference(empty);
+  EXPECT_EQ(s.size(), 3);
+  empty.set_union(s);
+  EXPECT_EQ(empty.size(), 3);
+  EXPECT_EQ(*empty.nth(2), 3);
+  s.set_difference(s);
+  EXPECT_TRUE(s.empty());
+  EXPECT_TRUE(s.valid());
+  s.insert(5);
+  EXPECT_EQ(*s.begin(), 5);
+  empty.set_intersection(s);
+  EXPECT_TRUE(empty.empty());
+}
+
+TEST(S21MapTests, SetAlgebraKeepsValues) {
+  checked<s21::map<int, std::string>> m1 = {{1, "a"}, {2, "b"}, {3, "c"}};
+  s21::map<int, std::string> m2 = {{2, "x"}, {4, "y"}};
+  s21::map<int, std::string> copy(m2);
+  m1.set_union(copy);
+  EXPECT_TRUE(m1.valid());
+  EXPECT_EQ(m1.size(), 4);
+  EXPECT_EQ(m1.at(2), "b");
+  EXPECT_EQ(m1.at(4), "y");
+  m1.set_intersection(m2);
+  EXPECT_EQ(m1.size(), 2);
+  EXPECT_EQ(m1.at(2), "b");
+  EXPECT_EQ(m2.at(2), "x");
+}
+
+TEST(S21SetTests, Split) {
+  for (int key : {-1, 0, 1, 250, 500, 999, 1000, 5000}) {
+    checked<s21::set<int>> left;
+    checked<s21::set<int>> right = {-7, -8};
+    for (int i = 0; i < 1000; ++i) left.insert(i);
+    left.split(key, right);
+    int mid = std::max(0, std::min(key, 1000));
+    EXPECT_TRUE(left.valid());
+    EXPECT_TRUE(right.valid());
+    ASSERT_EQ(left.size(), static_cast<size_t>(mid));
+    ASSERT_EQ(right.size(), static_cast<size_t>(1000 - mid));
+    if (mid > 0) {
+      EXPECT_EQ(*left.nth(mid - 1), mid - 1);
+    }
+    if (mid < 1000) {
+      EXPECT_EQ(*right.begin(), mid);
+    }
+    left.insert(-1);
+    right.insert(2000);
+    EXPECT_TRUE(left.valid());
+    EXPECT_TRUE(right.valid());
+  }
+}
+
 ////////////////////////////////////////////////
 
 TEST(S21MultisetTests, ConstructorDefault) {
@@ -1259,6 +2415,19 @@ TEST(S21MultisetTests, Swap) {
   EXPECT_EQ(*my_swap_multiset.begin(), 1);
 }
 
+TEST(S21MultisetTests, SwapOwnsNodes) {
+  s21::multiset<int> kept = {1, 2, 3};
+  {
+    s21::multiset<int> gone = {4, 4, 5, 6, 7, 8, 9, 10, 11, 12};
+    kept.swap(gone);
+  }
+  std::vector<int> keys;
+  for (auto it = kept.begin(); it != kept.end(); ++it) keys.push_back(*it);
+  EXPECT_EQ(keys, std::vector<int>({4, 4, 5, 6, 7, 8, 9, 10, 11, 12}));
+  kept.insert(13);
+  EXPECT_EQ(kept.size(), 11);
+}
+
 TEST(S21MultisetTests, Merge) {
   s21::multiset<int> my_multiset = {1};
   s21::multiset<int> my_merge_multiset = {3, 4, 5};
@@ -3531,6 +4700,1128 @@ TEST(StackTest, ins_many_f) {
   EXPECT_EQ(s21_stack.top(), std_stack.top());
 }
 
+TEST(BtreeMapTests, RandomAgainstStd) {
+  std::mt19937 gen(7);
+  checked<s21::btree_map<int, int>> m;
+  std::map<int, int> expected;
+  for (int step = 0; step < 20000; ++step) {
+    int key = static_cast<int>(gen() % 3000);
+    switch (gen() % 4) {
+      case 0:
+        m[key] = step;
+        expected[key] = step;
+        break;
+      case 1:
+        EXPECT_EQ(m.insert(key, step).second,
+                  expected.emplace(key, step).second);
+        break;
+      case 2: {
+        auto it = m.find(key);
+        ASSERT_EQ(it != m.end(), expected.count(key) == 1);
+        if (it != m.end()) m.erase(it);
+        expected.erase(key);
+        break;
+      }
+      default: {
+        auto it = m.lower_bound(key);
+        auto want = expected.lower_bound(key);
+        ASSERT_EQ(it == m.end(), want == expected.end());
+        if (want != expected.end()) {
+          EXPECT_EQ(it->first, want->first);
+          EXPECT_EQ(it->second, want->second);
+        }
+      }
+    }
+    if (step % 1000 == 0) {
+      ASSERT_TRUE(m.valid());
+    }
+  }
+  ASSERT_TRUE(m.valid());
+  ASSERT_EQ(m.size(), expected.size());
+  auto it = m.begin();
+  for (const auto &want : expected) {
+    EXPECT_EQ(it->first, want.first);
+    EXPECT_EQ(it->second, want.second);
+    ++it;
+  }
+  for (auto want = expected.rbegin(); want != expected.rend(); ++want) {
+    --it;
+    EXPECT_EQ(it->first, want->first);
+  }
+  EXPECT_TRUE(it == m.begin());
+}
+
+TEST(BtreeMapTests, Interface) {
+  s21::btree_map<std::string, int> m = {{"b", 2}, {"a", 1}, {"c", 3}};
+  EXPECT_EQ(m.size(), 3U);
+  EXPECT_EQ(m.at("b"), 2);
+  EXPECT_THROW(m.at("z"), std::out_of_range);
+  EXPECT_FALSE(m.insert_or_assign("b", 20).second);
+  EXPECT_EQ(m["b"], 20);
+  EXPECT_EQ(m["d"], 0);
+  auto res = m.insert_many(std::make_pair(std::string("e"), 5),
+                           std::make_pair(std::string("a"), 9));
+  EXPECT_TRUE(res[0].second);
+  EXPECT_FALSE(res[1].second);
+  EXPECT_EQ(m.at("a"), 1);
+  EXPECT_TRUE(m.contains("e"));
+  EXPECT_EQ(m.count("e"), 1U);
+
+  s21::btree_map<std::string, int> copy(m);
+  s21::btree_map<std::string, int> moved(std::move(m));
+  EXPECT_TRUE(m.empty());
+  EXPECT_EQ(copy.size(), moved.size());
+  EXPECT_TRUE(std::equal(copy.begin(), copy.end(), moved.begin()));
+  copy.clear();
+  copy.swap(moved);
+  EXPECT_TRUE(moved.empty());
+  EXPECT_EQ(copy.size(), 5U);
+}
+
+TEST(BtreeSetTests, FillAndDrain) {
+  checked<s21::btree_set<int>> s;
+  std::vector<int> keys(5000);
+  for (size_t i = 0; i < keys.size(); ++i) keys[i] = static_cast<int>(i);
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(3));
+  for (int key : keys) EXPECT_TRUE(s.insert(key).second);
+  for (int key : keys) EXPECT_FALSE(s.insert(key).second);
+  ASSERT_TRUE(s.valid());
+  int want = 0;
+  for (int key : s) EXPECT_EQ(key, want++);
+  checked<s21::btree_set<int>> copy;
+  copy = s;
+  ASSERT_TRUE(copy.valid());
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(4));
+  for (size_t i = 0; i < keys.size(); ++i) {
+    s.erase(s.find(keys[i]));
+    if (i % 500 == 0) {
+      ASSERT_TRUE(s.valid());
+    }
+  }
+  EXPECT_TRUE(s.empty());
+  EXPECT_TRUE(s.valid());
+  EXPECT_TRUE(s.begin() == s.end());
+  EXPECT_EQ(copy.size(), keys.size());
+}
+
+TEST(BtreeSetTests, Merge) {
+  s21::btree_set<int> a = {1, 3, 5, 7};
+  s21::btree_set<int> b = {2, 3, 4, 7, 8};
+  a.merge(b);
+  std::vector<int> merged(a.begin(), a.end());
+  std::vector<int> rest(b.begin(), b.end());
+  EXPECT_EQ(merged, std::vector<int>({1, 2, 3, 4, 5, 7, 8}));
+  EXPECT_EQ(rest, std::vector<int>({3, 7}));
+}
+
+TEST(BtreeMultisetTests, RandomAgainstStd) {
+  std::mt19937 gen(11);
+  checked<s21::btree_multiset<int>> ms;
+  std::multiset<int> expected;
+  for (int step = 0; step < 20000; ++step) {
+    int key = static_cast<int>(gen() % 200);
+    if (gen() % 3) {
+      ms.insert(key);
+      expected.insert(key);
+    } else if (ms.contains(key)) {
+      ms.erase(ms.find(key));
+      expected.erase(expected.find(key));
+    }
+    if (step % 1000 == 0) {
+      ASSERT_TRUE(ms.valid());
+    }
+  }
+  ASSERT_TRUE(ms.valid());
+  ASSERT_EQ(ms.size(), expected.size());
+  EXPECT_TRUE(std::equal(expected.begin(), expected.end(), ms.begin()));
+  for (int key = -1; key <= 200; ++key) {
+    EXPECT_EQ(ms.count(key), expected.count(key));
+    auto range = ms.equal_range(key);
+    size_t n = 0;
+    for (auto it = range.first; it != range.second; ++it, ++n)
+      EXPECT_EQ(*it, key);
+    EXPECT_EQ(n, expected.count(key));
+  }
+}
+
+// No default constructor, so leaves may only build the slots they use.
+struct Tag {
+  explicit Tag(int value) : n(value), text(std::to_string(value)) {}
+  int n;
+  std::string text;
+};
+struct tag_greater {
+  bool operator()(const Tag &a, const Tag &b) const { return a.n > b.n; }
+};
+
+TEST(BtreeMapTests, NoDefaultCtorAndCompare) {
+  checked<s21::btree_map<Tag, Tag, tag_greater>> m;
+  for (int i = 0; i < 3000; ++i) EXPECT_TRUE(m.insert(Tag(i), Tag(-i)).second);
+  EXPECT_FALSE(m.insert(Tag(7), Tag(0)).second);
+  for (int i = 0; i < 3000; i += 2) m.erase(m.find(Tag(i)));
+  ASSERT_TRUE(m.valid());
+  int want = 2999;
+  for (auto &entry : m) {
+    EXPECT_EQ(entry.first.text, std::to_string(want));
+    EXPECT_EQ(entry.second.n, -want);
+    want -= 2;
+  }
+  EXPECT_EQ(want, -1);
+  static_assert(std::is_same<decltype((m.begin()->first)), const Tag &>::value,
+                "keys are const");
+
+  checked<s21::btree_set<std::string, std::greater<std::string>>> a;
+  s21::btree_set<std::string, std::greater<std::string>> b;
+  for (int i = 0; i < 2000; ++i) a.insert(std::to_string(i));
+  for (int i = 1000; i < 3000; ++i) b.insert(std::to_string(i));
+  a.merge(b);
+  ASSERT_TRUE(a.valid());
+  EXPECT_EQ(a.size(), 3000U);
+  EXPECT_EQ(b.size(), 1000U);
+  EXPECT_EQ(*a.begin(), "999");
+  EXPECT_EQ(*b.begin(), "1999");
+}
+
+TEST(vectorTest, ReuseAfterClear) {
+  s21::vector<int> v{1, 2, 3};
+  v.clear();
+  v.push_back(4);
+  s21::vector<int> moved(std::move(v));
+  v.insert(v.begin(), 5);
+  s21::vector<int> copy;
+  copy = moved;
+  copy.resize(3);
+  EXPECT_EQ(v.size(), 1U);
+  EXPECT_EQ(v.at(0), 5);
+  EXPECT_EQ(moved.size(), 1U);
+  EXPECT_EQ(copy.at(0), 4);
+  EXPECT_EQ(copy.at(2), 0);
+}
+
+// Counts default constructions, so a test sees when a value is built.
+struct DefaultCounter {
+  static int made;
+  DefaultCounter() { ++made; }
+};
+int DefaultCounter::made = 0;
+
+TEST(FlatMapTests, RandomAgainstStd) {
+  std::mt19937 gen(5);
+  s21::flat_map<int, int> m;
+  std::map<int, int> expected;
+  for (int step = 0; step < 5000; ++step) {
+    int key = static_cast<int>(gen() % 1000);
+    switch (gen() % 4) {
+      case 0:
+        m[key] = step;
+        expected[key] = step;
+        break;
+      case 1:
+        EXPECT_EQ(m.insert(key, step).second,
+                  expected.emplace(key, step).second);
+        break;
+      case 2: {
+        auto it = m.find(key);
+        ASSERT_EQ(it != m.end(), expected.count(key) == 1);
+        if (it != m.end()) m.erase(it);
+        expected.erase(key);
+        break;
+      }
+      default: {
+        std::vector<std::pair<int, int>> items;
+        for (int i = 0; i < 20; ++i)
+          items.emplace_back(static_cast<int>(gen() % 1000), step);
+        m.insert_range(items.begin(), items.end());
+        expected.insert(items.begin(), items.end());
+      }
+    }
+  }
+  ASSERT_EQ(m.size(), expected.size());
+  auto it = m.begin();
+  for (const auto &want : expected) {
+    EXPECT_EQ(it->first, want.first);
+    EXPECT_EQ((*it).second, want.second);
+    ++it;
+  }
+  EXPECT_TRUE(it == m.end());
+  for (int key = -1; key <= 1000; ++key) {
+    auto lo = m.lower_bound(key);
+    auto want = expected.lower_bound(key);
+    ASSERT_EQ(lo == m.end(), want == expected.end());
+    if (want != expected.end()) {
+      EXPECT_EQ(lo->first, want->first);
+    }
+    EXPECT_EQ(m.contains(key), expected.count(key) == 1);
+  }
+}
+
+TEST(FlatMapTests, Interface) {
+  s21::flat_map<std::string, int> m = {{"b", 2}, {"a", 1}, {"b", 7}};
+  EXPECT_EQ(m.size(), 2U);
+  EXPECT_EQ(m.at("b"), 2);
+  EXPECT_THROW(m.at("z"), std::out_of_range);
+  EXPECT_FALSE(m.insert_or_assign("b", 20).second);
+  EXPECT_EQ(m["b"], 20);
+  EXPECT_EQ(m["c"], 0);
+  auto res = m.insert_many(std::make_pair(std::string("d"), 4),
+                           std::make_pair(std::string("a"), 9));
+  EXPECT_TRUE(res[0].second);
+  EXPECT_FALSE(res[1].second);
+  EXPECT_EQ(res[1].first->second, 1);
+  (*m.begin()).second = 10;
+  EXPECT_EQ(m.at("a"), 10);
+  s21::flat_map<std::string, int> other = {{"a", 0}, {"e", 5}};
+  m.merge(other);
+  EXPECT_EQ(m.size(), 5U);
+  EXPECT_EQ(other.size(), 1U);
+  EXPECT_EQ(other.begin()->first, "a");
+  s21::flat_map<std::string, int> copy(m);
+  copy.clear();
+  copy.swap(m);
+  EXPECT_TRUE(m.empty());
+  EXPECT_EQ(copy.count("e"), 1U);
+}
+
+// Copy assignment throws while fail is set, moves never do.
+struct Fragile {
+  static bool fail;
+  Fragile() = default;
+  Fragile(int v) : value(v) {}
+  Fragile(const Fragile &) = default;
+  Fragile(Fragile &&) = default;
+  Fragile &operator=(Fragile &&) = default;
+  Fragile &operator=(const Fragile &other) {
+    if (fail) throw std::runtime_error("copy");
+    value = other.value;
+    return *this;
+  }
+  bool operator<(const Fragile &other) const { return value < other.value; }
+  int value = 0;
+};
+bool Fragile::fail = false;
+
+TEST(FlatMapTests, IndexBuildsValueOnMiss) {
+  s21::flat_map<int, DefaultCounter> m;
+  int before = DefaultCounter::made;
+  m[1];
+  m[2];
+  int built = DefaultCounter::made;
+  for (int i = 0; i < 100; ++i) m[i % 2 + 1];
+  EXPECT_EQ(DefaultCounter::made, built);
+  EXPECT_GE(built - before, 2);
+  EXPECT_EQ(m.size(), 2U);
+}
+
+// A key or value that fails to go in leaves both arrays as they were.
+TEST(FlatMapTests, FailedInsertKeepsArraysParallel) {
+  s21::flat_map<Fragile, int> by_key = {{1, 1}, {3, 3}};
+  s21::flat_map<int, Fragile> by_value = {{1, 1}, {3, 3}};
+  Fragile::fail = true;
+  EXPECT_THROW(by_key.insert(2, 2), std::runtime_error);
+  EXPECT_THROW(by_value.insert(2, 2), std::runtime_error);
+  Fragile::fail = false;
+  EXPECT_EQ(by_key.size(), 2U);
+  EXPECT_EQ(by_value.size(), 2U);
+  EXPECT_EQ(by_key.at(3), 3);
+  EXPECT_EQ(by_value.at(3).value, 3);
+  EXPECT_FALSE(by_value.contains(2));
+  EXPECT_TRUE(by_key.insert(2, 2).second);
+  EXPECT_TRUE(by_value.insert(2, 2).second);
+  int expected = 1;
+  for (const auto &item : by_key) EXPECT_EQ(item.second, expected++);
+  expected = 1;
+  for (const auto &item : by_value) {
+    EXPECT_EQ(item.first, expected);
+    EXPECT_EQ(item.second.value, expected++);
+  }
+}
+
+TEST(FlatSetTests, BranchlessSearch) {
+  std::mt19937 gen(9);
+  for (size_t n = 0; n < 70; ++n) {
+    std::vector<double> keys;
+    for (size_t i = 0; i < n; ++i)
+      keys.push_back(static_cast<double>(gen() % 50));
+    s21::flat_multiset<double> ms(keys.begin(), keys.end());
+    s21::flat_set<double> s(keys.begin(), keys.end());
+    std::multiset<double> expected(keys.begin(), keys.end());
+    std::set<double> unique(keys.begin(), keys.end());
+    ASSERT_EQ(ms.size(), expected.size());
+    ASSERT_EQ(s.size(), unique.size());
+    for (double key = -1; key <= 51; key += 0.5) {
+      EXPECT_EQ(ms.lower_bound(key) - ms.begin(),
+                std::distance(expected.begin(), expected.lower_bound(key)));
+      EXPECT_EQ(ms.upper_bound(key) - ms.begin(),
+                std::distance(expected.begin(), expected.upper_bound(key)));
+      EXPECT_EQ(ms.count(key), expected.count(key));
+      EXPECT_EQ(s.contains(key), unique.count(key) == 1);
+    }
+  }
+}
+
+TEST(FlatSetTests, Interface) {
+  s21::flat_set<std::string> s = {"b", "a", "b"};
+  EXPECT_EQ(s.size(), 2U);
+  EXPECT_FALSE(s.insert("a").second);
+  EXPECT_EQ(*s.insert("c").first, "c");
+  s.erase(s.find("b"));
+  std::vector<std::string> keys(s.begin(), s.end());
+  EXPECT_EQ(keys, std::vector<std::string>({"a", "c"}));
+  s21::flat_multiset<int> ms = {3, 1, 3};
+  ms.insert_many(3, 2);
+  s21::flat_multiset<int> other = {3, 0};
+  ms.merge(other);
+  EXPECT_TRUE(other.empty());
+  EXPECT_EQ(ms.count(3), 4U);
+  std::vector<int> all(ms.begin(), ms.end());
+  EXPECT_EQ(all, std::vector<int>({0, 1, 2, 3, 3, 3, 3}));
+}
+
+// Puts every key in one of four probe runs.
+struct clumped_hash {
+  size_t operator()(int key) const { return static_cast<size_t>(key % 4); }
+};
+
+template <typename Hash>
+void unordered_random_ops(unsigned seed, int range) {
+  std::mt19937 gen(seed);
+  checked<s21::unordered_map<int, int, Hash>> m;
+  std::unordered_map<int, int> expected;
+  for (int step = 0; step < 6000; ++step) {
+    int key = static_cast<int>(gen() % range);
+    switch (gen() % 3) {
+      case 0:
+        m[key] = step;
+        expected[key] = step;
+        break;
+      case 1:
+        EXPECT_EQ(m.insert(key, step).second,
+                  expected.emplace(key, step).second);
+        break;
+      default: {
+        auto it = m.find(key);
+        ASSERT_EQ(it != m.end(), expected.count(key) == 1);
+        if (it != m.end()) m.erase(it);
+        expected.erase(key);
+      }
+    }
+    if (step % 500 == 0) {
+      ASSERT_TRUE(m.valid());
+    }
+  }
+  ASSERT_TRUE(m.valid());
+  ASSERT_EQ(m.size(), expected.size());
+  size_t seen = 0;
+  for (auto &item : m) {
+    ASSERT_EQ(expected.count(item.first), 1U);
+    EXPECT_EQ(expected[item.first], item.second);
+    ++seen;
+  }
+  EXPECT_EQ(seen, expected.size());
+}
+
+TEST(UnorderedMapTests, RandomAgainstStd) {
+  unordered_random_ops<std::hash<int>>(1, 3000);
+}
+
+TEST(UnorderedMapTests, BackwardShiftWithCollisions) {
+  unordered_random_ops<clumped_hash>(2, 300);
+}
+
+TEST(UnorderedMapTests, Interface) {
+  s21::unordered_map<std::string, int> m = {{"b", 2}, {"a", 1}, {"b", 7}};
+  EXPECT_EQ(m.size(), 2U);
+  EXPECT_EQ(m.at("b"), 2);
+  EXPECT_THROW(m.at("z"), std::out_of_range);
+  EXPECT_FALSE(m.insert_or_assign("b", 20).second);
+  EXPECT_EQ(m["b"], 20);
+  EXPECT_EQ(m["c"], 0);
+  auto res = m.insert_many(std::make_pair(std::string("d"), 4),
+                           std::make_pair(std::string("a"), 9));
+  EXPECT_TRUE(res[0].second);
+  EXPECT_FALSE(res[1].second);
+  EXPECT_EQ(res[1].first->second, 1);
+  EXPECT_TRUE(m.contains("d"));
+  EXPECT_EQ(m.count("e"), 0U);
+
+  s21::unordered_map<std::string, int> copy(m);
+  s21::unordered_map<std::string, int> moved(std::move(m));
+  EXPECT_TRUE(m.empty());
+  EXPECT_TRUE(m.find("a") == m.end());
+  EXPECT_EQ(copy.size(), 4U);
+  EXPECT_EQ(moved.at("d"), 4);
+  copy.clear();
+  copy.swap(moved);
+  EXPECT_TRUE(moved.empty());
+  EXPECT_EQ(copy.at("b"), 20);
+}
+
+TEST(UnorderedMapTests, LoadFactor) {
+  checked<s21::unordered_map<int, int>> m;
+  m.max_load_factor(0.5f);
+  for (int i = 0; i < 1000; ++i) m[i] = i;
+  EXPECT_LE(m.load_factor(), 0.5f);
+  EXPECT_TRUE(m.valid());
+  m.max_load_factor(2.0f);
+  EXPECT_LT(m.max_load_factor(), 1.0f);
+  m.reserve(5000);
+  size_t buckets = m.bucket_count();
+  for (int i = 1000; i < 5000; ++i) m[i] = i;
+  EXPECT_EQ(m.bucket_count(), buckets);
+  m.max_load_factor(0.25f);
+  EXPECT_LE(m.load_factor(), 0.25f);
+  EXPECT_TRUE(m.valid());
+  for (int i = 0; i < 5000; ++i) EXPECT_EQ(m.at(i), i);
+}
+
+TEST(UnorderedSetTests, Merge) {
+  checked<s21::unordered_set<std::string>> a = {"x", "y"};
+  checked<s21::unordered_set<std::string>> b;
+  for (int i = 0; i < 200; ++i) b.insert(std::to_string(i));
+  b.insert("x");
+  EXPECT_TRUE(b.insert_many("y", "z")[1].second);
+  a.merge(b);
+  EXPECT_TRUE(a.valid());
+  EXPECT_TRUE(b.valid());
+  EXPECT_EQ(a.size(), 203U);
+  EXPECT_EQ(b.size(), 2U);
+  EXPECT_TRUE(b.contains("x"));
+  EXPECT_TRUE(b.contains("y"));
+}
+
+TEST(UnorderedMapTests, IndexBuildsValueOnMiss) {
+  s21::unordered_map<int, DefaultCounter> m;
+  int before = DefaultCounter::made;
+  for (int i = 0; i < 100; ++i) m[i % 10];
+  EXPECT_EQ(DefaultCounter::made - before, 10);
+  EXPECT_EQ(m.size(), 10U);
+}
+
+TEST(UnorderedMapTests, KeysAreConst) {
+  checked<s21::unordered_map<std::string, std::string>> m;
+  static_assert(
+      std::is_same<decltype((m.begin()->first)), const std::string &>::value,
+      "map keys are const");
+  s21::unordered_set<int> s;
+  static_assert(std::is_same<decltype(*s.begin()), const int &>::value,
+                "set elements are const");
+  // Growing and erasing move the slots, keys included.
+  for (int i = 0; i < 1000; ++i) m[std::to_string(i)] = std::to_string(-i);
+  for (int i = 0; i < 1000; i += 3) m.erase(m.find(std::to_string(i)));
+  EXPECT_TRUE(m.valid());
+  EXPECT_EQ(m.size(), 666U);
+  for (int i = 0; i < 1000; ++i) {
+    EXPECT_EQ(m.contains(std::to_string(i)), i % 3 != 0);
+    if (i % 3) {
+      EXPECT_EQ(m.at(std::to_string(i)), std::to_string(-i));
+    }
+  }
+}
+
+// Orders against std::string_view and counts every construction.
+struct TrackedName {
+  static int made;
+  std::string name;
+  TrackedName() = default;
+  TrackedName(std::string_view n) : name(n) { ++made; }
+  TrackedName(const TrackedName &other) : name(other.name) { ++made; }
+  TrackedName &operator=(const TrackedName &other) = default;
+  bool operator<(const TrackedName &other) const { return name < other.name; }
+  friend bool operator<(const TrackedName &a, std::string_view b) {
+    return a.name < b;
+  }
+  friend bool operator<(std::string_view a, const TrackedName &b) {
+    return a < b.name;
+  }
+};
+int TrackedName::made = 0;
+
+// Converts to std::string but is not ordered against it.
+struct NameSource {
+  operator std::string() const { return "beta"; }
+};
+
+TEST(S21MapTests, HeterogeneousLookup) {
+  s21::map<TrackedName, int> m;
+  s21::set<TrackedName> s;
+  s21::multiset<TrackedName> ms;
+  for (std::string_view name : {"alpha", "beta", "gamma"}) {
+    m.insert(TrackedName(name), static_cast<int>(name.size()));
+    s.insert(TrackedName(name));
+    ms.insert(TrackedName(name));
+  }
+  TrackedName::made = 0;
+  std::string_view beta = "beta";
+  EXPECT_EQ(m.at(beta), 4);
+  EXPECT_THROW(m.at(std::string_view("delta")), std::out_of_range);
+  EXPECT_EQ((*m.find(beta)).second, 4);
+  EXPECT_TRUE(m.find(std::string_view("b")) == m.end());
+  EXPECT_TRUE(m.contains(beta));
+  EXPECT_EQ(m.count(beta), 1U);
+  EXPECT_EQ((*m.lower_bound(std::string_view("b"))).first.name, "beta");
+  EXPECT_EQ((*m.upper_bound(beta)).first.name, "gamma");
+  EXPECT_EQ((*s.find(beta)).name, "beta");
+  EXPECT_EQ(s.count(std::string_view("zeta")), 0U);
+  EXPECT_TRUE(s.contains(beta));
+  EXPECT_EQ(ms.count(beta), 1U);
+  EXPECT_EQ((*ms.lower_bound(beta)).name, "beta");
+  EXPECT_EQ(TrackedName::made, 0);
+
+  s21::map<std::string, int> names = {{"alpha", 1}, {"beta", 2}};
+  EXPECT_EQ(names.at("beta"), 2);
+  EXPECT_EQ(names.at(std::string_view("alpha")), 1);
+  EXPECT_EQ(names.at(NameSource()), 2);
+  EXPECT_EQ(names.count("gamma"), 0U);
+  s21::map<int, int> empty;
+  EXPECT_THROW(empty.at(1), std::out_of_range);
+}
+
+// Stateful, so it is stored as a member instead of an empty base.
+struct counting_less {
+  int *count = nullptr;
+  bool operator()(int a, int b) const {
+    ++*count;
+    return a < b;
+  }
+};
+
+TEST(S21SetTests, CustomCompare) {
+  EXPECT_EQ(sizeof(s21::set<int, std::greater<int>>), sizeof(s21::set<int>));
+  EXPECT_EQ(sizeof(s21::map<int, int, std::greater<int>>),
+            sizeof(s21::map<int, int>));
+  EXPECT_EQ(sizeof(s21::set<int, counting_less>),
+            sizeof(s21::set<int>) + sizeof(int *));
+
+  checked<s21::set<int, std::greater<int>>> s;
+  checked<s21::multiset<int, std::greater<int>>> ms;
+  s21::map<int, int, std::greater<int>> m;
+  for (int i = 0; i < 100; ++i) {
+    s.insert((i * 37) % 100);
+    ms.insert(i % 10);
+    m.insert(i, -i);
+  }
+  EXPECT_TRUE(s.valid());
+  EXPECT_TRUE(ms.valid());
+  int expected = 99;
+  for (auto it = s.begin(); it != s.end(); ++it) EXPECT_EQ(*it, expected--);
+  EXPECT_EQ(*s.lower_bound(50), 50);
+  EXPECT_EQ(*s.upper_bound(50), 49);
+  EXPECT_EQ(*ms.begin(), 9);
+  EXPECT_EQ(ms.count(3), 10U);
+  EXPECT_EQ((*m.begin()).first, 99);
+  EXPECT_EQ(m.at(7), -7);
+  EXPECT_TRUE(s.key_comp()(2, 1));
+
+  checked<s21::set<int, std::greater<int>>> other;
+  for (int i = 50; i < 150; ++i) other.insert(i);
+  s.merge(other);
+  EXPECT_TRUE(s.valid());
+  EXPECT_EQ(s.size(), 150U);
+  EXPECT_EQ(*s.begin(), 149);
+}
+
+TEST(S21SetTests, ComparisonsPerLevel) {
+  int count = 0;
+  checked<s21::set<int, counting_less>> s(counting_less{&count});
+  for (int i = 0; i < 4096; ++i) s.insert((i * 7919) % 4096 * 2);
+  ASSERT_TRUE(s.valid());
+  EXPECT_EQ(s.key_comp().count, &count);
+  int path = s.height() + 1;
+  for (int key = -1; key < 8194; key += 97) {
+    count = 0;
+    s.find(key);
+    EXPECT_LE(count, path + 1);
+    count = 0;
+    s.lower_bound(key);
+    EXPECT_LE(count, path);
+    count = 0;
+    s.contains(key);
+    EXPECT_LE(count, path + 1);
+  }
+  for (int key = 1; key < 8192; key += 501) {
+    count = 0;
+    s.insert(key);
+    EXPECT_LE(count, 2 * path);
+    path = s.height() + 1;
+  }
+  EXPECT_TRUE(s.valid());
+}
+
+TEST(S21MapTests, SingleDescentUpserts) {
+  int count = 0;
+  checked<s21::map<int, CopyCounter, counting_less>> m(counting_less{&count});
+  for (int i = 0; i < 4096; ++i) m.insert((i * 7919) % 4096 * 2, {});
+  CopyCounter::copies = 0;
+  for (int key = 1; key < 8192; key += 501) {
+    int path = m.height() + 1;
+    count = 0;
+    m[key].tag = key;
+    EXPECT_LE(count, 2 * path);
+    count = 0;
+    m[key].tag++;
+    EXPECT_LE(count, 2 * path);
+    count = 0;
+    m.insert_or_assign(key + 2, CopyCounter());
+    EXPECT_LE(count, 2 * path + 2);
+  }
+  EXPECT_EQ(CopyCounter::copies, 0);
+  EXPECT_EQ(m.at(502).tag, 503);
+  EXPECT_TRUE(m.valid());
+}
+
+TEST(S21MapTests, EmplaceInPlace) {
+  checked<s21::map<std::string, std::unique_ptr<int>>> m;
+  auto value = std::make_unique<int>(1);
+  auto res = m.try_emplace("a", std::move(value));
+  EXPECT_TRUE(res.second);
+  EXPECT_EQ(*(*res.first).second, 1);
+
+  // A present key leaves the arguments alone.
+  value = std::make_unique<int>(2);
+  res = m.try_emplace("a", std::move(value));
+  EXPECT_FALSE(res.second);
+  ASSERT_TRUE(value);
+  EXPECT_EQ(*(*res.first).second, 1);
+
+  res = m.emplace("b", std::make_unique<int>(3));
+  EXPECT_TRUE(res.second);
+  res = m.emplace(std::piecewise_construct, std::forward_as_tuple(3, 'c'),
+                  std::forward_as_tuple(new int(4)));
+  EXPECT_EQ((*res.first).first, "ccc");
+  res = m.emplace("b", nullptr);
+  EXPECT_FALSE(res.second);
+  EXPECT_EQ(*m.at("b"), 3);
+
+  res = m.insert_or_assign("b", std::move(value));
+  EXPECT_FALSE(res.second);
+  EXPECT_EQ(*m.at("b"), 2);
+  std::string key = "d";
+  EXPECT_FALSE(m[std::move(key)]);
+  EXPECT_EQ(m.size(), 4);
+  EXPECT_TRUE(m.valid());
+}
+
+TEST(ConcurrentMapTests, Interface) {
+  s21::concurrent_map<int, int> m(8);
+  std::map<int, int> expected;
+  std::mt19937 gen(5);
+  for (int i = 0; i < 20000; ++i) {
+    int key = static_cast<int>(gen() % 2000);
+    switch (gen() % 3) {
+      case 0:
+        EXPECT_EQ(m.insert(key, i), expected.emplace(key, i).second);
+        break;
+      case 1:
+        EXPECT_EQ(m.insert_or_assign(key, i), !expected.count(key));
+        expected[key] = i;
+        break;
+      default:
+        EXPECT_EQ(m.erase(key), expected.erase(key) == 1);
+    }
+  }
+  EXPECT_EQ(m.size(), expected.size());
+  auto it = expected.begin();
+  m.for_each([&](const auto &item) {
+    ASSERT_TRUE(it != expected.end());
+    EXPECT_EQ(item.first, it->first);
+    EXPECT_EQ(item.second, it->second);
+    ++it;
+  });
+  EXPECT_TRUE(it == expected.end());
+  int value = 0;
+  for (int key = 0; key < 2000; ++key) {
+    EXPECT_EQ(m.find(key, value), expected.count(key) == 1);
+    if (expected.count(key)) {
+      EXPECT_EQ(value, expected[key]);
+    }
+  }
+  m.clear();
+  EXPECT_TRUE(m.empty());
+  EXPECT_FALSE(m.contains(expected.begin()->first));
+  EXPECT_TRUE(m.insert(1, 1));
+
+  // Values that are not trivially copyable work the same.
+  s21::concurrent_map<std::string, std::string> names;
+  EXPECT_TRUE(names.insert("alpha", "a"));
+  EXPECT_FALSE(names.insert("alpha", "b"));
+  std::string name;
+  EXPECT_TRUE(names.find("alpha", name));
+  EXPECT_EQ(name, "a");
+  EXPECT_TRUE(names.erase("alpha"));
+  EXPECT_FALSE(names.contains("alpha"));
+}
+
+// for_each hands out the elements of shard snapshots as they are stored,
+// so f may change the map and still sees it as it was.
+TEST(ConcurrentMapTests, ForEachOverSnapshots) {
+  using map = s21::concurrent_map<int, CopyCounter>;
+  static_assert(
+      std::is_same<map::value_type, std::pair<const int, CopyCounter>>::value);
+  map m(4);
+  for (int key = 0; key < 100; ++key) m.insert(key, CopyCounter());
+  CopyCounter::copies = 0;
+  int visited = 0;
+  m.for_each([&](const map::value_type &) { ++visited; });
+  EXPECT_EQ(visited, 100);
+  EXPECT_EQ(CopyCounter::copies, 0);
+  int expected = 0;
+  m.for_each([&](const map::value_type &item) {
+    EXPECT_EQ(item.first, expected++);
+    EXPECT_TRUE(m.erase(item.first));
+    EXPECT_FALSE(m.contains(item.first));
+  });
+  EXPECT_EQ(expected, 100);
+  EXPECT_TRUE(m.empty());
+}
+
+// Even keys stay in the map, odd ones come and go. Every key found has to
+// carry its own value.
+TEST(ConcurrentMapTests, ReadersAndWriters) {
+  const int n = 4096;
+  s21::concurrent_map<int, long> m(4);
+  for (int key = 0; key < n; key += 2) m.insert(key, 3L * key);
+  std::atomic<int> errors{0};
+  std::atomic<bool> done{false};
+  std::vector<std::thread> threads;
+  for (int w = 0; w < 2; ++w) {
+    threads.emplace_back([&, w] {
+      std::mt19937 gen(w);
+      for (int i = 0; i < 100000; ++i) {
+        int key = static_cast<int>(gen() % n);
+        if (key % 2 == 0)
+          m.insert_or_assign(key, 3L * key);
+        else if (gen() % 2)
+          m.insert(key, 3L * key);
+        else
+          m.erase(key);
+      }
+    });
+  }
+  for (int r = 0; r < 2; ++r) {
+    threads.emplace_back([&, r] {
+      std::mt19937 gen(10 + r);
+      while (!done.load()) {
+        int key = static_cast<int>(gen() % n);
+        long value = -1;
+        bool found = m.find(key, value);
+        if ((key % 2 == 0 && !found) || (found && value != 3L * key))
+          ++errors;
+      }
+    });
+  }
+  threads[0].join();
+  threads[1].join();
+  done = true;
+  threads[2].join();
+  threads[3].join();
+  EXPECT_EQ(errors.load(), 0);
+  size_t count = 0;
+  m.for_each([&](const auto &item) {
+    EXPECT_EQ(item.second, 3L * item.first);
+    ++count;
+  });
+  EXPECT_EQ(count, m.size());
+}
+
+TEST(SkiplistMapTests, RandomAgainstStd) {
+  s21::skiplist_map<int, int> m;
+  std::map<int, int> expected;
+  std::mt19937 gen(9);
+  for (int i = 0; i < 50000; ++i) {
+    int key = static_cast<int>(gen() % 3000);
+    if (gen() % 3) {
+      EXPECT_EQ(m.insert(key, i).second, expected.emplace(key, i).second);
+    } else {
+      EXPECT_EQ(m.erase(key), expected.erase(key));
+    }
+  }
+  EXPECT_EQ(m.size(), expected.size());
+  auto it = expected.begin();
+  for (const auto &item : m) {
+    ASSERT_TRUE(it != expected.end());
+    EXPECT_EQ(item.first, it->first);
+    EXPECT_EQ(item.second, it->second);
+    ++it;
+  }
+  EXPECT_TRUE(it == expected.end());
+  for (int key = -1; key < 3001; key += 7) {
+    auto lower = expected.lower_bound(key);
+    auto upper = expected.upper_bound(key);
+    EXPECT_EQ(m.lower_bound(key) == m.end(), lower == expected.end());
+    if (lower != expected.end()) {
+      EXPECT_EQ(m.lower_bound(key)->first, lower->first);
+    }
+    if (upper != expected.end()) {
+      EXPECT_EQ(m.upper_bound(key)->first, upper->first);
+    }
+    EXPECT_EQ(m.contains(key), expected.count(key) == 1);
+  }
+}
+
+TEST(SkiplistMapTests, Interface) {
+  s21::skiplist_map<std::string, int> m = {{"b", 2}, {"a", 1}, {"c", 3}};
+  EXPECT_EQ(m.size(), 3U);
+  EXPECT_EQ(m.begin()->first, "a");
+  EXPECT_EQ(m.at("b"), 2);
+  EXPECT_THROW(m.at("z"), std::out_of_range);
+  m["d"] = 4;
+  EXPECT_EQ(m["d"], 4);
+  EXPECT_FALSE(m.insert("a", 10).second);
+  auto res = m.insert_many(std::make_pair(std::string("e"), 5),
+                           std::make_pair(std::string("a"), 0));
+  EXPECT_TRUE(res[0].second);
+  EXPECT_FALSE(res[1].second);
+
+  // An iterator outlives the erase of its element and moves on from it.
+  auto it = m.find("b");
+  m.erase(it);
+  EXPECT_EQ(it->second, 2);
+  ++it;
+  EXPECT_EQ(it->first, "c");
+  EXPECT_FALSE(m.contains("b"));
+  m.clear();
+  EXPECT_TRUE(m.empty());
+  EXPECT_TRUE(m.begin() == m.end());
+
+  s21::skiplist_map<int, int, std::greater<int>> desc({{1, 1}, {3, 3}});
+  EXPECT_EQ(desc.begin()->first, 3);
+}
+
+// Counts live copies, so the test can tell when every node is freed.
+struct LiveValue {
+  static std::atomic<int> live;
+  long key = 0;
+  LiveValue(long k = 0) : key(k) { ++live; }
+  LiveValue(const LiveValue &other) : key(other.key) { ++live; }
+  LiveValue &operator=(const LiveValue &other) = default;
+  ~LiveValue() { --live; }
+};
+std::atomic<int> LiveValue::live{0};
+
+// Writers share one key range, each also owns a range only it touches. A
+// scanner walks the map the whole time and checks the order.
+TEST(SkiplistMapTests, ConcurrentStress) {
+  const int threads = 4;
+  const int shared = 512;
+  std::vector<std::set<int>> owned(threads);
+  std::atomic<int> errors{0};
+  std::atomic<bool> done{false};
+  {
+    s21::skiplist_map<int, LiveValue> m;
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+      workers.emplace_back([&, t] {
+        std::mt19937 gen(t);
+        for (int i = 0; i < 30000; ++i) {
+          int key = static_cast<int>(gen() % shared);
+          if (gen() % 2) key = shared + t + threads * (key % 128);
+          bool mine = key >= shared;
+          if (gen() % 2) {
+            bool inserted = m.insert(key, LiveValue(key)).second;
+            if (mine && inserted != owned[t].insert(key).second) ++errors;
+          } else {
+            bool erased = m.erase(key) == 1;
+            if (mine && erased != (owned[t].erase(key) == 1)) ++errors;
+          }
+          auto it = m.find(key);
+          if (it != m.end() && it->second.key != key) ++errors;
+        }
+      });
+    }
+    std::thread scanner([&] {
+      while (!done.load()) {
+        int prev = -1;
+        for (const auto &item : m) {
+          if (item.first <= prev || item.second.key != item.first) ++errors;
+          prev = item.first;
+        }
+      }
+    });
+    for (auto &worker : workers) worker.join();
+    done = true;
+    scanner.join();
+    EXPECT_EQ(errors.load(), 0);
+
+    size_t count = 0;
+    for (const auto &item : m) {
+      if (item.first >= shared) {
+        int t = (item.first - shared) % threads;
+        EXPECT_EQ(owned[t].count(item.first), 1U);
+      }
+      ++count;
+    }
+    size_t mine = 0;
+    for (const auto &keys : owned) mine += keys.size();
+    EXPECT_EQ(count, m.size());
+    EXPECT_GE(count, mine);
+  }
+  EXPECT_EQ(LiveValue::live.load(), 0);
+}
+
+TEST(PersistentMapTests, SnapshotsAgainstStd) {
+  std::mt19937 gen(7);
+  s21::persistent_map<int, int> m;
+  std::map<int, int> expected;
+  std::vector<std::pair<s21::persistent_map<int, int>, std::map<int, int>>>
+      versions;
+  for (int i = 0; i < 20000; ++i) {
+    int key = static_cast<int>(gen() % 2000);
+    switch (gen() % 3) {
+      case 0:
+        EXPECT_EQ(m.insert(key, i), expected.emplace(key, i).second);
+        break;
+      case 1:
+        EXPECT_EQ(m.insert_or_assign(key, i),
+                  expected.insert_or_assign(key, i).second);
+        break;
+      default:
+        EXPECT_EQ(m.erase(key), expected.erase(key));
+    }
+    if (i % 1000 == 0) versions.emplace_back(m.snapshot(), expected);
+  }
+  versions.emplace_back(m, expected);
+  for (auto &[version, items] : versions) {
+    ASSERT_EQ(version.size(), items.size());
+    auto it = version.begin();
+    for (const auto &item : items) {
+      EXPECT_EQ(it->first, item.first);
+      EXPECT_EQ(it->second, item.second);
+      ++it;
+    }
+    EXPECT_TRUE(it == version.end());
+    for (auto rit = items.rbegin(); rit != items.rend(); ++rit) {
+      --it;
+      EXPECT_EQ(it->first, rit->first);
+    }
+    EXPECT_TRUE(it == version.begin());
+  }
+}
+
+TEST(PersistentMapTests, Interface) {
+  s21::persistent_map<int, std::string> m{{3, "c"}, {1, "a"}, {5, "e"}};
+  EXPECT_EQ(m.size(), 3U);
+  EXPECT_EQ(m.at(3), "c");
+  EXPECT_THROW(m.at(4), std::out_of_range);
+  EXPECT_FALSE(m.insert({3, "x"}));
+  EXPECT_EQ(m.at(3), "c");
+  EXPECT_TRUE(m.contains(5));
+  EXPECT_EQ(m.count(2), 0U);
+  EXPECT_TRUE(m.find(2) == m.end());
+  EXPECT_EQ(m.lower_bound(2)->first, 3);
+  EXPECT_EQ(m.lower_bound(3)->first, 3);
+  EXPECT_EQ(m.upper_bound(3)->first, 5);
+  EXPECT_TRUE(m.upper_bound(5) == m.end());
+  EXPECT_EQ((--m.end())->first, 5);
+
+  auto old = m.snapshot();
+  m.erase(m.find(3));
+  m.insert_or_assign(1, "A");
+  EXPECT_EQ(m.size(), 2U);
+  EXPECT_EQ(m.at(1), "A");
+  EXPECT_EQ(old.size(), 3U);
+  EXPECT_EQ(old.at(1), "a");
+  EXPECT_EQ(old.at(3), "c");
+
+  s21::persistent_map<int, std::string> moved(std::move(old));
+  EXPECT_TRUE(old.empty());
+  EXPECT_EQ(moved.size(), 3U);
+  old = moved;
+  moved.clear();
+  EXPECT_EQ(old.size(), 3U);
+  old.swap(m);
+  EXPECT_EQ(old.size(), 2U);
+  EXPECT_EQ(m.begin()->second, "a");
+  m = std::move(old);
+  EXPECT_EQ(m.size(), 2U);
+  EXPECT_EQ(m.erase(7), 0U);
+}
+
+TEST(PersistentMapTests, PathCopying) {
+  AllocCounter counter;
+  using alloc = counting_allocator<std::pair<const int, int>>;
+  {
+    s21::persistent_map<int, int, std::less<int>, alloc> m{alloc(&counter)};
+    const int n = 1 << 12;
+    for (int i = 0; i < n; ++i) m.insert(i * 2, i);
+    EXPECT_EQ(counter.allocations, size_t(n));
+
+    // Unshared nodes change in place.
+    m.insert_or_assign(100, 0);
+    m.erase(102);
+    EXPECT_EQ(counter.allocations, size_t(n));
+
+    auto snapshot = m.snapshot();
+    EXPECT_EQ(counter.allocations, size_t(n));
+    // A present key copies nothing, even with every node shared.
+    EXPECT_FALSE(m.insert(4000, 0));
+    EXPECT_EQ(counter.allocations, size_t(n));
+    // An AVL tree of 4096 nodes is at most 17 levels deep. Rotations on
+    // the way up of an erase may copy two more nodes per level.
+    m.insert(1, 1);
+    EXPECT_LE(counter.allocations, size_t(n) + 18);
+    size_t before = counter.allocations;
+    m.erase(2000);
+    EXPECT_LE(counter.allocations, before + 3 * 17);
+    before = counter.allocations;
+    m.insert(3, 3);
+    EXPECT_LE(counter.allocations, before + 17);
+
+    EXPECT_EQ(snapshot.size(), size_t(n) - 1);
+    EXPECT_FALSE(snapshot.contains(1));
+    EXPECT_EQ(snapshot.at(2000), 1000);
+    m.clear();
+    EXPECT_EQ(snapshot.size(), size_t(n) - 1);
+  }
+  EXPECT_EQ(counter.allocations, counter.deallocations);
+}
+
+TEST(PersistentMapTests, ReadersDuringUpdates) {
+  std::mutex lock;
+  s21::persistent_map<int, LiveValue> published;
+  std::atomic<bool> done{false};
+  std::atomic<int> errors{0};
+  {
+    s21::persistent_map<int, LiveValue> m;
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 2; ++t) {
+      readers.emplace_back([&] {
+        while (!done.load()) {
+          s21::persistent_map<int, LiveValue> version;
+          {
+            std::lock_guard<std::mutex> guard(lock);
+            version = published;
+          }
+          size_t count = 0;
+          int prev = -1;
+          for (const auto &item : version) {
+            if (item.first <= prev || item.second.key != item.first) ++errors;
+            prev = item.first;
+            ++count;
+          }
+          if (count != version.size()) ++errors;
+        }
+      });
+    }
+    std::mt19937 gen(3);
+    for (int i = 0; i < 20000; ++i) {
+      int key = static_cast<int>(gen() % 1000);
+      if (gen() % 2)
+        m.insert(key, LiveValue(key));
+      else
+        m.erase(key);
+      if (i % 64 == 0) {
+        std::lock_guard<std::mutex> guard(lock);
+        published = m.snapshot();
+      }
+    }
+    done = true;
+    for (auto &reader : readers) reader.join();
+    published.clear();
+  }
+  EXPECT_EQ(errors.load(), 0);
+  EXPECT_EQ(LiveValue::live.load(), 0);
+}
+
 int main(int argc, char* argv[]) {
   testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
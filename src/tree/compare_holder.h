@@ -0,0 +1,27 @@
+#ifndef COMPARE_HOLDER_H
+#define COMPARE_HOLDER_H
+#include <type_traits>
+
+// Holds a comparator; an empty one becomes a base and takes no space.
+template <typename Compare, bool = std::is_empty<Compare>::value &&
+                                   !std::is_final<Compare>::value>
+class compare_holder : private Compare {
+ public:
+  compare_holder() = default;
+  explicit compare_holder(const Compare &comp) : Compare(comp){};
+  const Compare &compare_() const { return *this; };
+  Compare &compare_() { return *this; };
+};
+template <typename Compare>
+class compare_holder<Compare, false> {
+ public:
+  compare_holder() = default;
+  explicit compare_holder(const Compare &comp) : comp_(comp){};
+  const Compare &compare_() const { return comp_; };
+  Compare &compare_() { return comp_; };
+
+ private:
+  Compare comp_;
+};
+
+#endif  // COMPARE_HOLDER_H
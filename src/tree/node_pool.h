@@ -0,0 +1,62 @@
+#ifndef NODE_POOL_H
+#define NODE_POOL_H
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+
+// Slab allocator for tree nodes. Nodes are cut from contiguous blocks and
+// returned ones are kept on a free list; release() frees whole blocks.
+// Blocks come from Allocator rebound to T.
+template <typename T, typename Allocator = std::allocator<T>>
+class node_pool {
+ public:
+  using allocator_type =
+      typename std::allocator_traits<Allocator>::template rebind_alloc<T>;
+  using traits = std::allocator_traits<allocator_type>;
+
+  node_pool() = default;
+  explicit node_pool(const allocator_type &alloc) : alloc_(alloc){};
+  node_pool(const node_pool &) = delete;
+  node_pool &operator=(const node_pool &) = delete;
+  ~node_pool();
+
+  T *allocate();
+  void deallocate(T *node);
+  // The next n allocations the free list does not serve come from one
+  // block.
+  void reserve(size_t n);
+  template <typename... Args>
+  void construct(T *node, Args &&...args);
+  void destroy(T *node);
+  void release();
+  void absorb(node_pool &other);
+  void swap(node_pool &other);
+  allocator_type get_allocator() const { return alloc_; };
+
+ private:
+  // The first slot of every block holds its header.
+  struct header {
+    T *prev;
+    size_t capacity;
+  };
+  // A slot on the free list holds a pointer to the next free slot.
+  struct link {
+    T *next;
+  };
+  static_assert(sizeof(header) <= sizeof(T), "node is too small for a slab");
+  static constexpr size_t kMinBlock = 8;
+  static constexpr size_t kMaxBlock = 1024;
+
+  void grow(size_t capacity);
+
+  allocator_type alloc_;
+  T *blocks_ = nullptr;
+  T *free_ = nullptr;
+  T *cur_ = nullptr;
+  T *last_ = nullptr;
+  size_t next_capacity_ = kMinBlock;
+};
+
+#include "node_pool.tpp"
+#endif  // NODE_POOL_H
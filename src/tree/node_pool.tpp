@@ -0,0 +1,112 @@
+#include "node_pool.h"
+
+template <typename T, typename Allocator>
+node_pool<T, Allocator>::~node_pool() {
+  release();
+}
+
+template <typename T, typename Allocator>
+T* node_pool<T, Allocator>::allocate() {
+  T* node;
+  if (free_) {
+    node = free_;
+    free_ = std::launder(reinterpret_cast<link*>(free_))->next;
+  } else {
+    if (cur_ == last_) {
+      grow(next_capacity_);
+      if (next_capacity_ < kMaxBlock) next_capacity_ *= 2;
+    }
+    node = cur_++;
+  }
+  return node;
+}
+
+template <typename T, typename Allocator>
+void node_pool<T, Allocator>::deallocate(T* node) {
+  ::new (static_cast<void*>(node)) link{free_};
+  free_ = node;
+}
+
+template <typename T, typename Allocator>
+template <typename... Args>
+void node_pool<T, Allocator>::construct(T* node, Args&&... args) {
+  traits::construct(alloc_, node, std::forward<Args>(args)...);
+}
+
+template <typename T, typename Allocator>
+void node_pool<T, Allocator>::destroy(T* node) {
+  traits::destroy(alloc_, node);
+}
+
+// The rest of the current block goes to the free list.
+template <typename T, typename Allocator>
+void node_pool<T, Allocator>::reserve(size_t n) {
+  if (static_cast<size_t>(last_ - cur_) >= n) return;
+  while (cur_ != last_) deallocate(cur_++);
+  grow(n + 1);
+}
+
+template <typename T, typename Allocator>
+void node_pool<T, Allocator>::grow(size_t capacity) {
+  T* block = traits::allocate(alloc_, capacity);
+  ::new (static_cast<void*>(block)) header{blocks_, capacity};
+  blocks_ = block;
+  cur_ = block + 1;
+  last_ = block + capacity;
+}
+
+template <typename T, typename Allocator>
+void node_pool<T, Allocator>::release() {
+  while (blocks_) {
+    header* h = std::launder(reinterpret_cast<header*>(blocks_));
+    T* prev = h->prev;
+    size_t capacity = h->capacity;
+    traits::deallocate(alloc_, blocks_, capacity);
+    blocks_ = prev;
+  }
+  free_ = nullptr;
+  cur_ = nullptr;
+  last_ = nullptr;
+  next_capacity_ = kMinBlock;
+}
+
+// Takes over all blocks of other, including the nodes still in use there.
+// Both pools must use equal allocators.
+template <typename T, typename Allocator>
+void node_pool<T, Allocator>::absorb(node_pool& other) {
+  while (other.cur_ != other.last_) other.deallocate(other.cur_++);
+  if (other.free_) {
+    T* tail = other.free_;
+    link* l;
+    while ((l = std::launder(reinterpret_cast<link*>(tail)))->next)
+      tail = l->next;
+    l->next = free_;
+    free_ = other.free_;
+  }
+  if (other.blocks_) {
+    T* tail = other.blocks_;
+    header* h;
+    while ((h = std::launder(reinterpret_cast<header*>(tail)))->prev)
+      tail = h->prev;
+    h->prev = blocks_;
+    blocks_ = other.blocks_;
+  }
+  other.blocks_ = nullptr;
+  other.free_ = nullptr;
+  other.cur_ = nullptr;
+  other.last_ = nullptr;
+  other.next_capacity_ = kMinBlock;
+}
+
+template <typename T, typename Allocator>
+void node_pool<T, Allocator>::swap(node_pool& other) {
+  std::swap(blocks_, other.blocks_);
+  std::swap(free_, other.free_);
+  std::swap(cur_, other.cur_);
+  std::swap(last_, other.last_);
+  std::swap(next_capacity_, other.next_capacity_);
+  if constexpr (traits::propagate_on_container_swap::value) {
+    using std::swap;
+    swap(alloc_, other.alloc_);
+  }
+}
@@ -0,0 +1,51 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of workers for fork-join recursion. A forked task that has not
+// been picked up yet is run by the thread that joins it, so workers never
+// block on queued work.
+class thread_pool {
+ public:
+  class task {
+    friend class thread_pool;
+
+   public:
+    explicit task(std::function<void()> fn) : fn_(std::move(fn)){};
+
+   private:
+    std::function<void()> fn_;
+    std::exception_ptr error_;
+    bool done_ = false;
+  };
+
+  // threads counts the calling thread as well.
+  explicit thread_pool(size_t threads);
+  thread_pool(const thread_pool &) = delete;
+  thread_pool &operator=(const thread_pool &) = delete;
+  ~thread_pool();
+
+  void fork(task &t);
+  void join(task &t);
+  size_t size() const { return workers_.size() + 1; };
+
+ private:
+  void run();
+  void finish(task &t);
+
+  std::vector<std::thread> workers_;
+  std::deque<task *> queue_;
+  std::mutex mutex_;
+  std::condition_variable work_;
+  std::condition_variable done_;
+  bool stop_ = false;
+};
+
+#include "thread_pool.tpp"
+#endif  // THREAD_POOL_H
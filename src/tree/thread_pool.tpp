@@ -0,0 +1,67 @@
+#include "thread_pool.h"
+
+inline thread_pool::thread_pool(size_t threads) {
+  for (size_t i = 1; i < threads; ++i) workers_.emplace_back([this] { run(); });
+}
+
+inline thread_pool::~thread_pool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  work_.notify_all();
+  for (auto &worker : workers_) worker.join();
+}
+
+inline void thread_pool::fork(task &t) {
+  if (workers_.empty()) {
+    finish(t);
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    queue_.push_back(&t);
+  }
+  work_.notify_one();
+}
+
+// Takes the task back when no worker got it yet, it is usually the last
+// one queued. Otherwise waits for the worker running it.
+inline void thread_pool::join(task &t) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  for (auto it = queue_.rbegin(); it != queue_.rend(); ++it) {
+    if (*it == &t) {
+      queue_.erase(std::next(it).base());
+      lock.unlock();
+      finish(t);
+      if (t.error_) std::rethrow_exception(t.error_);
+      return;
+    }
+  }
+  done_.wait(lock, [&t] { return t.done_; });
+  if (t.error_) std::rethrow_exception(t.error_);
+}
+
+inline void thread_pool::finish(task &t) {
+  try {
+    t.fn_();
+  } catch (...) {
+    t.error_ = std::current_exception();
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  t.done_ = true;
+  done_.notify_all();
+}
+
+inline void thread_pool::run() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    work_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+    if (queue_.empty()) return;
+    task *t = queue_.front();
+    queue_.pop_front();
+    lock.unlock();
+    finish(*t);
+    lock.lock();
+  }
+}
@@ -1,19 +1,67 @@
 #ifndef TREE_H
 #define TREE_H
+#include <algorithm>
+#include <functional>
 #include <iostream>
 #include <limits>
+#include <mutex>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 #include <vector>
-template <typename K, typename V>
-class tree {
+
+#include "compare_holder.h"
+#include "node_pool.h"
+#include "thread_pool.h"
+
+// std::less<K> is applied as std::less<>: keys are ordered the same, and
+// lookups may compare other types against K directly.
+template <typename K, typename Compare>
+using tree_less =
+    std::conditional_t<std::is_same<Compare, std::less<K>>::value,
+                       std::less<>, Compare>;
+template <typename Less, typename K, typename Q, typename = void>
+struct tree_comparable : std::false_type {};
+template <typename Less, typename K, typename Q>
+struct tree_comparable<
+    Less, K, Q,
+    std::void_t<typename Less::is_transparent,
+                decltype(std::declval<const Less &>()(
+                    std::declval<const K &>(), std::declval<const Q &>())),
+                decltype(std::declval<const Less &>()(
+                    std::declval<const Q &>(), std::declval<const K &>()))>>
+    : std::true_type {};
+template <typename K, typename Compare>
+tree_less<K, Compare> to_tree_less(const Compare &comp) {
+  if constexpr (std::is_same<Compare, std::less<K>>::value)
+    return {};
+  else
+    return comp;
+}
+
+template <typename K, typename V, typename Compare = std::less<K>,
+          typename Allocator = std::allocator<std::pair<const K, V>>>
+class tree : protected compare_holder<tree_less<K, Compare>> {
  protected:
   class iter;
+  struct Node;
 
  public:
+  using allocator_type = Allocator;
+  using key_compare = Compare;
+
+  tree() = default;
+  explicit tree(const Allocator &alloc);
+  tree(const Compare &comp, const Allocator &alloc);
   tree &operator=(tree &&t);
 
+  allocator_type get_allocator() const;
+  key_compare key_comp() const;
+
   void clear();
 
-  bool contains(const K &key);
+  template <typename Q = K>
+  bool contains(const Q &key);
   bool empty();
   size_t size();
   size_t max_size();
@@ -22,20 +70,76 @@ class tree {
   void swap(tree &other);
   void merge(tree &other);
 
+  size_t rank(const K &key);
+  size_t count_range(const K &lo, const K &hi);
+
+  void set_union(const tree &other, size_t threads = 1);
+  void set_intersection(const tree &other, size_t threads = 1);
+  void set_difference(const tree &other, size_t threads = 1);
+  void split(const K &key, tree &right);
+
+  // Owns a node taken out of a tree. The node stays in the pool of that
+  // tree, which keeps its blocks while handles are out: clear frees nodes
+  // one by one then, merge and split move them. The handle must still not
+  // outlive the tree or be kept across a move or swap of it, the pool goes
+  // along with those. Dropping a full handle frees the node there.
+  class node_handle {
+    friend class tree;
+
+   public:
+    using key_type = K;
+    using mapped_type = V;
+    using allocator_type = Allocator;
+
+    node_handle() = default;
+    node_handle(node_handle &&other) noexcept;
+    node_handle &operator=(node_handle &&other) noexcept;
+    ~node_handle();
+
+    bool empty() const { return !node_; };
+    explicit operator bool() const { return node_; };
+    // The key may be changed before the node goes back into a tree.
+    K &key() const { return node_->key(); };
+    V &mapped() const { return node_->value(); };
+    // Elements the node holds, more than one only in a multiset.
+    size_t count() const { return 1 + node_->duplicates; };
+    allocator_type get_allocator() const { return owner_->get_allocator(); };
+
+   private:
+    node_handle(tree *owner, Node *node) : owner_(owner), node_(node){};
+    tree *owner_ = nullptr;
+    Node *node_ = nullptr;
+  };
+
  protected:
   struct Node {
-    K key = K();
-    V value = V();
+    Node() = default;
+    template <typename KK, typename VV>
+    Node(KK &&k, VV &&v) : data(std::forward<KK>(k), std::forward<VV>(v)){};
+    // Passes args straight to the pair, piecewise ones included.
+    template <typename... Args>
+    explicit Node(std::in_place_t, Args &&...args)
+        : data(std::forward<Args>(args)...){};
+    // Users only see the key as const. The tree itself moves keys out of
+    // nodes it frees and rekeys unlinked nodes, as std::map node handles do.
+    K &key() { return const_cast<K &>(data.first); };
+    const K &key() const { return data.first; };
+    V &value() { return data.second; };
+    const V &value() const { return data.second; };
+    // Kept as a pair, map iterators dereference straight into it.
+    std::pair<const K, V> data;
     Node *parent = nullptr;
     Node *left = nullptr;
     Node *right = nullptr;
-    unsigned int duplicates = 0;
+    // Copies of the key beyond the first, in a multiset.
+    size_t duplicates = 0;
+    size_t count = 1;
     int height = 0;
   };
   class iter {
    public:
-    friend class tree<K, V>;
-    iter() : current(nullptr), next(nullptr), end(nullptr){};
+    friend class tree<K, V, Compare, Allocator>;
+    iter() : current(nullptr), end(nullptr){};
     iter &operator++();
     iter &operator--();
     bool operator==(const iter &it) const;
@@ -43,9 +147,7 @@ class tree {
 
    protected:
     Node *current;
-    Node *next;
     Node *end;
-    std::pair<K, V> cur_value;
     Node *Back(Node *node);
     Node *Forw(Node *node);
   };
@@ -53,24 +155,104 @@ class tree {
   iter end();
   static Node *min(Node *node);
   static Node *max(Node *node);
-  std::pair<Node *, bool> insert_(K key, V value);
+  template <typename KK, typename VV>
+  std::pair<Node *, bool> insert_(KK &&key, VV &&value);
+  template <typename KK, typename VV>
+  std::pair<Node *, bool> insert_hint_(Node *hint, KK &&key, VV &&value);
+  template <typename... Args>
+  std::pair<Node *, bool> emplace_hint_(Node *hint, Args &&...args);
+  template <typename Q>
+  Node *hint_slot_(Node *hint, const Q &key, Node *&parent, Node **&link);
+  template <typename KK, typename... Args>
+  std::pair<Node *, bool> try_emplace_(KK &&key, Args &&...args);
+  template <typename... Args>
+  std::pair<Node *, bool> emplace_(Args &&...args);
+  template <typename Q>
+  Node *find_slot_(const Q &key, Node *&parent, Node **&link);
+  Node *link_node_(Node *parent, Node **link, Node *node);
+  std::pair<Node *, bool> splice_(tree &from, Node *node, bool multi);
+  node_handle extract_(Node *node);
+  std::pair<Node *, bool> insert_handle_(node_handle &handle, bool multi);
+  void drop_handle_(Node *node);
+  template <typename InputIt, typename KeyOf, typename ValueOf>
+  void assign_sorted_(InputIt first, InputIt last, KeyOf key_of,
+                      ValueOf value_of, bool multi);
+  Node *build_(Node *&head, size_t count);
+  void assign_chain_(Node *head, size_t count, size_t size);
+  Node *flatten_();
+  void merge_(tree &other, bool multi);
+  static Node *move_node_(tree &from, tree &to, Node *node);
+  Node *detach_();
+  void attach_(Node *node);
+  Node *link_(Node *node, Node *left, Node *right);
+  Node *join_(Node *left, Node *node, Node *right);
+  Node *join_right_(Node *left, Node *node, Node *right);
+  Node *join_left_(Node *left, Node *node, Node *right);
+  Node *join2_(Node *left, Node *right);
+  Node *split_(Node *node, const K &key, Node *&left, Node *&right);
+  Node *split_last_(Node *node, Node *&last);
+  Node *union_(Node *node, const Node *other, thread_pool *pool);
+  Node *intersection_(Node *node, const Node *other, thread_pool *pool);
+  Node *difference_(Node *node, const Node *other, thread_pool *pool);
+  template <typename Op>
+  Node *with_pool_(size_t threads, Op op);
+  template <typename F, typename G>
+  static void fork_join_(thread_pool *pool, F &&f, G &&g);
+  thread_pool *grain_(thread_pool *pool, Node *node, const Node *other);
+  static Node *relocate_(tree &from, tree &to, Node *node, Node *parent);
+  void delete_subtree_(Node *node);
   Node end_;
   Node *root = &end_;
   size_t size_ = 0;
-  Node *find_node(K key);
+  node_pool<Node, Allocator> pool_;
+  // Full node handles holding nodes of pool_.
+  size_t handles_ = 0;
+  // Set while worker threads share pool_.
+  std::mutex *pool_lock_ = nullptr;
+  // Subtrees smaller than this are not split across threads.
+  static constexpr size_t kParallelGrain = 1 << 14;
+  template <typename... Args>
+  Node *new_node(Args &&...args);
+  void delete_node(Node *node);
+  using less_type_ = tree_less<K, Compare>;
+  template <typename A, typename B>
+  bool less_(const A &a, const B &b) const {
+    return this->compare_()(a, b);
+  };
+  // With a transparent comparator lookups take any type it orders against
+  // K, so a string_view finds a std::string key without building a
+  // temporary. Other key types are converted to K first.
+  template <typename Q>
+  using comparable_ = std::disjunction<std::is_same<Q, K>,
+                                       tree_comparable<less_type_, K, Q>>;
+  template <typename Q>
+  Node *find_node(const Q &key);
+  template <typename Q>
+  Node *lower_bound_(const Q &key);
+  template <typename Q>
+  Node *upper_bound_(const Q &key);
+  template <typename It>
+  It make_iter_(Node *node);
+  std::pair<Node *, size_t> nth_(size_t k);
+  void add_duplicate_(Node *node, size_t n = 1);
+  void remove_duplicate_(Node *node, size_t n = 1);
+  void set_end_key_(size_t size);
   int GetHeight(Node *node);
+  size_t GetCount(Node *node);
   int GetBalance(Node *node);
-  void UpdateHeight(Node *node);
-  void RightRotate(Node *node);
-  void LeftRotate(Node *node);
-  void Swap(Node *A, Node *B);
-  void Balance(Node *node);
-  Node *erase_(Node *node, K key);
+  void Update(Node *node);
+  void ReplaceChild(Node *parent, Node *old, Node *node);
+  Node *RightRotate(Node *node);
+  Node *LeftRotate(Node *node);
+  Node *Balance(Node *node);
   void erase_(K key);
-  std::pair<Node *, bool> insert_(K key, V value, Node *node);
+  void erase_node_(Node *node);
+  Node *unlink_node_(Node *node);
+  void Retrace(Node *node, size_t grown);
   void del(Node *node);
-  Node *copy(Node *node, Node *parent);
-  void copy(const tree<K, V> &t);
+  Node *clone_(const Node *node, Node *parent);
+  void copy(const tree<K, V, Compare, Allocator> &t, size_t nodes);
+  size_t nodes_() const;
 };
 
 #include "tree.tpp"
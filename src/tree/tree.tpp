@@ -2,381 +2,1378 @@
 
 // typename tree<K, V>::Node* tree<K, V>::insert(K key, Node* node)
 
-template <typename K, typename V>
-tree<K, V>& tree<K, V>::operator=(tree&& other) {
+template <typename K, typename V, typename Compare, typename Allocator>
+tree<K, V, Compare, Allocator>::tree(const Allocator& alloc)
+    : pool_(typename node_pool<Node, Allocator>::allocator_type(alloc)) {}
+
+template <typename K, typename V, typename Compare, typename Allocator>
+tree<K, V, Compare, Allocator>::tree(const Compare& comp,
+                                     const Allocator& alloc)
+    : compare_holder<tree_less<K, Compare>>(to_tree_less<K>(comp)),
+      pool_(typename node_pool<Node, Allocator>::allocator_type(alloc)) {}
+
+template <typename K, typename V, typename Compare, typename Allocator>
+typename tree<K, V, Compare, Allocator>::key_compare
+tree<K, V, Compare, Allocator>::key_comp() const {
+  if constexpr (std::is_same<Compare, std::less<K>>::value)
+    return Compare();
+  else
+    return this->compare_();
+}
+
+template <typename K, typename V, typename Compare, typename Allocator>
+tree<K, V, Compare, Allocator>&
+tree<K, V, Compare, Allocator>::operator=(tree&& other) {
   clear();
-  root = other.root;
-  end_ = other.end_;
-  other.root = &other.end_;
-  other.end_.right = other.root;
-  other.end_.left = other.root;
-  other.end_.parent = other.root;
-  other.end_.key = 0;
-  root->parent = &end_;
-  size_ = other.size_;
-  other.size_ = 0;
-}
-
-template <typename K, typename V>
-std::pair<typename tree<K, V>::Node*, bool> tree<K, V>::insert_(K key, V value,
-                                                                Node* node) {
-  std::pair<Node*, bool> res(0, 0);
-  if (key < node->key) {
-    if (!node->left) {
-      Node* temp = new Node;
-      temp->parent = node;
-      temp->key = key;
-      temp->value = value;
-      node->left = temp;
-      res.second = 1;
-      res.first = temp;
-    } else
-      res = insert_(key, value, node->left);
-  } else if (key > node->key) {
-    if (!node->right) {
-      Node* temp = new Node;
-      temp->parent = node;
-      temp->key = key;
-      temp->value = value;
-      node->right = temp;
-      res.second = 1;
-      res.first = temp;
+  using traits = typename node_pool<Node, Allocator>::traits;
+  if (!traits::propagate_on_container_move_assignment::value &&
+      pool_.get_allocator() != other.pool_.get_allocator()) {
+    copy(other, other.nodes_());
+    other.clear();
+    return *this;
+  }
+  attach_(other.detach_());
+  pool_.swap(other.pool_);
+  this->compare_() = other.compare_();
+  return *this;
+}
+
+template <typename K, typename V, typename Compare, typename Allocator>
+typename tree<K, V, Compare, Allocator>::allocator_type
+tree<K, V, Compare, Allocator>::get_allocator() const {
+  return allocator_type(pool_.get_allocator());
+}
+
+template <typename K, typename V, typename Compare, typename Allocator>
+template <typename... Args>
+typename tree<K, V, Compare, Allocator>::Node*
+tree<K, V, Compare, Allocator>::new_node(Args&&... args) {
+  Node* node;
+  if (pool_lock_) {
+    std::lock_guard<std::mutex> lock(*pool_lock_);
+    node = pool_.allocate();
+  } else {
+    node = pool_.allocate();
+  }
+  pool_.construct(node, std::forward<Args>(args)...);
+  return node;
+}
+
+template <typename K, typename V, typename Compare, typename Allocator>
+void tree<K, V, Compare, Allocator>::delete_node(Node* node) {
+  pool_.destroy(node);
+  if (pool_lock_) {
+    std::lock_guard<std::mutex> lock(*pool_lock_);
+    pool_.deallocate(node);
+  } else {
+    pool_.deallocate(node);
+  }
+}
+
+// Walks up from the parent of a new leaf and stops rebalancing as soon as
+// a subtree keeps its height, after a rotation the height is always
+// restored. The element counts above only grow by the leaf, grown.
+template <typename K, typename V, typename Compare, typename Allocator>
+void tree<K, V, Compare, Allocator>::Retrace(Node* node, size_t grown) {
+  for (; node != &end_; node = node->parent) {
+    int height = node->height;
+    Update(node);
+    node = Balance(node);
+    if (node->height == height) break;
+  }
+  if (node == &end_) return;
+  for (node = node->parent; node != &end_; node = node->parent)
+    node->count += grown;
+}
+
+template <typename K, typename V, typename Compare, typename Allocator>
+template <typename KK, typename VV>
+std::pair<typename tree<K, V, Compare, Allocator>::Node*, bool>
+tree<K, V, Compare, Allocator>::insert_(KK&& key, VV&& value) {
+  Node* parent;
+  Node** link;
+  if (Node* found = find_slot_(key, parent, link))
+    return std::make_pair(found, false);
+  Node* res = link_node_(
+      parent, link, new_node(std::forward<KK>(key), std::forward<VV>(value)));
+  return std::make_pair(res, true);
+}
+
+// One descent: the value is built in place from args only when key is
+// missing.
+template <typename K, typename V, typename Compare, typename Allocator>
+template <typename KK, typename... Args>
+std::pair<typename tree<K, V, Compare, Allocator>::Node*, bool>
+tree<K, V, Compare, Allocator>::try_emplace_(KK&& key, Args&&... args) {
+  Node* parent;
+  Node** link;
+  if (Node* found = find_slot_(key, parent, link))
+    return std::make_pair(found, false);
+  Node* res = link_node_(
+      parent, link,
+      new_node(std::in_place, std::piecewise_construct,
+               std::forward_as_tuple(std::forward<KK>(key)),
+               std::forward_as_tuple(std::forward<Args>(args)...)));
+  return std::make_pair(res, true);
+}
+
+// The key is only known once the pair is built, so the node comes first
+// and goes back to the pool when the key is taken.
+template <typename K, typename V, typename Compare, typename Allocator>
+template <typename... Args>
+std::pair<typename tree<K, V, Compare, Allocator>::Node*, bool>
+tree<K, V, Compare, Allocator>::emplace_(Args&&... args) {
+  Node* node = new_node(std::in_place, std::forward<Args>(args)...);
+  Node* parent;
+  Node** link;
+  if (Node* found = find_slot_(node->key(), parent, link)) {
+    delete_node(node);
+    return std::make_pair(found, false);
+  }
+  return std::make_pair(link_node_(parent, link, node), true);
+}
+
+// Node holding key, or nullptr and the free link where key belongs with
+// its parent, &root under end_ in an empty tree.
+template <typename K, typename V, typename Compare, typename Allocator>
+template <typename Q>
+typename tree<K, V, Compare, Allocator>::Node*
+tree<K, V, Compare, Allocator>::find_slot_(const Q& key, Node*& parent,
+                                           Node**& link) {
+  parent = &end_;
+  link = &root;
+  for (Node* node = root == &end_ ? nullptr : root; node;) {
+    parent = node;
+    if (less_(key, node->key())) {
+      link = &node->left;
+      node = node->left;
+    } else if (less_(node->key(), key)) {
+      link = &node->right;
+      node = node->right;
     } else {
-      res = insert_(key, value, node->right);
+      return node;
     }
   }
-  if (key == node->key) {
-    res.second = 0;
-    res.first = node;
-    node->duplicates = node->duplicates + 1;
+  return nullptr;
+}
+
+// Links the new node next to hint, see hint_slot_. Equal keys are
+// returned with false.
+template <typename K, typename V, typename Compare, typename Allocator>
+template <typename KK, typename VV>
+std::pair<typename tree<K, V, Compare, Allocator>::Node*, bool>
+tree<K, V, Compare, Allocator>::insert_hint_(Node* hint, KK&& key,
+                                             VV&& value) {
+  Node* parent;
+  Node** link;
+  if (Node* found = hint_slot_(hint, key, parent, link))
+    return std::make_pair(found, false);
+  Node* res = link_node_(
+      parent, link, new_node(std::forward<KK>(key), std::forward<VV>(value)));
+  return std::make_pair(res, true);
+}
+
+// emplace_ with a hint: the pair is built in the node, which goes back to
+// the pool when the key is taken.
+template <typename K, typename V, typename Compare, typename Allocator>
+template <typename... Args>
+std::pair<typename tree<K, V, Compare, Allocator>::Node*, bool>
+tree<K, V, Compare, Allocator>::emplace_hint_(Node* hint, Args&&... args) {
+  Node* node = new_node(std::in_place, std::forward<Args>(args)...);
+  Node* parent;
+  Node** link;
+  if (Node* found = hint_slot_(hint, node->key(), parent, link)) {
+    delete_node(node);
+    return std::make_pair(found, false);
   }
-  Balance(node);
-  UpdateHeight(node);
-  return res;
+  return std::make_pair(link_node_(parent, link, node), true);
+}
+
+// find_slot_ that first looks right before and right after hint, which
+// takes two comparisons and an O(1) amortized step to the neighbour.
+// Otherwise the key is searched from the root.
+template <typename K, typename V, typename Compare, typename Allocator>
+template <typename Q>
+typename tree<K, V, Compare, Allocator>::Node*
+tree<K, V, Compare, Allocator>::hint_slot_(Node* hint, const Q& key,
+                                           Node*& parent, Node**& link) {
+  if (root == &end_) return find_slot_(key, parent, link);
+  if (hint == &end_ || less_(key, hint->key())) {
+    Node* prev = nullptr;
+    if (hint != end_.right) {
+      iter it = make_iter_<iter>(hint);
+      prev = (--it).current;
+      if (!less_(prev->key(), key))
+        return less_(key, prev->key()) ? find_slot_(key, parent, link) : prev;
+    }
+    // prev has no right child when hint has a left one.
+    parent = hint != &end_ && !hint->left ? hint : prev;
+    link = parent == hint ? &hint->left : &prev->right;
+  } else if (less_(hint->key(), key)) {
+    iter it = make_iter_<iter>(hint);
+    Node* next = (++it).current;
+    if (next != &end_ && !less_(key, next->key()))
+      return less_(next->key(), key) ? find_slot_(key, parent, link) : next;
+    parent = !hint->right ? hint : next;
+    link = parent == hint ? &hint->right : &next->left;
+  } else {
+    return hint;
+  }
+  return nullptr;
 }
-template <typename K, typename V>
-std::pair<typename tree<K, V>::Node*, bool> tree<K, V>::insert_(K key,
-                                                                V value) {
-  std::pair<Node*, bool> res(0, 0);
-  if (root == &end_) {
-    Node* temp = new Node;
-    root = temp;
-    temp->key = key;
-    temp->value = value;
-    res.second = 1;
-    res.first = temp;
+
+// Hangs node as a leaf on the free link of parent, see find_slot_, and
+// rebalances from parent up. The node brings its duplicates along.
+template <typename K, typename V, typename Compare, typename Allocator>
+typename tree<K, V, Compare, Allocator>::Node*
+tree<K, V, Compare, Allocator>::link_node_(Node* parent, Node** link,
+                                           Node* node) {
+  node->parent = parent;
+  node->left = nullptr;
+  node->right = nullptr;
+  node->height = 0;
+  size_t grown = node->count = 1 + node->duplicates;
+  *link = node;
+  if (parent == &end_) {
+    end_.parent = node;
+    end_.left = node;
+    end_.right = node;
   } else {
-    res = insert_(key, value, root);
+    if (parent == end_.right && link == &parent->left) end_.right = node;
+    if (parent == end_.left && link == &parent->right) end_.left = node;
+    Retrace(parent, grown);
+  }
+  size_ += grown;
+  set_end_key_(size_);
+  return node;
+}
+
+// Puts node, taken out of from, into this tree. From this tree it is
+// relinked as it is; from another one its key and value are moved into a
+// node of this pool, since every tree frees its own blocks. An equal key
+// here takes the duplicates of node when multi, otherwise node is left
+// where it is. A node still linked in from is taken out only when used.
+// Returns the node holding the key and whether node was used.
+template <typename K, typename V, typename Compare, typename Allocator>
+std::pair<typename tree<K, V, Compare, Allocator>::Node*, bool>
+tree<K, V, Compare, Allocator>::splice_(tree& from, Node* node, bool multi) {
+  Node* parent;
+  Node** link;
+  Node* found = find_slot_(node->key(), parent, link);
+  if (found && !multi) return std::make_pair(found, false);
+  if (node->parent) from.unlink_node_(node);
+  if (found) {
+    add_duplicate_(found, 1 + node->duplicates);
+    from.delete_node(node);
+    return std::make_pair(found, true);
+  }
+  if (&from != this) node = move_node_(from, *this, node);
+  return std::make_pair(link_node_(parent, link, node), true);
+}
+
+// Wraps an unlinked node, see unlink_node_.
+template <typename K, typename V, typename Compare, typename Allocator>
+typename tree<K, V, Compare, Allocator>::node_handle
+tree<K, V, Compare, Allocator>::extract_(Node* node) {
+  if (!node || node == &end_) return node_handle();
+  ++handles_;
+  return node_handle(this, unlink_node_(node));
+}
+
+// The handle stays empty when the key was not used.
+template <typename K, typename V, typename Compare, typename Allocator>
+std::pair<typename tree<K, V, Compare, Allocator>::Node*, bool>
+tree<K, V, Compare, Allocator>::insert_handle_(node_handle& handle,
+                                               bool multi) {
+  if (handle.empty()) return std::make_pair(&end_, false);
+  tree& owner = *handle.owner_;
+  std::pair<Node*, bool> res = splice_(owner, handle.node_, multi);
+  if (res.second) {
+    handle.node_ = nullptr;
+    --owner.handles_;
+  }
+  return res;
+}
+
+template <typename K, typename V, typename Compare, typename Allocator>
+tree<K, V, Compare, Allocator>::node_handle::node_handle(
+    node_handle&& other) noexcept
+    : owner_(other.owner_), node_(other.node_) {
+  other.node_ = nullptr;
+}
+
+template <typename K, typename V, typename Compare, typename Allocator>
+typename tree<K, V, Compare, Allocator>::node_handle&
+tree<K, V, Compare, Allocator>::node_handle::operator=(
+    node_handle&& other) noexcept {
+  if (this != &other) {
+    if (node_) owner_->drop_handle_(node_);
+    owner_ = other.owner_;
+    node_ = other.node_;
+    other.node_ = nullptr;
+  }
+  return *this;
+}
+
+template <typename K, typename V, typename Compare, typename Allocator>
+tree<K, V, Compare, Allocator>::node_handle::~node_handle() {
+  if (node_) owner_->drop_handle_(node_);
+}
+
+template <typename K, typename V, typename Compare, typename Allocator>
+void tree<K, V, Compare, Allocator>::drop_handle_(Node* node) {
+  --handles_;
+  delete_node(node);
+}
+
+// Takes the elements of [first, last) as long as they come in ascending
+// order and threads their nodes into a chain through the right links, the
+// chain is then turned into a balanced tree in one pass. Whatever is left
+// after the first out of order element is inserted one by one.
+template <typename K, typename V, typename Compare, typename Allocator>
+template <typename InputIt, typename KeyOf, typename ValueOf>
+void tree<K, V, Compare, Allocator>::assign_sorted_(InputIt first, InputIt last,
+                                                    KeyOf key_of,
+                                                    ValueOf value_of,
+                                                    bool multi) {
+  clear();
+  Node* head = nullptr;
+  Node* tail = nullptr;
+  size_t count = 0;
+  size_t size = 0;
+  for (; first != last; ++first) {
+    auto&& item = *first;
+    if (tail && !less_(tail->key(), key_of(item))) {
+      if (less_(key_of(item), tail->key())) break;
+      if (multi) {
+        tail->duplicates = tail->duplicates + 1;
+        size++;
+      }
+      continue;
+    }
+    Node* node = new_node(key_of(item), value_of(item));
+    if (tail)
+      tail->right = node;
+    else
+      head = node;
+    tail = node;
+    count++;
+    size++;
+  }
+  assign_chain_(head, count, size);
+  for (; first != last; ++first) {
+    auto&& item = *first;
+    std::pair<Node*, bool> res = insert_(key_of(item), value_of(item));
+    if (multi && !res.second) add_duplicate_(res.first);
   }
+}
+
+// Builds a perfectly balanced subtree from the first count nodes of the
+// chain and moves head past them.
+template <typename K, typename V, typename Compare, typename Allocator>
+typename tree<K, V, Compare, Allocator>::Node*
+tree<K, V, Compare, Allocator>::build_(Node*& head, size_t count) {
+  if (!count) return nullptr;
+  Node* left = build_(head, count / 2);
+  Node* node = head;
+  head = head->right;
+  node->left = left;
+  if (left) left->parent = node;
+  node->right = build_(head, count - count / 2 - 1);
+  if (node->right) node->right->parent = node;
+  Update(node);
+  return node;
+}
+
+// Replaces the (empty) tree with the ascending chain of count nodes.
+template <typename K, typename V, typename Compare, typename Allocator>
+void tree<K, V, Compare, Allocator>::assign_chain_(Node* head, size_t count,
+                                                   size_t size) {
+  if (!count) return;
+  Node* first = head;
+  root = build_(head, count);
   root->parent = &end_;
   end_.parent = root;
+  end_.right = first;
   end_.left = max(root);
-  end_.right = min(root);
-  if (res.second) size_++;
-  end_.key = size_;
-  return res;
+  size_ = size;
+  set_end_key_(size_);
+}
+
+// end() dereferences to the size, for keys that can hold it.
+template <typename K, typename V, typename Compare, typename Allocator>
+void tree<K, V, Compare, Allocator>::set_end_key_(size_t size) {
+  if constexpr (std::is_arithmetic<K>::value) end_.key() = size;
 }
 
-template <typename K, typename V>
-int tree<K, V>::GetHeight(Node* node) {
+template <typename K, typename V, typename Compare, typename Allocator>
+int tree<K, V, Compare, Allocator>::GetHeight(Node* node) {
   return node == nullptr ? -1 : node->height;
 }
 
-template <typename K, typename V>
-void tree<K, V>::UpdateHeight(Node* node) {
+template <typename K, typename V, typename Compare, typename Allocator>
+size_t tree<K, V, Compare, Allocator>::GetCount(Node* node) {
+  return node == nullptr ? 0 : node->count;
+}
+
+// Refreshes the height and the number of elements (duplicates included)
+// of the subtree from its children.
+template <typename K, typename V, typename Compare, typename Allocator>
+void tree<K, V, Compare, Allocator>::Update(Node* node) {
   int hl = GetHeight(node->left);
   int hr = GetHeight(node->right);
   node->height = (hl > hr ? hl : hr) + 1;
+  node->count = GetCount(node->left) + GetCount(node->right) + 1 +
+                node->duplicates;
 }
 
-template <typename K, typename V>
-int tree<K, V>::GetBalance(Node* node) {
+template <typename K, typename V, typename Compare, typename Allocator>
+int tree<K, V, Compare, Allocator>::GetBalance(Node* node) {
   if (!node) return 0;
   return (GetHeight(node->right) - GetHeight(node->left));
 }
-template <typename K, typename V>
-void tree<K, V>::Swap(Node* A, Node* B) {
-  V v_temp = A->value;
-  A->value = B->value;
-  B->value = v_temp;
-  K k_temp = A->key;
-  A->key = B->key;
-  B->key = k_temp;
-  unsigned int d_temp = A->duplicates;
-  A->duplicates = B->duplicates;
-  B->duplicates = d_temp;
-}
-template <typename K, typename V>
-void tree<K, V>::RightRotate(Node* node) {
-  Swap(node, node->left);
-  Node* temp = node->right;
-  node->right = node->left;
-  node->left = node->right->left;
-  node->right->left = node->right->right;
-  node->right->right = temp;
-  // par
-  if (node->left) node->left->parent = node;
-  if (node->right->right) node->right->right->parent = node->right;
-  if (node->right->left) node->right->left->parent = node->right;
-  UpdateHeight(node->right);
-  UpdateHeight(node);
-}
-template <typename K, typename V>
-void tree<K, V>::LeftRotate(Node* node) {
-  Swap(node, node->right);
-  Node* temp = node->left;
-  node->left = node->right;
-  node->right = node->left->right;
-  node->left->right = node->left->left;
-  node->left->left = temp;
+// Points the link that led from parent to old at node instead.
+template <typename K, typename V, typename Compare, typename Allocator>
+void tree<K, V, Compare, Allocator>::ReplaceChild(Node* parent, Node* old,
+                                                  Node* node) {
+  if (parent == &end_) {
+    root = node;
+    end_.parent = node;
+  } else if (!parent) {
+    // old was the root of a detached subtree
+  } else if (parent->left == old) {
+    parent->left = node;
+  } else {
+    parent->right = node;
+  }
+  if (node) node->parent = parent;
+}
 
+// Rotations only relink pointers, nodes keep their keys and values, so
+// iterators stay valid. Both return the new root of the subtree.
+template <typename K, typename V, typename Compare, typename Allocator>
+typename tree<K, V, Compare, Allocator>::Node*
+tree<K, V, Compare, Allocator>::RightRotate(Node* node) {
+  Node* pivot = node->left;
+  ReplaceChild(node->parent, node, pivot);
+  node->left = pivot->right;
+  if (node->left) node->left->parent = node;
+  pivot->right = node;
+  node->parent = pivot;
+  Update(node);
+  Update(pivot);
+  return pivot;
+}
+template <typename K, typename V, typename Compare, typename Allocator>
+typename tree<K, V, Compare, Allocator>::Node*
+tree<K, V, Compare, Allocator>::LeftRotate(Node* node) {
+  Node* pivot = node->right;
+  ReplaceChild(node->parent, node, pivot);
+  node->right = pivot->left;
   if (node->right) node->right->parent = node;
-  if (node->left->left) node->left->left->parent = node->left;
-  if (node->left->right) node->left->right->parent = node->left;
-  UpdateHeight(node->left);
-  UpdateHeight(node);
+  pivot->left = node;
+  node->parent = pivot;
+  Update(node);
+  Update(pivot);
+  return pivot;
 }
 
-template <typename K, typename V>
-void tree<K, V>::Balance(Node* node) {
+template <typename K, typename V, typename Compare, typename Allocator>
+typename tree<K, V, Compare, Allocator>::Node*
+tree<K, V, Compare, Allocator>::Balance(Node* node) {
   if (GetBalance(node) == -2) {
     if (GetBalance(node->left) == 1) LeftRotate(node->left);
-    RightRotate(node);
+    node = RightRotate(node);
   } else if (GetBalance(node) == 2) {
     if (GetBalance(node->right) == -1) RightRotate(node->right);
-    LeftRotate(node);
+    node = LeftRotate(node);
   }
+  return node;
 }
 
-template <typename K, typename V>
-size_t tree<K, V>::max_size() {
-  return std::numeric_limits<size_t>::max() / sizeof(typename tree<K, V>::Node);
+template <typename K, typename V, typename Compare, typename Allocator>
+size_t tree<K, V, Compare, Allocator>::max_size() {
+  return std::numeric_limits<size_t>::max() /
+         sizeof(typename tree<K, V, Compare, Allocator>::Node);
 }
-template <typename K, typename V>
-typename tree<K, V>::Node* tree<K, V>::min(Node* node) {
+template <typename K, typename V, typename Compare, typename Allocator>
+typename tree<K, V, Compare, Allocator>::Node*
+tree<K, V, Compare, Allocator>::min(Node* node) {
   while (node->left) node = node->left;
   return node;
 }
-template <typename K, typename V>
-typename tree<K, V>::Node* tree<K, V>::max(Node* node) {
+template <typename K, typename V, typename Compare, typename Allocator>
+typename tree<K, V, Compare, Allocator>::Node*
+tree<K, V, Compare, Allocator>::max(Node* node) {
   while (node->right) node = node->right;
   return node;
 }
 
-template <typename K, typename V>
-typename tree<K, V>::Node* tree<K, V>::erase_(Node* node, K key) {
-  if (!node)
-    return nullptr;
-  else if (node->key > key)
-    node->left = erase_(node->left, key);
-  else if (node->key < key)
-    node->right = erase_(node->right, key);
-  else {
-    if (!node->left || !node->right) {
-      size_--;
-      Node* r = node->right;
-      Node* l = node->left;
-      Node* p = node->parent;
-      delete node;
-      node = (!l) ? r : l;
-      if (node) node->parent = p;
+template <typename K, typename V, typename Compare, typename Allocator>
+void tree<K, V, Compare, Allocator>::erase_(K key) {
+  Node* node = find_node(key);
+  if (node) erase_node_(node);
+}
+
+// Unlinks node, a node with two children is replaced by its successor
+// node, so no key or value moves. Then rebalances up to the root.
+template <typename K, typename V, typename Compare, typename Allocator>
+void tree<K, V, Compare, Allocator>::erase_node_(Node* node) {
+  delete_node(unlink_node_(node));
+}
+
+// Takes node out of the tree without freeing it. It keeps its key, value
+// and duplicates, the links are cleared.
+template <typename K, typename V, typename Compare, typename Allocator>
+typename tree<K, V, Compare, Allocator>::Node*
+tree<K, V, Compare, Allocator>::unlink_node_(Node* node) {
+  if (node == end_.right)
+    end_.right = node->right ? min(node->right) : node->parent;
+  if (node == end_.left)
+    end_.left = node->left ? max(node->left) : node->parent;
+  Node* retrace;
+  if (node->left && node->right) {
+    Node* next = min(node->right);
+    if (next->parent != node) {
+      retrace = next->parent;
+      ReplaceChild(next->parent, next, next->right);
+      next->right = node->right;
+      next->right->parent = next;
     } else {
-      Node* min_right = min(node->right);
-      node->key = min_right->key;
-      node->value = min_right->value;
-      node->right = erase_(node->right, min_right->key);
+      retrace = next;
     }
+    ReplaceChild(node->parent, node, next);
+    next->left = node->left;
+    next->left->parent = next;
+    next->height = node->height;
+  } else {
+    retrace = node->parent;
+    ReplaceChild(node->parent, node, node->left ? node->left : node->right);
   }
-  if (node) {
-    UpdateHeight(node);
-    Balance(node);
+  size_ -= 1 + node->duplicates;
+  for (; retrace != &end_; retrace = retrace->parent) {
+    Update(retrace);
+    retrace = Balance(retrace);
   }
-  return node;
-}
-template <typename K, typename V>
-void tree<K, V>::erase_(K key) {
-  root = erase_(root, key);
   if (!root) {
     root = &end_;
+    end_.parent = root;
     end_.left = root;
     end_.right = root;
+  }
+  set_end_key_(size_);
+  node->parent = nullptr;
+  node->left = nullptr;
+  node->right = nullptr;
+  return node;
+}
+
+// Node holding key, nullptr if there is none.
+template <typename K, typename V, typename Compare, typename Allocator>
+template <typename Q>
+typename tree<K, V, Compare, Allocator>::Node*
+tree<K, V, Compare, Allocator>::find_node(const Q& key) {
+  if constexpr (!comparable_<Q>::value) {
+    return find_node(K(key));
   } else {
-    root->parent = &end_;
-    end_.left = max(root);
-    end_.right = min(root);
+    Node* node = lower_bound_(key);
+    if (node == &end_ || less_(key, node->key())) return nullptr;
+    return node;
   }
-  end_.parent = root;
-  end_.key = size_;
 }
 
-template <typename K, typename V>
-typename tree<K, V>::Node* tree<K, V>::find_node(K key) {
+// First node whose key is not less than key, or end_.
+template <typename K, typename V, typename Compare, typename Allocator>
+template <typename Q>
+typename tree<K, V, Compare, Allocator>::Node*
+tree<K, V, Compare, Allocator>::lower_bound_(const Q& key) {
+  if constexpr (!comparable_<Q>::value) {
+    return lower_bound_(K(key));
+  } else {
+    Node* res = &end_;
+    Node* node = root == &end_ ? nullptr : root;
+    while (node) {
+      if (less_(node->key(), key)) {
+        node = node->right;
+      } else {
+        res = node;
+        node = node->left;
+      }
+    }
+    return res;
+  }
+}
+
+// First node whose key is greater than key, or end_.
+template <typename K, typename V, typename Compare, typename Allocator>
+template <typename Q>
+typename tree<K, V, Compare, Allocator>::Node*
+tree<K, V, Compare, Allocator>::upper_bound_(const Q& key) {
+  if constexpr (!comparable_<Q>::value) {
+    return upper_bound_(K(key));
+  } else {
+    Node* res = &end_;
+    Node* node = root == &end_ ? nullptr : root;
+    while (node) {
+      if (less_(key, node->key())) {
+        res = node;
+        node = node->left;
+      } else {
+        node = node->right;
+      }
+    }
+    return res;
+  }
+}
+
+template <typename K, typename V, typename Compare, typename Allocator>
+template <typename It>
+It tree<K, V, Compare, Allocator>::make_iter_(Node* node) {
+  It a;
+  a.end = &end_;
+  a.current = node;
+  return a;
+}
+
+// Node holding the k-th smallest element and the position of that element
+// among the node duplicates, or end_ when k is out of range.
+template <typename K, typename V, typename Compare, typename Allocator>
+std::pair<typename tree<K, V, Compare, Allocator>::Node*, size_t>
+tree<K, V, Compare, Allocator>::nth_(size_t k) {
+  if (k >= size_) return std::make_pair(&end_, 0);
   Node* node = root;
-  while (node != nullptr && node->key != key && node != &end_) {
-    if (node->key > key)
+  while (true) {
+    size_t left = GetCount(node->left);
+    if (k < left) {
       node = node->left;
-    else
+    } else if (k - left <= node->duplicates) {
+      return std::make_pair(node, k - left);
+    } else {
+      k -= left + 1 + node->duplicates;
       node = node->right;
+    }
   }
-  return node;
 }
 
-template <typename K, typename V>
-void tree<K, V>::clear() {
-  del(root);
+// Number of elements less than key.
+template <typename K, typename V, typename Compare, typename Allocator>
+size_t tree<K, V, Compare, Allocator>::rank(const K& key) {
+  size_t res = 0;
+  Node* node = root == &end_ ? nullptr : root;
+  while (node) {
+    if (less_(node->key(), key)) {
+      res += GetCount(node->left) + 1 + node->duplicates;
+      node = node->right;
+    } else {
+      node = node->left;
+    }
+  }
+  return res;
+}
+
+// Number of elements in [lo, hi).
+template <typename K, typename V, typename Compare, typename Allocator>
+size_t tree<K, V, Compare, Allocator>::count_range(const K& lo, const K& hi) {
+  if (!less_(lo, hi)) return 0;
+  return rank(hi) - rank(lo);
+}
+
+// Any number of copies costs one pass up the path, the shape is kept.
+template <typename K, typename V, typename Compare, typename Allocator>
+void tree<K, V, Compare, Allocator>::add_duplicate_(Node* node, size_t n) {
+  node->duplicates += n;
+  size_ += n;
+  set_end_key_(size_);
+  for (; node != &end_; node = node->parent) node->count += n;
+}
+
+// n must not exceed node->duplicates.
+template <typename K, typename V, typename Compare, typename Allocator>
+void tree<K, V, Compare, Allocator>::remove_duplicate_(Node* node, size_t n) {
+  node->duplicates -= n;
+  size_ -= n;
+  set_end_key_(size_);
+  for (; node != &end_; node = node->parent) node->count -= n;
+}
+
+// With node handles out the blocks stay, the nodes go to the free list.
+template <typename K, typename V, typename Compare, typename Allocator>
+void tree<K, V, Compare, Allocator>::clear() {
+  if (handles_) {
+    delete_subtree_(detach_());
+    return;
+  }
+  if (!std::is_trivially_destructible<Node>::value) del(root);
+  pool_.release();
   root = &end_;
   end_.right = root;
   end_.left = root;
   size_ = 0;
-  end_.key = size_;
+  set_end_key_(size_);
 }
 
-template <typename K, typename V>
-void tree<K, V>::del(Node* node) {
-  if (!node || node == &end_) return;
-  del(node->right);
-  del(node->left);
-  delete node;
+// Runs the destructors only, the memory goes back with the pool blocks.
+// Each left child is rotated up until the node has none, so the subtree
+// is consumed as a right chain without a stack.
+template <typename K, typename V, typename Compare, typename Allocator>
+void tree<K, V, Compare, Allocator>::del(Node* node) {
+  if (node == &end_) return;
+  while (node) {
+    if (Node* left = node->left) {
+      node->left = left->right;
+      left->right = node;
+      node = left;
+    } else {
+      Node* next = node->right;
+      pool_.destroy(node);
+      node = next;
+    }
+  }
 }
 
-template <typename K, typename V>
-bool tree<K, V>::contains(const K& key) {
-  typename tree<K, V>::Node* node = this->find_node(key);
-  if (node == &end_) node = nullptr;
-  return node ? 1 : 0;
+template <typename K, typename V, typename Compare, typename Allocator>
+template <typename Q>
+bool tree<K, V, Compare, Allocator>::contains(const Q& key) {
+  return find_node(key) != nullptr;
 }
 
-template <typename K, typename V>
-bool tree<K, V>::empty() {
+template <typename K, typename V, typename Compare, typename Allocator>
+bool tree<K, V, Compare, Allocator>::empty() {
   return !size_;
 }
-template <typename K, typename V>
-size_t tree<K, V>::size() {
+template <typename K, typename V, typename Compare, typename Allocator>
+size_t tree<K, V, Compare, Allocator>::size() {
   return size_;
 }
 
-template <typename K, typename V>
-void tree<K, V>::swap(tree& other) {
+template <typename K, typename V, typename Compare, typename Allocator>
+void tree<K, V, Compare, Allocator>::swap(tree& other) {
   std::swap(this->root, other.root);
-  std::swap(this->end_, other.end_);
+  std::swap(this->end_.left, other.end_.left);
+  std::swap(this->end_.right, other.end_.right);
   std::swap(this->size_, other.size_);
-  this->root->parent = &(this->end_);
-  other.root->parent = &(other.end_);
-}
-
-template <typename K, typename V>
-typename tree<K, V>::Node* tree<K, V>::iter::Forw(Node* node) {
-  if (node == end)
-    node = end->right;
-  else {
-    if (node->right) {
-      node = tree<K, V>::min(node->right);
+  this->pool_.swap(other.pool_);
+  std::swap(this->compare_(), other.compare_());
+  // An empty tree links to its own sentinel, which stays in place.
+  for (tree* t : {this, &other}) {
+    if (t->root == &(this->end_) || t->root == &(other.end_)) {
+      t->attach_(nullptr);
     } else {
-      K temp = current->key;
-      while (temp > node->parent->key && node->parent != end)
-        node = node->parent;
-      node = node->parent;
+      t->root->parent = &(t->end_);
+      t->end_.parent = t->root;
+      t->set_end_key_(t->size_);
     }
   }
-  return node;
 }
-template <typename K, typename V>
-typename tree<K, V>::Node* tree<K, V>::iter::Back(Node* node) {
-  if (node == end)
-    node = end->left;
-  else {
-    if (node->left) {
-      node = tree<K, V>::max(node->left);
-    } else {
-      K temp = node->key;
-      while (temp < node->parent->key && node->parent != end)
-        node = node->parent;
-      node = node->parent;
-    }
-  }
-  return node;
+
+// Successor and predecessor only follow links: going up, the step ends at
+// the first parent reached from its left (right) child. No keys are
+// compared, stepping is O(1) amortized over a full scan.
+template <typename K, typename V, typename Compare, typename Allocator>
+typename tree<K, V, Compare, Allocator>::Node*
+tree<K, V, Compare, Allocator>::iter::Forw(Node* node) {
+  if (node == end) return end->right;
+  if (node->right) return tree<K, V, Compare, Allocator>::min(node->right);
+  while (node->parent != end && node == node->parent->right)
+    node = node->parent;
+  return node->parent;
+}
+template <typename K, typename V, typename Compare, typename Allocator>
+typename tree<K, V, Compare, Allocator>::Node*
+tree<K, V, Compare, Allocator>::iter::Back(Node* node) {
+  if (node == end) return end->left;
+  if (node->left) return tree<K, V, Compare, Allocator>::max(node->left);
+  while (node->parent != end && node == node->parent->left)
+    node = node->parent;
+  return node->parent;
 }
 
-template <typename K, typename V>
-typename tree<K, V>::iter& tree<K, V>::iter::operator++() {
-  current = next;
-  next = Forw(next);
-  cur_value = std::make_pair(current->key, current->value);
+template <typename K, typename V, typename Compare, typename Allocator>
+typename tree<K, V, Compare, Allocator>::iter&
+tree<K, V, Compare, Allocator>::iter::operator++() {
+  current = Forw(current);
   return *this;
 }
 
-template <typename K, typename V>
-typename tree<K, V>::iter& tree<K, V>::iter::operator--() {
-  next = current;
+template <typename K, typename V, typename Compare, typename Allocator>
+typename tree<K, V, Compare, Allocator>::iter&
+tree<K, V, Compare, Allocator>::iter::operator--() {
   current = Back(current);
-  cur_value = std::make_pair(current->key, current->value);
   return *this;
 }
 
-template <typename K, typename V>
-bool tree<K, V>::iter::operator==(const iter& it) const {
+template <typename K, typename V, typename Compare, typename Allocator>
+bool tree<K, V, Compare, Allocator>::iter::operator==(const iter& it) const {
   return current == it.current;
 }
-template <typename K, typename V>
-bool tree<K, V>::iter::operator!=(const iter& it) const {
+template <typename K, typename V, typename Compare, typename Allocator>
+bool tree<K, V, Compare, Allocator>::iter::operator!=(const iter& it) const {
   return this->current != it.current;
 }
 
-template <typename K, typename V>
-typename tree<K, V>::iter tree<K, V>::begin() {
+template <typename K, typename V, typename Compare, typename Allocator>
+typename tree<K, V, Compare, Allocator>::iter
+tree<K, V, Compare, Allocator>::begin() {
   iter a;
   a.end = &(this->end_);
   a.current = this->end_.right;
-  a.next = a.Forw(a.current);
-  a.cur_value = std::make_pair(a.current->key, a.current->value);
   return a;
 }
 
-template <typename K, typename V>
-typename tree<K, V>::iter tree<K, V>::end() {
+template <typename K, typename V, typename Compare, typename Allocator>
+typename tree<K, V, Compare, Allocator>::iter
+tree<K, V, Compare, Allocator>::end() {
   iter a;
   a.end = &(this->end_);
   a.current = &(this->end_);
-  a.next = a.Forw(a.current);
-  a.cur_value = std::make_pair(a.current->key, a.current->value);
   return a;
 }
 
-template <typename K, typename V>
-void tree<K, V>::erase(iter pos) {
+template <typename K, typename V, typename Compare, typename Allocator>
+void tree<K, V, Compare, Allocator>::erase(iter pos) {
   if (pos.current == pos.end) throw std::out_of_range("Out of range");
-  this->erase_(pos.cur_value.first);
-  // pos.current = pos.Back(pos.next);
-}
-
-template <typename K, typename V>
-void tree<K, V>::merge(tree& other) {
-  for (tree<K, V>::iter i = other.begin(); i.current != i.end; ++i) {
-    std::pair<Node*, bool> b = insert_(i.cur_value.first, i.cur_value.second);
-    if (b.second) other.erase_(b.first->key);
-    // i.current = i.Forw(i.next);
-  }
-}
-
-template <typename K, typename V>
-typename tree<K, V>::Node* tree<K, V>::copy(Node* node, Node* parent) {
-  if (node == nullptr) return nullptr;
-  Node* new_node = new Node;
-  new_node->key = node->key;
-  new_node->value = node->value;
-  new_node->duplicates = node->duplicates;
-  new_node->height = new_node->height;
-  new_node->parent = parent;
-  new_node->left = copy(node->left, new_node);
-  new_node->right = copy(node->right, new_node);
-  return new_node;
-}
-template <typename K, typename V>
-void tree<K, V>::copy(const tree<K, V>& t) {
-  root = copy(t.root, &end_);
-  size_ = t.size_;
-  end_.key = size_;
-  end_.left = max(root);
-  end_.right = min(root);
+  erase_node_(pos.current);
+}
+
+template <typename K, typename V, typename Compare, typename Allocator>
+void tree<K, V, Compare, Allocator>::merge(tree& other) {
+  merge_(other, false);
+}
+
+// Turns the tree into an ascending chain linked through right and leaves
+// the tree empty. Walks backwards, so only the right links of nodes
+// already visited are overwritten.
+template <typename K, typename V, typename Compare, typename Allocator>
+typename tree<K, V, Compare, Allocator>::Node*
+tree<K, V, Compare, Allocator>::flatten_() {
+  Node* head = nullptr;
+  if (root != &end_) {
+    Node* node = end_.left;
+    while (node != &end_) {
+      Node* prev;
+      if (node->left) {
+        prev = max(node->left);
+      } else {
+        prev = node->parent;
+        for (Node* child = node; prev != &end_ && prev->left == child;
+             child = prev, prev = prev->parent) {
+        }
+      }
+      node->right = head;
+      head = node;
+      node = prev;
+    }
+  }
+  root = &end_;
+  end_.parent = root;
+  end_.left = root;
+  end_.right = root;
+  size_ = 0;
+  set_end_key_(0);
+  return head;
+}
+
+// Reallocates node in the pool of to, moving its key and value.
+template <typename K, typename V, typename Compare, typename Allocator>
+typename tree<K, V, Compare, Allocator>::Node*
+tree<K, V, Compare, Allocator>::move_node_(tree& from, tree& to, Node* node) {
+  Node* res = to.new_node(std::move(node->key()), std::move(node->value()));
+  res->duplicates = node->duplicates;
+  res->right = node->right;
+  from.delete_node(node);
+  return res;
+}
+
+// Moves the elements of other into this tree. A small other is inserted
+// element by element, each key and value moved into a node of this pool,
+// see splice_. Otherwise both trees are flattened, merged and rebuilt in
+// O(n + m); with equal allocators and no node handles out of other its
+// pool is taken over then, so moved nodes are relinked, not reallocated,
+// and iterators to them stay valid. Keys this tree already has stay in
+// other unless multi.
+template <typename K, typename V, typename Compare, typename Allocator>
+void tree<K, V, Compare, Allocator>::merge_(tree& other, bool multi) {
+  if (&other == this || other.root == &other.end_) return;
+  if (other.size_ * (GetHeight(root) + 2) < size_) {
+    Node* node = other.end_.right;
+    while (node != &other.end_) {
+      Node* next = node->right ? min(node->right) : nullptr;
+      if (!next) {
+        next = node->parent;
+        for (Node* child = node; next != &other.end_ && next->right == child;
+             child = next, next = next->parent) {
+        }
+      }
+      splice_(other, node, multi);
+      node = next;
+    }
+    return;
+  }
+  bool same = !other.handles_ &&
+              pool_.get_allocator() == other.pool_.get_allocator();
+  if (same) pool_.absorb(other.pool_);
+  size_t size = size_ + other.size_;
+  Node* a = flatten_();
+  Node* b = other.flatten_();
+  Node* head = nullptr;
+  Node** tail = &head;
+  size_t count = 0;
+  Node* rest = nullptr;
+  Node** rest_tail = &rest;
+  size_t rest_count = 0, rest_size = 0;
+  while (a || b) {
+    Node* node;
+    if (b && (!a || less_(b->key(), a->key()))) {
+      node = same ? b : move_node_(other, *this, b);
+      b = node->right;
+    } else if (!b || less_(a->key(), b->key())) {
+      node = a;
+      a = a->right;
+    } else if (multi) {
+      Node* next = b->right;
+      a->duplicates = a->duplicates + b->duplicates + 1;
+      (same ? *this : other).delete_node(b);
+      b = next;
+      continue;
+    } else {
+      node = same ? move_node_(*this, other, b) : b;
+      b = node->right;
+      *rest_tail = node;
+      rest_tail = &node->right;
+      rest_count++;
+      rest_size += 1 + node->duplicates;
+      continue;
+    }
+    *tail = node;
+    tail = &node->right;
+    count++;
+  }
+  *tail = nullptr;
+  *rest_tail = nullptr;
+  assign_chain_(head, count, size - rest_size);
+  other.assign_chain_(rest, rest_count, rest_size);
+}
+
+// Copies one node without its children.
+template <typename K, typename V, typename Compare, typename Allocator>
+typename tree<K, V, Compare, Allocator>::Node*
+tree<K, V, Compare, Allocator>::clone_(const Node* node, Node* parent) {
+  Node* res = new_node(node->key(), node->value());
+  res->duplicates = node->duplicates;
+  res->count = node->count;
+  res->height = node->height;
+  res->parent = parent;
+  return res;
+}
+
+// Copies t, which has nodes nodes, into this empty tree in preorder and
+// keeps heights and counts as they are. Left spines are copied in a loop
+// and their right children wait on a stack no deeper than the tree, so
+// every node of t is read once and all copies come from one pool block.
+template <typename K, typename V, typename Compare, typename Allocator>
+void tree<K, V, Compare, Allocator>::copy(
+    const tree<K, V, Compare, Allocator>& t, size_t nodes) {
+  Node* res = nullptr;
+  if (t.root != &t.end_) {
+    pool_.reserve(nodes);
+    std::vector<std::pair<const Node*, Node*>> pending;
+    pending.reserve(t.root->height + 1);
+    const Node* from = t.root;
+    Node* parent = nullptr;
+    Node** link = &res;
+    try {
+      while (true) {
+        for (; from; from = from->left) {
+          *link = clone_(from, parent);
+          if (from->right) pending.emplace_back(from->right, *link);
+          parent = *link;
+          link = &parent->left;
+        }
+        if (pending.empty()) break;
+        std::tie(from, parent) = pending.back();
+        pending.pop_back();
+        link = &parent->right;
+      }
+    } catch (...) {
+      delete_subtree_(res);
+      throw;
+    }
+  }
+  attach_(res);
+}
+
+// Only trees with duplicates have fewer nodes than elements.
+template <typename K, typename V, typename Compare, typename Allocator>
+size_t tree<K, V, Compare, Allocator>::nodes_() const {
+  size_t res = 0;
+  const Node* node = root == &end_ ? nullptr : root;
+  while (node && node->left) node = node->left;
+  while (node) {
+    ++res;
+    if (node->right) {
+      node = node->right;
+      while (node->left) node = node->left;
+    } else {
+      const Node* child = node;
+      node = node->parent;
+      while (node != &end_ && node->right == child) {
+        child = node;
+        node = node->parent;
+      }
+      if (node == &end_) node = nullptr;
+    }
+  }
+  return res;
+}
+
+// Takes the nodes out of the tree, the root of the returned subtree has
+// no parent. The tree is left empty.
+template <typename K, typename V, typename Compare, typename Allocator>
+typename tree<K, V, Compare, Allocator>::Node*
+tree<K, V, Compare, Allocator>::detach_() {
+  Node* res = root == &end_ ? nullptr : root;
+  if (res) res->parent = nullptr;
+  attach_(nullptr);
+  return res;
+}
+
+// Makes the detached subtree node the whole tree.
+template <typename K, typename V, typename Compare, typename Allocator>
+void tree<K, V, Compare, Allocator>::attach_(Node* node) {
+  root = node ? node : &end_;
+  root->parent = &end_;
   end_.parent = root;
+  end_.right = node ? min(node) : root;
+  end_.left = node ? max(node) : root;
+  size_ = GetCount(node);
+  set_end_key_(size_);
+}
+
+template <typename K, typename V, typename Compare, typename Allocator>
+typename tree<K, V, Compare, Allocator>::Node*
+tree<K, V, Compare, Allocator>::link_(Node* node, Node* left, Node* right) {
+  node->left = left;
+  node->right = right;
+  node->parent = nullptr;
+  if (left) left->parent = node;
+  if (right) right->parent = node;
+  Update(node);
+  return node;
+}
+
+// Joins detached subtrees left < node < right into one AVL tree in
+// O(|height(left) - height(right)|).
+template <typename K, typename V, typename Compare, typename Allocator>
+typename tree<K, V, Compare, Allocator>::Node*
+tree<K, V, Compare, Allocator>::join_(Node* left, Node* node, Node* right) {
+  if (GetHeight(left) > GetHeight(right) + 1)
+    return join_right_(left, node, right);
+  if (GetHeight(right) > GetHeight(left) + 1)
+    return join_left_(left, node, right);
+  return link_(node, left, right);
+}
+
+// Goes down the right spine of the taller left tree until the heights
+// match, then rebalances on the way back.
+template <typename K, typename V, typename Compare, typename Allocator>
+typename tree<K, V, Compare, Allocator>::Node*
+tree<K, V, Compare, Allocator>::join_right_(Node* left, Node* node,
+                                            Node* right) {
+  Node* child = left->right;
+  if (GetHeight(child) <= GetHeight(right) + 1) {
+    child = link_(node, child, right);
+  } else {
+    child = join_right_(child, node, right);
+  }
+  left->right = child;
+  child->parent = left;
+  Update(left);
+  return Balance(left);
+}
+
+template <typename K, typename V, typename Compare, typename Allocator>
+typename tree<K, V, Compare, Allocator>::Node*
+tree<K, V, Compare, Allocator>::join_left_(Node* left, Node* node,
+                                           Node* right) {
+  Node* child = right->left;
+  if (GetHeight(child) <= GetHeight(left) + 1) {
+    child = link_(node, left, child);
+  } else {
+    child = join_left_(left, node, child);
+  }
+  right->left = child;
+  child->parent = right;
+  Update(right);
+  return Balance(right);
+}
+
+// Joins left < right without a middle node.
+template <typename K, typename V, typename Compare, typename Allocator>
+typename tree<K, V, Compare, Allocator>::Node*
+tree<K, V, Compare, Allocator>::join2_(Node* left, Node* right) {
+  if (!left) return right;
+  Node* last;
+  left = split_last_(left, last);
+  return join_(left, last, right);
+}
+
+// Cuts the largest node off a detached subtree.
+template <typename K, typename V, typename Compare, typename Allocator>
+typename tree<K, V, Compare, Allocator>::Node*
+tree<K, V, Compare, Allocator>::split_last_(Node* node, Node*& last) {
+  Node* left = node->left;
+  Node* right = node->right;
+  if (left) left->parent = nullptr;
+  if (!right) {
+    last = node;
+    return left;
+  }
+  right->parent = nullptr;
+  return join_(left, node, split_last_(right, last));
+}
+
+// Splits a detached subtree into the keys less than key and the keys
+// greater than key. Returns the node with key itself, or nullptr.
+template <typename K, typename V, typename Compare, typename Allocator>
+typename tree<K, V, Compare, Allocator>::Node*
+tree<K, V, Compare, Allocator>::split_(Node* node, const K& key, Node*& left,
+                                       Node*& right) {
+  if (!node) {
+    left = right = nullptr;
+    return nullptr;
+  }
+  Node* l = node->left;
+  Node* r = node->right;
+  if (l) l->parent = nullptr;
+  if (r) r->parent = nullptr;
+  Node* match = node;
+  if (less_(key, node->key())) {
+    match = split_(l, key, left, right);
+    right = join_(right, node, r);
+  } else if (less_(node->key(), key)) {
+    match = split_(r, key, left, right);
+    left = join_(l, node, left);
+  } else {
+    left = l;
+    right = r;
+    link_(node, nullptr, nullptr);
+  }
+  return match;
+}
+
+// Runs f and g, in parallel when there is a pool. The forked task lives
+// in this frame, so it is joined before an exception from g leaves.
+template <typename K, typename V, typename Compare, typename Allocator>
+template <typename F, typename G>
+void tree<K, V, Compare, Allocator>::fork_join_(thread_pool* pool, F&& f,
+                                                G&& g) {
+  if (!pool) {
+    f();
+    g();
+    return;
+  }
+  thread_pool::task t(f);
+  pool->fork(t);
+  try {
+    g();
+  } catch (...) {
+    try {
+      pool->join(t);
+    } catch (...) {
+    }
+    throw;
+  }
+  pool->join(t);
+}
+
+// The pool to recurse with, none once the subtrees get small.
+template <typename K, typename V, typename Compare, typename Allocator>
+thread_pool* tree<K, V, Compare, Allocator>::grain_(thread_pool* pool,
+                                                    Node* node,
+                                                    const Node* other) {
+  size_t count = GetCount(node) + (other ? other->count : 0);
+  return count < kParallelGrain ? nullptr : pool;
+}
+
+// Calls op with a pool of threads workers (all cores for 0), or with
+// nullptr for a single thread. The workers are done before it returns or
+// throws.
+template <typename K, typename V, typename Compare, typename Allocator>
+template <typename Op>
+typename tree<K, V, Compare, Allocator>::Node*
+tree<K, V, Compare, Allocator>::with_pool_(size_t threads, Op op) {
+  if (!threads) threads = std::max(1u, std::thread::hardware_concurrency());
+  if (threads == 1) return op(nullptr);
+  thread_pool pool(threads);
+  std::mutex lock;
+  pool_lock_ = &lock;
+  Node* res;
+  try {
+    res = op(&pool);
+  } catch (...) {
+    pool_lock_ = nullptr;
+    throw;
+  }
+  pool_lock_ = nullptr;
+  return res;
+}
+
+// The join based algorithms below split this tree by the root key of
+// other and recurse into both halves. They take O(m log(n / m + 1)) for
+// trees of sizes m <= n, and other is left untouched. The halves are
+// independent, so with a pool they run as fork-join tasks.
+template <typename K, typename V, typename Compare, typename Allocator>
+typename tree<K, V, Compare, Allocator>::Node*
+tree<K, V, Compare, Allocator>::union_(Node* node, const Node* other,
+                                       thread_pool* pool) {
+  if (!other) return node;
+  pool = grain_(pool, node, other);
+  Node *left, *right;
+  Node* match = split_(node, other->key(), left, right);
+  if (!match) match = new_node(other->key(), other->value());
+  fork_join_(
+      pool, [&] { left = union_(left, other->left, pool); },
+      [&] { right = union_(right, other->right, pool); });
+  return join_(left, match, right);
+}
+
+template <typename K, typename V, typename Compare, typename Allocator>
+typename tree<K, V, Compare, Allocator>::Node*
+tree<K, V, Compare, Allocator>::intersection_(Node* node, const Node* other,
+                                              thread_pool* pool) {
+  if (!node) return nullptr;
+  if (!other) {
+    delete_subtree_(node);
+    return nullptr;
+  }
+  if (!node->left && !node->right) {
+    while (other) {
+      if (less_(node->key(), other->key()))
+        other = other->left;
+      else if (less_(other->key(), node->key()))
+        other = other->right;
+      else
+        return node;
+    }
+    delete_node(node);
+    return nullptr;
+  }
+  pool = grain_(pool, node, other);
+  Node *left, *right;
+  Node* match = split_(node, other->key(), left, right);
+  fork_join_(
+      pool, [&] { left = intersection_(left, other->left, pool); },
+      [&] { right = intersection_(right, other->right, pool); });
+  return match ? join_(left, match, right) : join2_(left, right);
+}
+
+template <typename K, typename V, typename Compare, typename Allocator>
+typename tree<K, V, Compare, Allocator>::Node*
+tree<K, V, Compare, Allocator>::difference_(Node* node, const Node* other,
+                                            thread_pool* pool) {
+  if (!node || !other) return node;
+  pool = grain_(pool, node, other);
+  Node *left, *right;
+  Node* match = split_(node, other->key(), left, right);
+  if (match) delete_node(match);
+  fork_join_(
+      pool, [&] { left = difference_(left, other->left, pool); },
+      [&] { right = difference_(right, other->right, pool); });
+  return join2_(left, right);
+}
+
+template <typename K, typename V, typename Compare, typename Allocator>
+void tree<K, V, Compare, Allocator>::delete_subtree_(Node* node) {
+  while (node) {
+    if (Node* left = node->left) {
+      node->left = left->right;
+      left->right = node;
+      node = left;
+    } else {
+      Node* next = node->right;
+      delete_node(node);
+      node = next;
+    }
+  }
+}
+
+// Adds the keys of other that are missing here, values of keys present in
+// both trees are kept. The set operations use up to threads threads, all
+// cores for 0.
+template <typename K, typename V, typename Compare, typename Allocator>
+void tree<K, V, Compare, Allocator>::set_union(const tree& other,
+                                               size_t threads) {
+  if (&other == this || other.root == &other.end_) return;
+  Node* node = detach_();
+  attach_(with_pool_(threads, [&](thread_pool* pool) {
+    return union_(node, other.root, pool);
+  }));
+}
+
+// Keeps only the keys that other has as well.
+template <typename K, typename V, typename Compare, typename Allocator>
+void tree<K, V, Compare, Allocator>::set_intersection(const tree& other,
+                                                      size_t threads) {
+  if (&other == this) return;
+  const Node* with = other.root == &other.end_ ? nullptr : other.root;
+  Node* node = detach_();
+  attach_(with_pool_(threads, [&](thread_pool* pool) {
+    return intersection_(node, with, pool);
+  }));
+}
+
+// Removes the keys that other has.
+template <typename K, typename V, typename Compare, typename Allocator>
+void tree<K, V, Compare, Allocator>::set_difference(const tree& other,
+                                                    size_t threads) {
+  if (&other == this) {
+    clear();
+    return;
+  }
+  if (other.root == &other.end_) return;
+  Node* node = detach_();
+  attach_(with_pool_(threads, [&](thread_pool* pool) {
+    return difference_(node, other.root, pool);
+  }));
+}
+
+// Moves the nodes of a detached subtree into the pool of to, keeping the
+// shape.
+template <typename K, typename V, typename Compare, typename Allocator>
+typename tree<K, V, Compare, Allocator>::Node*
+tree<K, V, Compare, Allocator>::relocate_(tree& from, tree& to, Node* node,
+                                          Node* parent) {
+  if (!node) return nullptr;
+  Node* res = to.new_node(std::move(node->key()), std::move(node->value()));
+  res->duplicates = node->duplicates;
+  res->height = node->height;
+  res->count = node->count;
+  res->parent = parent;
+  res->left = relocate_(from, to, node->left, res);
+  res->right = relocate_(from, to, node->right, res);
+  from.delete_node(node);
+  return res;
+}
+
+// Leaves the keys less than key here and moves the others into right,
+// replacing its contents. The split itself takes O(log n); nodes live in
+// the pool of their tree, so the smaller part is reallocated. Pools that
+// node handles point into stay with their tree.
+template <typename K, typename V, typename Compare, typename Allocator>
+void tree<K, V, Compare, Allocator>::split(const K& key, tree& right) {
+  if (&right == this) return;
+  right.clear();
+  Node *l, *r;
+  Node* match = split_(detach_(), key, l, r);
+  if (match) r = join_(nullptr, match, r);
+  bool same = !handles_ && !right.handles_ &&
+              pool_.get_allocator() == right.pool_.get_allocator();
+  if (same && GetCount(r) > GetCount(l)) {
+    pool_.swap(right.pool_);
+    l = relocate_(right, *this, l, nullptr);
+  } else {
+    r = relocate_(*this, right, r, nullptr);
+  }
+  attach_(l);
+  right.attach_(r);
 }
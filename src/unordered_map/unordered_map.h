@@ -0,0 +1,53 @@
+#ifndef UNORDERED_MAP_H
+#define UNORDERED_MAP_H
+#include <initializer_list>
+#include <stdexcept>
+#include <tuple>
+#include <vector>
+
+#include "../hash_table/hash_table.h"
+namespace s21 {
+// Hash map with the s21::map interface, see hash_table.h.
+template <typename K, typename V, typename Hash = std::hash<K>,
+          typename KeyEqual = std::equal_to<K>,
+          typename Allocator = std::allocator<std::pair<const K, V>>>
+class unordered_map
+    : public hash_table<K, std::pair<const K, V>, Hash, KeyEqual, Allocator> {
+  using base =
+      hash_table<K, std::pair<const K, V>, Hash, KeyEqual, Allocator>;
+
+ public:
+  using typename base::const_iterator;
+  using typename base::iterator;
+  using key_type = K;
+  using mapped_type = V;
+  using value_type = std::pair<const K, V>;
+  using reference = value_type &;
+  using const_reference = const value_type &;
+  using size_type = size_t;
+  using allocator_type = Allocator;
+
+  unordered_map() = default;
+  explicit unordered_map(const Allocator &alloc) : base(alloc){};
+  unordered_map(std::initializer_list<value_type> const &items,
+                const Allocator &alloc = Allocator());
+  template <typename InputIt>
+  unordered_map(InputIt first, InputIt last,
+                const Allocator &alloc = Allocator());
+  unordered_map(const unordered_map &m) = default;
+  unordered_map(unordered_map &&m) = default;
+  unordered_map &operator=(const unordered_map &m) = default;
+  unordered_map &operator=(unordered_map &&m) = default;
+
+  V &at(const K &key);
+  V &operator[](const K &key);
+
+  std::pair<iterator, bool> insert(const value_type &value);
+  std::pair<iterator, bool> insert(const K &key, const V &obj);
+  std::pair<iterator, bool> insert_or_assign(const K &key, const V &obj);
+  template <typename... Args>
+  std::vector<std::pair<iterator, bool>> insert_many(Args &&...args);
+};
+}  // namespace s21
+#include "unordered_map.tpp"
+#endif  // UNORDERED_MAP_H
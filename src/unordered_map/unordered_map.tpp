@@ -0,0 +1,81 @@
+#include "unordered_map.h"
+namespace s21 {
+
+template <typename K, typename V, typename Hash, typename KeyEqual,
+          typename Allocator>
+unordered_map<K, V, Hash, KeyEqual, Allocator>::unordered_map(
+    const std::initializer_list<value_type> &items, const Allocator &alloc)
+    : unordered_map(items.begin(), items.end(), alloc) {}
+
+template <typename K, typename V, typename Hash, typename KeyEqual,
+          typename Allocator>
+template <typename InputIt>
+unordered_map<K, V, Hash, KeyEqual, Allocator>::unordered_map(
+    InputIt first, InputIt last, const Allocator &alloc)
+    : base(alloc) {
+  for (; first != last; ++first) insert(*first);
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual,
+          typename Allocator>
+V &unordered_map<K, V, Hash, KeyEqual, Allocator>::at(const K &key) {
+  size_t i = this->find_index_(key, this->hash_(key));
+  if (i == this->capacity_) throw std::out_of_range("Out of range");
+  return this->slots_[i].second;
+}
+
+// The value is only built when the key is missing.
+template <typename K, typename V, typename Hash, typename KeyEqual,
+          typename Allocator>
+V &unordered_map<K, V, Hash, KeyEqual, Allocator>::operator[](const K &key) {
+  size_t i = this->emplace_key_(key, std::piecewise_construct,
+                                std::forward_as_tuple(key),
+                                std::forward_as_tuple())
+                 .first;
+  return this->slots_[i].second;
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual,
+          typename Allocator>
+std::pair<typename unordered_map<K, V, Hash, KeyEqual, Allocator>::iterator,
+          bool>
+unordered_map<K, V, Hash, KeyEqual, Allocator>::insert(
+    const value_type &value) {
+  std::pair<size_t, bool> res = this->emplace_key_(value.first, value);
+  return std::make_pair(this->make_iter_(res.first), res.second);
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual,
+          typename Allocator>
+std::pair<typename unordered_map<K, V, Hash, KeyEqual, Allocator>::iterator,
+          bool>
+unordered_map<K, V, Hash, KeyEqual, Allocator>::insert(const K &key,
+                                                       const V &obj) {
+  std::pair<size_t, bool> res = this->emplace_key_(key, key, obj);
+  return std::make_pair(this->make_iter_(res.first), res.second);
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual,
+          typename Allocator>
+std::pair<typename unordered_map<K, V, Hash, KeyEqual, Allocator>::iterator,
+          bool>
+unordered_map<K, V, Hash, KeyEqual, Allocator>::insert_or_assign(
+    const K &key, const V &obj) {
+  std::pair<iterator, bool> res = insert(key, obj);
+  if (!res.second) res.first->second = obj;
+  return res;
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual,
+          typename Allocator>
+template <typename... Args>
+std::vector<
+    std::pair<typename unordered_map<K, V, Hash, KeyEqual, Allocator>::iterator,
+              bool>>
+unordered_map<K, V, Hash, KeyEqual, Allocator>::insert_many(Args &&...args) {
+  std::vector<std::pair<iterator, bool>> res;
+  for (const auto &arg : {args...}) res.push_back(insert(arg));
+  return res;
+}
+
+}  // namespace s21
@@ -0,0 +1,43 @@
+#ifndef UNORDERED_SET_H
+#define UNORDERED_SET_H
+#include <initializer_list>
+#include <vector>
+
+#include "../hash_table/hash_table.h"
+namespace s21 {
+// Hash set with the s21::set interface, see hash_table.h.
+template <typename K, typename Hash = std::hash<K>,
+          typename KeyEqual = std::equal_to<K>,
+          typename Allocator = std::allocator<K>>
+class unordered_set : public hash_table<K, K, Hash, KeyEqual, Allocator> {
+  using base = hash_table<K, K, Hash, KeyEqual, Allocator>;
+
+ public:
+  using typename base::const_iterator;
+  using typename base::iterator;
+  using key_type = K;
+  using value_type = K;
+  using reference = value_type &;
+  using const_reference = const value_type &;
+  using size_type = size_t;
+  using allocator_type = Allocator;
+
+  unordered_set() = default;
+  explicit unordered_set(const Allocator &alloc) : base(alloc){};
+  unordered_set(std::initializer_list<value_type> const &items,
+                const Allocator &alloc = Allocator());
+  template <typename InputIt>
+  unordered_set(InputIt first, InputIt last,
+                const Allocator &alloc = Allocator());
+  unordered_set(const unordered_set &s) = default;
+  unordered_set(unordered_set &&s) = default;
+  unordered_set &operator=(const unordered_set &s) = default;
+  unordered_set &operator=(unordered_set &&s) = default;
+
+  std::pair<iterator, bool> insert(const value_type &value);
+  template <typename... Args>
+  std::vector<std::pair<iterator, bool>> insert_many(Args &&...args);
+};
+}  // namespace s21
+#include "unordered_set.tpp"
+#endif  // UNORDERED_SET_H
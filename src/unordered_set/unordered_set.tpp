@@ -0,0 +1,35 @@
+#include "unordered_set.h"
+namespace s21 {
+
+template <typename K, typename Hash, typename KeyEqual, typename Allocator>
+unordered_set<K, Hash, KeyEqual, Allocator>::unordered_set(
+    const std::initializer_list<value_type> &items, const Allocator &alloc)
+    : unordered_set(items.begin(), items.end(), alloc) {}
+
+template <typename K, typename Hash, typename KeyEqual, typename Allocator>
+template <typename InputIt>
+unordered_set<K, Hash, KeyEqual, Allocator>::unordered_set(
+    InputIt first, InputIt last, const Allocator &alloc)
+    : base(alloc) {
+  for (; first != last; ++first) insert(*first);
+}
+
+template <typename K, typename Hash, typename KeyEqual, typename Allocator>
+std::pair<typename unordered_set<K, Hash, KeyEqual, Allocator>::iterator, bool>
+unordered_set<K, Hash, KeyEqual, Allocator>::insert(const value_type &value) {
+  std::pair<size_t, bool> res = this->emplace_key_(value, value);
+  return std::make_pair(this->make_iter_(res.first), res.second);
+}
+
+template <typename K, typename Hash, typename KeyEqual, typename Allocator>
+template <typename... Args>
+std::vector<
+    std::pair<typename unordered_set<K, Hash, KeyEqual, Allocator>::iterator,
+              bool>>
+unordered_set<K, Hash, KeyEqual, Allocator>::insert_many(Args &&...args) {
+  std::vector<std::pair<iterator, bool>> res;
+  for (const auto &arg : {args...}) res.push_back(insert(arg));
+  return res;
+}
+
+}  // namespace s21
@@ -23,13 +23,15 @@ class vector {
   using iterator = T *;
   using const_iterator = const T *;
   using size_type = size_t;
+  vector &operator=(const vector &v);
   vector &operator=(vector &&v) noexcept;
 
   void reserve(size_type size);
+  void resize(size_type size);
   vector() : size_(0U), capacity_(0U), arr_(nullptr) {}
 
   explicit vector(size_type n)
-      : size_(n), capacity_(n), arr_(n ? new T[n] : nullptr) {}
+      : size_(n), capacity_(n), arr_(n ? new T[n]() : nullptr) {}
 
   vector(std::initializer_list<value_type> const &items);
 
@@ -43,6 +45,7 @@ class vector {
   vector(vector &&v) : size_(v.size_), capacity_(v.capacity_), arr_(v.arr_) {
     v.arr_ = nullptr;
     v.size_ = 0;
+    v.capacity_ = 0;
   }
   ~vector() {
     delete[] arr_;
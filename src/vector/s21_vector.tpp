@@ -15,6 +15,14 @@ void vector<T>::reserve(size_t size) {
   }
 }
 
+// Grown elements are value-initialized.
+template <typename T>
+void vector<T>::resize(size_t size) {
+  reserve(size);
+  for (size_t i = size_; i < size; ++i) arr_[i] = T();
+  size_ = size;
+}
+
 template <typename T>
 vector<T>::vector(std::initializer_list<value_type> const &items) {
   arr_ = new value_type[items.size()];
@@ -65,6 +73,15 @@ bool vector<T>::empty() {
   return flag;
 }
 
+template <typename T>
+vector<T> &vector<T>::operator=(const vector &v) {
+  if (this != &v) {
+    vector copy(v);
+    swap(copy);
+  }
+  return *this;
+}
+
 template <typename T>
 vector<T> &vector<T>::operator=(vector &&v) noexcept {
   if (this != &v) {
@@ -140,7 +157,7 @@ typename vector<T>::iterator vector<T>::insert(iterator pos,
                                                const_reference value) {
   size_type index = pos - arr_;
   if (size_ == capacity_) {
-    reserve(size_ * 2);
+    reserve(capacity_ ? size_ * 2 : 1);
   }
 
   pos = arr_ + index;
@@ -160,6 +177,7 @@ void vector<T>::clear() {
   delete[] arr_;
   arr_ = nullptr;
   size_ = 0;
+  capacity_ = 0;
 }
 
 template <typename T>